@@ -61,6 +61,7 @@ void Settings::applySettingsIni(D3DPRESENT_PARAMETERS* pPresentationParameters)
 	g_modVals.frame_history_width = Settings::settingsIni.FrameHistoryWidth;
 	g_modVals.frame_history_height = Settings::settingsIni.FrameHistoryHeight;
 	g_modVals.frame_history_spacing = Settings::settingsIni.FrameHistorySpacing;
+	g_modVals.frame_history_depth = Settings::settingsIni.FrameHistoryDepth;
 
 	if (Settings::settingsIni.delaySlider > 5) {
 		g_gameVals.onlineDelay = 5;
@@ -0,0 +1,147 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <vector>
+
+// FNV-1a, for telling things apart (cache keys, name lookups, content checks), not for anything adversarial.
+// Portable on purpose, the tools under tools/ build the files that use it on Linux
+constexpr uint32_t FNV1A32_OFFSET = 0x811c9dc5u;
+constexpr uint32_t FNV1A32_PRIME = 0x01000193u;
+constexpr uint64_t FNV1A64_OFFSET = 0xcbf29ce484222325ULL;
+constexpr uint64_t FNV1A64_PRIME = 0x100000001b3ULL;
+
+// pass the previous result as hash to continue over another buffer
+inline uint32_t fnv1a32(const void* data, size_t size, uint32_t hash = FNV1A32_OFFSET)
+{
+	const uint8_t* bytes = (const uint8_t*)data;
+	for (size_t i = 0; i < size; i++)
+	{
+		hash = (hash ^ bytes[i]) * FNV1A32_PRIME;
+	}
+	return hash;
+}
+
+// up to the terminator
+inline uint32_t fnv1a32(const char* str)
+{
+	uint32_t hash = FNV1A32_OFFSET;
+	for (; *str; str++)
+	{
+		hash = (hash ^ (uint8_t)*str) * FNV1A32_PRIME;
+	}
+	return hash;
+}
+
+inline uint64_t fnv1a64(const void* data, size_t size, uint64_t hash = FNV1A64_OFFSET)
+{
+	const uint8_t* bytes = (const uint8_t*)data;
+	for (size_t i = 0; i < size; i++)
+	{
+		hash = (hash ^ bytes[i]) * FNV1A64_PRIME;
+	}
+	return hash;
+}
+
+// one step with a whole value instead of its bytes
+inline uint64_t fnv1a64_mix(uint64_t hash, uint64_t value)
+{
+	return (hash ^ value) * FNV1A64_PRIME;
+}
+
+// 8 byte words then the tail byte by byte, several times faster than fnv1a64 on big buffers but not the same value
+inline uint64_t fnv1a64_words(const void* data, size_t size, uint64_t hash = FNV1A64_OFFSET)
+{
+	const uint8_t* bytes = (const uint8_t*)data;
+	size_t i = 0;
+	for (; i + 8 <= size; i += 8)
+	{
+		uint64_t word;
+		memcpy(&word, bytes + i, 8);
+		hash = (hash ^ word) * FNV1A64_PRIME;
+	}
+	for (; i < size; i++)
+	{
+		hash = (hash ^ bytes[i]) * FNV1A64_PRIME;
+	}
+	return hash;
+}
+
+/*
+	Hash index over entries the caller keeps in its own vector. Slots hold the hash and the entry's index, the table
+	is a power of two kept at most half full with linear probing, so a lookup is usually one or two probes. It never
+	sees the keys: Find hands every index whose hash matches to the caller's comparison.
+*/
+class HashSlots
+{
+public:
+	// match(index) returns true for the entry being looked for, -1 if none did
+	template <typename Match>
+	int Find(uint32_t hash, Match match) const
+	{
+		if (m_slots.empty())
+			return -1;
+
+		size_t mask = m_slots.size() - 1;
+		for (size_t slot = hash & mask; m_slots[slot].index != 0; slot = (slot + 1) & mask)
+		{
+			if (m_slots[slot].hash == hash && match(m_slots[slot].index - 1))
+				return (int)m_slots[slot].index - 1;
+		}
+		return -1;
+	}
+
+	// doesn't check for duplicates, Find first
+	void Insert(uint32_t hash, uint32_t index)
+	{
+		if ((m_count + 1) * 2 > m_slots.size())
+			Grow();
+
+		Place(hash, index + 1);
+		m_count++;
+	}
+
+	void Clear()
+	{
+		m_slots.clear();
+		m_count = 0;
+	}
+
+	size_t GetMemoryUsage() const
+	{
+		return m_slots.capacity() * sizeof(Slot);
+	}
+
+private:
+	struct Slot
+	{
+		uint32_t hash;
+		uint32_t index; // + 1, 0 is empty
+	};
+
+	std::vector<Slot> m_slots;
+	size_t m_count = 0;
+
+	void Place(uint32_t hash, uint32_t storedIndex)
+	{
+		size_t mask = m_slots.size() - 1;
+		size_t slot = hash & mask;
+		while (m_slots[slot].index != 0)
+			slot = (slot + 1) & mask;
+
+		m_slots[slot].hash = hash;
+		m_slots[slot].index = storedIndex;
+	}
+
+	void Grow()
+	{
+		std::vector<Slot> old;
+		old.swap(m_slots);
+		m_slots.assign(old.empty() ? 64 : old.size() * 2, Slot{ 0, 0 });
+		for (const Slot& slot : old)
+		{
+			if (slot.index != 0)
+				Place(slot.hash, slot.index);
+		}
+	}
+};
@@ -118,6 +118,7 @@ struct modValues_t {
 	float frame_history_width;
 	float frame_history_height;
 	float frame_history_spacing;
+	int frame_history_depth;
 };
 //temporary placeholders until wrappers are created / final addresses updated
 struct temps_t
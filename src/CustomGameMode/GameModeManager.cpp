@@ -66,24 +66,25 @@ int GameModeManager::GetGameModesCount() const
 
 void GameModeManager::ActivateGameModeHooks()
 {
-	for (const std::string& hookLabel : m_gameModes[m_activeGameMode].hook_labels)
-	{
-		HookManager::ActivateHook(hookLabel.c_str());
-	}
+	HookManager::ActivateHooks(m_gameModes[m_activeGameMode].hook_labels);
+	LOG(2, "%s hooks activated in %lldus\n", GetCurrentGameModeName().c_str(), HookManager::GetLastBatchUs());
 }
 
 void GameModeManager::ResetAllHooks()
 {
 	LOG(2, "ResetAllHooks\n");
 
-	for (const GameMode_t& gameMode : m_gameModes)
+	if (m_allHookLabels.empty())
 	{
-		for (const std::string& hookLabel : gameMode.hook_labels)
+		for (const GameMode_t& gameMode : m_gameModes)
 		{
-			HookManager::DeactivateHook(hookLabel.c_str());
+			m_allHookLabels.insert(m_allHookLabels.end(), gameMode.hook_labels.begin(), gameMode.hook_labels.end());
 		}
 	}
 
+	HookManager::DeactivateHooks(m_allHookLabels);
+	LOG(2, "All game mode hooks deactivated in %lldus\n", HookManager::GetLastBatchUs());
+
 	// Change heat limits of 15000 back to 10000
 	int result = HookManager::OverWriteBytes(
 		(char*)steroid_HeatModifyJmpBackAddr,
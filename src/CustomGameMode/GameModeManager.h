@@ -22,5 +22,6 @@ private:
 	void ResetAllHooks();
 
 	std::vector<GameMode_t> m_gameModes;
+	std::vector<std::string> m_allHookLabels; // every mode's hooks, deactivated together on reset
 	CustomGameMode m_activeGameMode;
 };
\ No newline at end of file
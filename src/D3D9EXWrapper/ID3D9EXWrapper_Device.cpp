@@ -3,6 +3,7 @@
 #include "Core/interfaces.h"
 #include "Core/logger.h"
 #include "Game/MatchState.h"
+#include "Hooks/HookManager.h"
 #include "Hooks/hooks_bbcf.h"
 #include "Hooks/hooks_customGameModes.h"
 #include "Hooks/hooks_palette.h"
@@ -10,6 +11,7 @@
 #include "Overlay/WindowManager.h"
 
 #include <steam_api.h>
+#include <chrono>
 
 #pragma comment(lib, "steam_api.lib")
 
@@ -24,9 +26,20 @@ Direct3DDevice9ExWrapper::Direct3DDevice9ExWrapper(IDirect3DDevice9Ex **ppReturn
 	g_interfaces.pD3D9ExWrapper = *ppReturnedDeviceInterface;
 
 	//place all other hooks that can only be placed after steamDRM unpacks the .exe in memory!!!
+	//a first dry run only collects the signatures so the exe gets scanned once for all of them
+	auto hooksStart = std::chrono::steady_clock::now();
+	HookManager::BeginPatternCollection();
 	placeHooks_bbcf();
 	placeHooks_palette();
 	placeHooks_CustomGameModes();
+	HookManager::ScanCollectedPatterns();
+
+	placeHooks_bbcf();
+	placeHooks_palette();
+	placeHooks_CustomGameModes();
+	LOG(1, "Hooks placed in %.2fms, signatures %s in %.2fms\n",
+		std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - hooksStart).count(),
+		HookManager::WasSignatureCacheUsed() ? "from cache" : "scanned", HookManager::GetLastScanMs());
   PatchManager::ApplyPatches();
   
 }
@@ -0,0 +1,116 @@
+#include "JonbDB.h"
+#include <cstring>
+
+//JONB layout: "JONB", uint16 number of sprite names, the names as char[32], then a header where the hurtbox and hitbox counts
+//sit at +7 and +9 past the names, and the boxes after 0xa3 more bytes of it
+constexpr size_t JONB_NAMES_OFFSET = 6;
+constexpr size_t JONB_SPRITE_NAME_SIZE = 32;
+constexpr size_t JONB_HURTBOX_COUNT_OFFSET = 7;
+constexpr size_t JONB_HITBOX_COUNT_OFFSET = 9;
+constexpr size_t JONB_BOXES_OFFSET = 10 + 0xa3;
+constexpr size_t JONB_BOX_SIZE = 20; // same layout as JonbEntry: uint32 type, x, y, width, height
+constexpr int JONB_MAX_SPRITE_NAMES = 11; // past this the entry is treated as having no boxes, like the old reader did
+
+bool JonbDB::add(const char* name, size_t name_len, const char* jonb, const char* end) {
+	if (jonb == NULL || (end != NULL && end - jonb < (ptrdiff_t)JONB_NAMES_OFFSET)) {
+		return false;
+	}
+	if (jonb[0] != 'J') {
+		return false;
+	}
+	uint16_t number_of_sprite_names;
+	memcpy(&number_of_sprite_names, jonb + 4, 2);
+
+	uint8_t hurtbox_count = 0;
+	uint8_t hitbox_count = 0;
+	const char* boxes = NULL;
+	if (number_of_sprite_names <= JONB_MAX_SPRITE_NAMES) {
+		const char* header = jonb + JONB_NAMES_OFFSET + number_of_sprite_names * JONB_SPRITE_NAME_SIZE;
+		if (end != NULL && end - header < (ptrdiff_t)JONB_HITBOX_COUNT_OFFSET + 1) {
+			return false;
+		}
+		hurtbox_count = (uint8_t)header[JONB_HURTBOX_COUNT_OFFSET];
+		hitbox_count = (uint8_t)header[JONB_HITBOX_COUNT_OFFSET];
+		boxes = header + JONB_BOXES_OFFSET;
+		if (end != NULL && end - boxes < (ptrdiff_t)((hurtbox_count + hitbox_count) * JONB_BOX_SIZE)) {
+			//counts are fine but the geometry got cut off, keep the counts so active frames still work
+			boxes = NULL;
+		}
+	}
+
+	uint32_t hash = fnv1a32(name, name_len);
+	if (find(name, name_len, hash) != NULL) {
+		return true;
+	}
+	JonbDBSprite sprite;
+	sprite.name_offset = (uint32_t)names.size();
+	sprite.first_box = (uint32_t)box_x.size();
+	sprite.hurtbox_count = hurtbox_count;
+	sprite.hitbox_count = hitbox_count;
+	names.insert(names.end(), name, name + name_len);
+	names.push_back(0);
+
+	int box_count = hurtbox_count + hitbox_count;
+	for (int i = 0; i < box_count; i++) {
+		float geometry[4] = {};
+		if (boxes != NULL) {
+			memcpy(geometry, boxes + i * JONB_BOX_SIZE + 4, sizeof(geometry));
+		}
+		box_type.push_back(i < hurtbox_count ? JonbDBBoxType_Hurtbox : JonbDBBoxType_Hitbox);
+		box_x.push_back(geometry[0]);
+		box_y.push_back(geometry[1]);
+		box_width.push_back(geometry[2]);
+		box_height.push_back(geometry[3]);
+	}
+
+	slots.Insert(hash, (uint32_t)sprites.size());
+	sprites.push_back(sprite);
+	return true;
+}
+
+const JonbDBSprite* JonbDB::find(const char* name) const {
+	if (name == NULL) {
+		return NULL;
+	}
+	size_t len = 0;
+	while (len < 32 && name[len] != 0) {
+		len++;
+	}
+	return find(name, len, fnv1a32(name, len));
+}
+
+const JonbDBSprite* JonbDB::find(const char* name, size_t len, uint32_t hash) const {
+	int index = slots.Find(hash, [&](uint32_t i) {
+		const char* stored = &names[sprites[i].name_offset];
+		return strncmp(stored, name, len) == 0 && stored[len] == 0;
+	});
+	return index >= 0 ? &sprites[index] : NULL;
+}
+
+const char* JonbDB::get_name(const JonbDBSprite& sprite) const {
+	return &names[sprite.name_offset];
+}
+
+void JonbDB::clear() {
+	sprites.clear();
+	names.clear();
+	slots.Clear();
+	box_type.clear();
+	box_x.clear();
+	box_y.clear();
+	box_width.clear();
+	box_height.clear();
+}
+
+size_t JonbDB::size() const {
+	return sprites.size();
+}
+
+size_t JonbDB::get_box_count() const {
+	return box_x.size();
+}
+
+size_t JonbDB::get_memory_usage() const {
+	return sprites.capacity() * sizeof(JonbDBSprite) + names.capacity() + slots.GetMemoryUsage()
+		+ box_type.capacity() + (box_x.capacity() + box_y.capacity() + box_width.capacity() + box_height.capacity()) * sizeof(float);
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include "Core/hash.h"
+#include <vector>
+#include <stdint.h>
+#include <stddef.h>
+
+enum JonbDBBoxType_
+{
+	JonbDBBoxType_Hurtbox,
+	JonbDBBoxType_Hitbox
+};
+
+// one jonbin, its boxes are hurtbox_count hurtboxes starting at first_box followed by hitbox_count hitboxes
+struct JonbDBSprite {
+	uint32_t name_offset; // into the name pool, NUL terminated
+	uint32_t first_box;
+	uint16_t hurtbox_count;
+	uint16_t hitbox_count;
+};
+
+/*
+	Every jonbin of a character, looked up by sprite name (the jonbin name without .jonbin, which is what the
+	script's sprite command holds). The index is a HashSlots over the sprites so a lookup is a hash and a probe or two,
+	no std::string gets built for it. Box geometry of all sprites lives in one set of arrays,
+	a sprite only knows where its run starts, so per frame box data can be read without copying or allocating.
+*/
+class JonbDB {
+public:
+	// box geometry, indexed by JonbDBSprite::first_box + i
+	std::vector<uint8_t> box_type; // JonbDBBoxType_
+	std::vector<float> box_x;
+	std::vector<float> box_y;
+	std::vector<float> box_width;
+	std::vector<float> box_height;
+
+	// parses one JONB entry, end NULL for game memory. Returns false if it isn't one (or doesn't fit), a name that's already in keeps its first entry
+	bool add(const char* name, size_t name_len, const char* jonb, const char* end);
+	const JonbDBSprite* find(const char* name) const; // name is read up to its terminator or 32 chars
+	const char* get_name(const JonbDBSprite& sprite) const;
+
+	void clear();
+	size_t size() const;
+	size_t get_box_count() const;
+	size_t get_memory_usage() const;
+
+private:
+	std::vector<JonbDBSprite> sprites;
+	std::vector<char> names;
+	HashSlots slots;
+
+	const JonbDBSprite* find(const char* name, size_t len, uint32_t hash) const;
+};
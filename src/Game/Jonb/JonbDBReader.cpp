@@ -1,86 +1,67 @@
-#pragma once
 #include "JonbDBReader.h"
 #include "Game/CharData.h"
+#include <cstring>
 constexpr auto FPAC_JONBIN_OFFSET_FROM_BBCF_P1 = 0x88E700; 
 constexpr auto FPAC_JONBIN_OFFSET_FROM_BBCF_P2 = 0x88E760;
 
 
-std::map<std::string, JonbDBEntry> JonbDBReader::parse_all_jonbins(char* bbcf_base_addr, int player_num) {
-	// you need to specify if it is jubei or not because for some reason his jonb index is spaced differently
+JonbDBIndexHeader* JonbDBReader::get_index_header(char* bbcf_base_addr, int player_num) {
+	auto fpac_offset = player_num == 1 ? FPAC_JONBIN_OFFSET_FROM_BBCF_P1 : FPAC_JONBIN_OFFSET_FROM_BBCF_P2;
+	return *((JonbDBIndexHeader**)(bbcf_base_addr + fpac_offset));
+}
 
-	
-	auto fpac_offset = 0;
-	std::map<std::string, JonbDBEntry> jonbin_map{};// = new std::map<std::string, JonbDBEntry>();
+JonbDB JonbDBReader::parse_all_jonbins(char* bbcf_base_addr, int player_num) {
+	// you need to specify if it is jubei or not because for some reason his jonb index is spaced differently
 	CharData* cdata = *(CharData**)(bbcf_base_addr + 0x892998);
 	if (player_num == 1) {
-		fpac_offset = FPAC_JONBIN_OFFSET_FROM_BBCF_P1;
 		cdata = *(CharData**)(bbcf_base_addr + 0x892998);
 	}
 	else {
-		fpac_offset = FPAC_JONBIN_OFFSET_FROM_BBCF_P2;
 		cdata = *(CharData**)(bbcf_base_addr + 0x89299C);
 	}
 	auto cind = cdata->charIndex;
 	bool is_jubei = cind == 35 ? true : false;
-	JonbDBIndexHeader* jonb_index_header = *((JonbDBIndexHeader**)(bbcf_base_addr + fpac_offset));
+	return parse_fpac((char*)get_index_header(bbcf_base_addr, player_num), NULL, is_jubei);
+}
+
+JonbDB JonbDBReader::parse_fpac(char* fpac, const char* end, bool is_jubei) {
+	JonbDB jonb_db;
+	if (fpac == NULL || (end != NULL && end - fpac < (int)sizeof(JonbDBIndexHeader))) {
+		return jonb_db;
+	}
+	JonbDBIndexHeader* jonb_index_header = (JonbDBIndexHeader*)fpac;
 	char* first_full_entry = (char*)jonb_index_header + jonb_index_header->offset_to_first_full_entry;
 	//the index header has size 32, move 32 to the first JonbDBIndexEntry
 	JonbDBIndexEntry* curr_index_addr = (JonbDBIndexEntry*)((char*)jonb_index_header + sizeof(JonbDBIndexHeader));
 	
-	auto iter = 0;
-	bool get_alternative_offset = false; /*currently there are some characters like arakune who 
-										 use the offset_from_first_full_entry2 instead of offset_from_first_full_entry1 for their offset, 
-										 idk why that happens but this is to check for it and adjust accordingly*/
-	while ((char*)curr_index_addr < first_full_entry) {
+	size_t index_entry_size = is_jubei ? sizeof(JonbDBIndexEntryJubei) : sizeof(JonbDBIndexEntry);
+	while ((char*)curr_index_addr < first_full_entry && (end == NULL || (char*)curr_index_addr + index_entry_size <= end)) {
 		//find the actual position from the index
-		std::string jonbin_name = is_jubei ?
+		const char* jonbin_name = is_jubei ?
 			((JonbDBIndexEntryJubei*)curr_index_addr)->jonbin_name ://for ex ae030_08ex00.jonbin; 
 			((JonbDBIndexEntry*)curr_index_addr)->jonbin_name; 
-		if (jonbin_name == "ny407_05.jonbin") {
-			auto test = 1;
-		}
-		if (jonbin_name == "") {
+		size_t name_len = strnlen(jonbin_name, is_jubei ? sizeof(JonbDBIndexEntryJubei::jonbin_name) : sizeof(JonbDBIndexEntry::jonbin_name));
+		if (name_len == 0) {
 			//just for the case o jubei, need to figure out later why his index entries are differently spaced, this spacing variation is the cause of the issue.
 			break;
 			
 		}
+		if (name_len > 7) {
+			name_len -= 7; //drops .jonbin, the sprite commands in the script use the bare name
+		}
 		uint32_t offset_from_first_full_entry1 = is_jubei ?
 			((JonbDBIndexEntryJubei*)curr_index_addr)->offset_from_first_full_entry1 :
 			((JonbDBIndexEntry*)curr_index_addr)->offset_from_first_full_entry1;
-
-
-		JonbDBEntry ini = JonbDBEntry((char*)(first_full_entry + offset_from_first_full_entry1));
-		JonbDBEntry* entry_pos = &ini;
-		if (entry_pos->JONB[0] != 'J') {// if the value in JONB[0] isn't the literal 'J', need to use the offset_from_first_full_entry2
-			get_alternative_offset = true;
-		}
-		if (get_alternative_offset) {
+		/*currently there are some characters like arakune who use the offset_from_first_full_entry2 instead of
+		offset_from_first_full_entry1 for their offset, idk why that happens but if there is no JONB at the first one try the second*/
+		if (!jonb_db.add(jonbin_name, name_len, first_full_entry + offset_from_first_full_entry1, end)) {
 			uint32_t offset_from_first_full_entry2 = is_jubei ?
 				((JonbDBIndexEntryJubei*)curr_index_addr)->offset_from_first_full_entry2 :
 				((JonbDBIndexEntry*)curr_index_addr)->offset_from_first_full_entry2;
-			JonbDBEntry ini2 = JonbDBEntry((char*)(first_full_entry + offset_from_first_full_entry2));
-			entry_pos = &ini2;
-			get_alternative_offset = false;
-			//entry_pos = (JonbDBEntry*)(first_full_entry + curr_index_addr->offset_from_first_full_entry2);
+			if (!jonb_db.add(jonbin_name, name_len, first_full_entry + offset_from_first_full_entry2, end) && end != NULL) {
+				break;
+			}
 		}
-		
-		//std::string jonbin_name = entry_pos->sprite_name; //for ex ar000_02.bmp
-		//std::string jonbin_name = curr_index_addr->jonbin_name;//for ex ae030_08ex00.jonbin; 
-		if (!jonbin_name.empty() && jonbin_name.size() > 4) {
-			jonbin_name.pop_back();//removes .jonbin to for the map keys
-			jonbin_name.pop_back();
-			jonbin_name.pop_back();
-			jonbin_name.pop_back();
-			jonbin_name.pop_back();
-			jonbin_name.pop_back();
-			jonbin_name.pop_back();
-		}
-		//verifies amount of sprites in jonb
-		//JonbDBEntry* entry_final = new JonbDBEntry();
-		//entry_final->JONB = entry_pos->JONB;
-
-		jonbin_map[jonbin_name] = *entry_pos;
-
 
 		//move to the next JonbDBIndexEntry, need to adjust if for Jubei entry ofc
 		if (is_jubei) {
@@ -91,5 +72,5 @@ std::map<std::string, JonbDBEntry> JonbDBReader::parse_all_jonbins(char* bbcf_ba
 		}
 		//curr_index_addr++;
 	}
-	return jonbin_map;
+	return jonb_db;
 }
\ No newline at end of file
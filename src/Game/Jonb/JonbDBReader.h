@@ -1,10 +1,11 @@
 #pragma once
-#include <map>
-#include <string>
 #include "JonbDBEntry.h"
+#include "JonbDB.h"
 class JonbDBReader
 {
 public:
-	std::map<std::string, JonbDBEntry>  parse_all_jonbins(char* bbcf_base_addr, int player_num);
+	JonbDB parse_all_jonbins(char* bbcf_base_addr, int player_num);
+	static JonbDBIndexHeader* get_index_header(char* bbcf_base_addr, int player_num); // the jonbin FPAC, its index runs up to offset_to_first_full_entry
+	static JonbDB parse_fpac(char* fpac, const char* end, bool is_jubei); // end NULL for game memory, files are bounds checked against it
 };
 
@@ -0,0 +1,135 @@
+#include "PlaybackFile.h"
+#include <cstring>
+#include <fstream>
+
+static const char PLAYBACK_MAGIC[4] = { 'B', 'B', 'P', 'B' };
+constexpr size_t PLAYBACK_HEADER_SIZE = 16;
+
+template <typename T>
+static void put(std::vector<char>& out, T value) {
+	const char* bytes = (const char*)&value;
+	out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+void encode_playback(const PlaybackFile& playback, std::vector<char>& out) {
+	out.clear();
+	out.reserve(PLAYBACK_HEADER_SIZE + playback.inputs.size());
+	out.insert(out.end(), PLAYBACK_MAGIC, PLAYBACK_MAGIC + 4);
+	put<uint16_t>(out, PLAYBACK_FILE_VERSION);
+	put<int16_t>(out, (int16_t)playback.char_index);
+	put<uint8_t>(out, (uint8_t)playback.facing_direction);
+	out.insert(out.end(), 3, 0);
+	put<uint32_t>(out, (uint32_t)playback.inputs.size());
+	//held inputs are most of any playback, runs keep the file small
+	size_t i = 0;
+	while (i < playback.inputs.size()) {
+		uint16_t input = playback.inputs[i];
+		size_t run = 1;
+		while (i + run < playback.inputs.size() && playback.inputs[i + run] == input && run < 0xFFFF) {
+			run++;
+		}
+		put<uint16_t>(out, (uint16_t)run);
+		put<uint16_t>(out, input);
+		i += run;
+	}
+}
+
+bool decode_playback(const char* data, size_t size, PlaybackFile& out, bool header_only) {
+	out = PlaybackFile();
+	if (data == NULL || size == 0) {
+		return false;
+	}
+	if (size < PLAYBACK_HEADER_SIZE || memcmp(data, PLAYBACK_MAGIC, 4) != 0) {
+		//version 1, facing byte then a byte per frame
+		out.version = 1;
+		out.facing_direction = data[0];
+		out.frame_count = (uint32_t)(size - 1);
+		if (out.frame_count > PLAYBACK_FILE_MAX_FRAMES) {
+			return false;
+		}
+		if (!header_only) {
+			out.inputs.resize(out.frame_count);
+			for (uint32_t i = 0; i < out.frame_count; i++) {
+				out.inputs[i] = (uint8_t)data[1 + i];
+			}
+		}
+		return true;
+	}
+	uint16_t version;
+	int16_t char_index;
+	memcpy(&version, data + 4, 2);
+	memcpy(&char_index, data + 6, 2);
+	out.version = version;
+	out.char_index = char_index;
+	out.facing_direction = data[8];
+	memcpy(&out.frame_count, data + 12, 4);
+	if (version != PLAYBACK_FILE_VERSION || out.frame_count > PLAYBACK_FILE_MAX_FRAMES) {
+		return false;
+	}
+	if (header_only) {
+		return true;
+	}
+	out.inputs.reserve(out.frame_count);
+	for (size_t offset = PLAYBACK_HEADER_SIZE; out.inputs.size() < out.frame_count; offset += 4) {
+		if (offset + 4 > size) {
+			return false;
+		}
+		uint16_t run, input;
+		memcpy(&run, data + offset, 2);
+		memcpy(&input, data + offset + 2, 2);
+		if (run == 0 || out.inputs.size() + run > out.frame_count) {
+			return false;
+		}
+		out.inputs.insert(out.inputs.end(), run, input);
+	}
+	return true;
+}
+
+bool read_playback_file(const std::string& path, PlaybackFile& out, bool header_only) {
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file.good()) {
+		return false;
+	}
+	std::streamoff size = file.tellg();
+	if (size <= 0) {
+		return false;
+	}
+	//the header is enough for either version, a version 1 file's frame count comes from its size
+	size_t to_read = header_only && size > (std::streamoff)PLAYBACK_HEADER_SIZE ? PLAYBACK_HEADER_SIZE : (size_t)size;
+	std::vector<char> data(to_read);
+	file.seekg(0, std::ios::beg);
+	if (!file.read(data.data(), to_read)) {
+		return false;
+	}
+	if (header_only && memcmp(data.data(), PLAYBACK_MAGIC, 4) != 0) {
+		out = PlaybackFile();
+		out.version = 1;
+		out.facing_direction = data[0];
+		out.frame_count = (uint32_t)(size - 1);
+		return out.frame_count <= PLAYBACK_FILE_MAX_FRAMES;
+	}
+	return decode_playback(data.data(), data.size(), out, header_only);
+}
+
+bool write_playback_file(const std::string& path, const PlaybackFile& playback) {
+	std::vector<char> data;
+	encode_playback(playback, data);
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file.good()) {
+		return false;
+	}
+	file.write(data.data(), data.size());
+	return file.good();
+}
+
+std::vector<uint16_t> trim_playback_inputs(const std::vector<uint16_t>& inputs) {
+	size_t first = 0;
+	size_t last = inputs.size();
+	while (first < last && inputs[first] == PLAYBACK_NEUTRAL_INPUT) {
+		first++;
+	}
+	while (last > first && inputs[last - 1] == PLAYBACK_NEUTRAL_INPUT) {
+		last--;
+	}
+	return std::vector<uint16_t>(inputs.begin() + first, inputs.begin() + last);
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/*
+	.playback files, version 2 is binary:
+		char magic[4] "BBPB", uint16 version, int16 char_index (-1 unknown), uint8 facing direction, uint8 pad[3], uint32 frame count
+		then runs of (uint16 length, uint16 input) until frame count inputs are covered, inputs are the slot's full 16 bits
+	Version 1 files (everything before) are one facing byte then one byte per frame, those get read with the high byte zeroed
+	like they always were. Version 1 can't start with the magic since its first byte is the facing direction.
+*/
+constexpr uint16_t PLAYBACK_FILE_VERSION = 2;
+constexpr uint32_t PLAYBACK_FILE_MAX_FRAMES = 0x10000; // far above what a slot holds, just keeps a broken file from allocating the world
+constexpr uint16_t PLAYBACK_NEUTRAL_INPUT = 5;
+
+struct PlaybackFile {
+	int version = PLAYBACK_FILE_VERSION;
+	int char_index = -1;
+	char facing_direction = 0;
+	uint32_t frame_count = 0; // set even when only the header was read
+	std::vector<uint16_t> inputs;
+};
+
+void encode_playback(const PlaybackFile& playback, std::vector<char>& out);
+bool decode_playback(const char* data, size_t size, PlaybackFile& out, bool header_only = false); // false if it isn't a playback or is cut off
+bool read_playback_file(const std::string& path, PlaybackFile& out, bool header_only = false);
+bool write_playback_file(const std::string& path, const PlaybackFile& playback);
+std::vector<uint16_t> trim_playback_inputs(const std::vector<uint16_t>& inputs); // drops the neutral frames at both ends
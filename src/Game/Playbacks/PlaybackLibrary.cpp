@@ -0,0 +1,173 @@
+#include "PlaybackLibrary.h"
+#include <windows.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <set>
+#define _SILENCE_EXPERIMENTAL_FILESYSTEM_DEPRECATION_WARNING
+#include <experimental/filesystem>
+
+PlaybackLibrary g_playback_library;
+
+static const char PLAYBACK_EXTENSION[] = ".playback";
+
+PlaybackLibrary::~PlaybackLibrary() {
+    if (change_handle != NULL) {
+        FindCloseChangeNotification(change_handle);
+    }
+}
+
+void PlaybackLibrary::scan() {
+    namespace fs = std::experimental::filesystem;
+    auto start = std::chrono::steady_clock::now();
+    scanned = true;
+    std::set<std::string> seen;
+    std::error_code ec;
+    if (fs::exists(PLAYBACK_LIBRARY_FOLDER_PATH, ec)) {
+        for (auto it = fs::recursive_directory_iterator(PLAYBACK_LIBRARY_FOLDER_PATH, ec); !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+            const fs::path& path = it->path();
+            std::error_code file_ec; // kept apart from ec, a file going away mid scan shouldn't end it
+            if (path.extension().string() != PLAYBACK_EXTENSION || !fs::is_regular_file(path, file_ec)) {
+                continue;
+            }
+            std::string relative = path.string().substr(strlen(PLAYBACK_LIBRARY_FOLDER_PATH));
+            std::replace(relative.begin(), relative.end(), '\\', '/');
+            std::string name = relative.substr(0, relative.size() - strlen(PLAYBACK_EXTENSION));
+            int64_t mtime = (int64_t)fs::last_write_time(path, file_ec).time_since_epoch().count();
+            seen.insert(name);
+
+            auto existing = entries.find(name);
+            if (existing != entries.end() && existing->second.mtime == mtime) {
+                continue;
+            }
+            PlaybackFile header;
+            if (!read_playback_file(path.string(), header, true)) {
+                entries.erase(name);
+                continue;
+            }
+            PlaybackLibraryEntry entry;
+            entry.name = name;
+            size_t slash = name.rfind('/');
+            entry.tag = slash == std::string::npos ? "" : name.substr(0, slash);
+            entry.char_index = header.char_index;
+            entry.frame_count = header.frame_count;
+            entry.version = header.version;
+            entry.mtime = mtime;
+            entries[name] = entry;
+        }
+    }
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (seen.count(it->first) == 0) {
+            it = entries.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+    sort_order();
+    last_scan_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool PlaybackLibrary::poll() {
+    if (!scanned) {
+        scan();
+        return true;
+    }
+    if (change_handle == NULL) {
+        // the folder only shows up once something gets saved, don't hammer the filesystem until then
+        if (GetTickCount() - last_watch_attempt < 2000) {
+            return false;
+        }
+        last_watch_attempt = GetTickCount();
+        HANDLE handle = FindFirstChangeNotificationA(PLAYBACK_LIBRARY_FOLDER_PATH, TRUE,
+            FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE);
+        if (handle == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        change_handle = handle;
+        // anything could have happened before the watch started
+        scan();
+        return true;
+    }
+    if (WaitForSingleObject(change_handle, 0) != WAIT_OBJECT_0) {
+        return false;
+    }
+    if (!FindNextChangeNotification(change_handle)) {
+        FindCloseChangeNotification(change_handle);
+        change_handle = NULL;
+    }
+    scan();
+    return true;
+}
+
+void PlaybackLibrary::sort_order() {
+    order.clear();
+    for (auto& it : entries) {
+        order.push_back(&it.second);
+    }
+    std::sort(order.begin(), order.end(), [](const PlaybackLibraryEntry* a, const PlaybackLibraryEntry* b) {
+        if (a->char_index != b->char_index) {
+            return a->char_index < b->char_index;
+        }
+        if (a->tag != b->tag) {
+            return a->tag < b->tag;
+        }
+        if (a->frame_count != b->frame_count) {
+            return a->frame_count < b->frame_count;
+        }
+        return a->name < b->name;
+    });
+}
+
+std::vector<const PlaybackLibraryEntry*> PlaybackLibrary::query(int char_index, const std::string* tag) {
+    if (!scanned) {
+        scan();
+    }
+    std::vector<const PlaybackLibraryEntry*> result;
+    for (auto entry : order) {
+        if (char_index != -1 && entry->char_index != -1 && entry->char_index != char_index) {
+            continue;
+        }
+        if (tag != NULL && entry->tag != *tag) {
+            continue;
+        }
+        result.push_back(entry);
+    }
+    return result;
+}
+
+std::vector<std::string> PlaybackLibrary::get_tags() {
+    std::set<std::string> tags;
+    for (auto& it : entries) {
+        tags.insert(it.second.tag);
+    }
+    return std::vector<std::string>(tags.begin(), tags.end());
+}
+
+const PlaybackLibraryEntry* PlaybackLibrary::find(const std::string& name) {
+    auto it = entries.find(name);
+    return it == entries.end() ? NULL : &it->second;
+}
+
+std::shared_ptr<PlaybackFile> PlaybackLibrary::preload(const std::string& name) {
+    auto it = entries.find(name);
+    if (it == entries.end()) {
+        return NULL;
+    }
+    if (it->second.loaded == NULL) {
+        std::shared_ptr<PlaybackFile> playback = std::make_shared<PlaybackFile>();
+        if (!read_playback_file(PLAYBACK_LIBRARY_FOLDER_PATH + name + PLAYBACK_EXTENSION, *playback)) {
+            return NULL;
+        }
+        it->second.loaded = playback;
+    }
+    return it->second.loaded;
+}
+
+int PlaybackLibrary::get_preloaded_count() const {
+    int count = 0;
+    for (auto& it : entries) {
+        count += it.second.loaded != NULL;
+    }
+    return count;
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include "PlaybackFile.h"
+#include <stdint.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#define PLAYBACK_LIBRARY_FOLDER_PATH "./slots/"
+
+struct PlaybackLibraryEntry {
+	std::string name; // relative to the slots folder without .playback, what PlaybackManager::load_from_file takes
+	std::string tag; // subfolder of the slots folder it's in, "" for files right in it
+	int char_index = -1; // -1 for version 1 files, they don't know it
+	uint32_t frame_count = 0;
+	int version = 0;
+	int64_t mtime = 0;
+	std::shared_ptr<PlaybackFile> loaded; // set once preloaded, dropped if the file changes
+};
+
+/*
+	Catalog of every .playback under ./slots, subfolders become tags. Scanning only reads the 16 byte header of
+	each file (the size for version 1 ones), files that didn't change since the last scan aren't opened again.
+	poll() is cheap enough to run every frame, it only rescans when Windows says something in the folder changed.
+*/
+class PlaybackLibrary {
+public:
+	~PlaybackLibrary();
+
+	void scan();
+	bool poll(); // true if the catalog changed
+
+	// sorted by character, tag, length then name. char_index -1 matches everything, otherwise files without a character match too
+	std::vector<const PlaybackLibraryEntry*> query(int char_index = -1, const std::string* tag = NULL);
+	std::vector<std::string> get_tags();
+	const PlaybackLibraryEntry* find(const std::string& name);
+	std::shared_ptr<PlaybackFile> preload(const std::string& name); // reads the inputs the first time, NULL if the file can't be read
+
+	int size() const { return (int)entries.size(); }
+	int get_preloaded_count() const;
+	long long last_scan_us = 0;
+
+private:
+	std::map<std::string, PlaybackLibraryEntry> entries; // by name
+	std::vector<const PlaybackLibraryEntry*> order;
+	bool scanned = false;
+	void* change_handle = NULL; // FindFirstChangeNotification handle, NULL until the folder exists
+	unsigned long last_watch_attempt = 0;
+
+	void sort_order();
+};
+
+extern PlaybackLibrary g_playback_library;
@@ -17,63 +17,33 @@ PlaybackManager::PlaybackManager()
     this->active_slot_p = this->bbcf_base_adress + this->active_slot_offset;
 }
 
-void  PlaybackManager::save_to_file(std::vector<char> slot_buffer, char facing_direction, char* fname) {
-    CreateDirectory(L"slots", NULL);
-
-    std::string fpath = "./slots/";
-    fpath += fname;
-    fpath += ".playback";
-    std::ofstream out(fpath);
-    out << facing_direction;
-    for (const auto& e : slot_buffer) out << e;
-    out.close();
-}
-std::vector<char> PlaybackManager::load_from_file(char* fname) {
+static std::string get_playback_path(char* fname) {
     std::string fpath = "./slots/";
     fpath += fname;
     if (fpath.find(".playback") == std::string::npos) {
         fpath += ".playback";
-        //fpath.substr(0, fpath.find(".playback") - 1);
     }
-    //char* filename = "./slots/" + fpath;
-    std::streampos fileSize;
-    std::ifstream file(fpath, std::ios::binary);
-    if (file.good()) {
-        file.seekg(0, std::ios::end);
-        fileSize = file.tellg();
-        file.seekg(0, std::ios::beg);
-
-
-        std::vector<char> fileData(fileSize);
-        file.read((char*)&fileData[0], fileSize);
-        return fileData;
-    }
-
-    else {
-        std::vector<char> fd{};
-        return fd;
-    }
-
-
+    return fpath;
 }
 
+bool PlaybackManager::save_to_file(const std::vector<uint16_t>& slot_inputs, char facing_direction, int char_index, char* fname) {
+    CreateDirectory(L"slots", NULL);
 
-std::vector<char> PlaybackManager::trim_playback(std::vector<char> slot_buffer) {
-
-    if (!slot_buffer.empty()) {
-        //trim the start
-        while (!slot_buffer.empty() && slot_buffer[0] == 5) {
-            slot_buffer.erase(slot_buffer.begin());
+    PlaybackFile playback;
+    playback.char_index = char_index;
+    playback.facing_direction = facing_direction;
+    playback.inputs = slot_inputs;
+    return write_playback_file(get_playback_path(fname), playback);
+}
 
-        }
-        //trim the end
-        while (!slot_buffer.empty() && slot_buffer.back() == 5) {
-            slot_buffer.pop_back();
-        }
-    }
+bool PlaybackManager::load_from_file(char* fname, PlaybackFile& playback) {
+    return read_playback_file(get_playback_path(fname), playback);
+}
 
-    return slot_buffer;
+std::vector<uint16_t> PlaybackManager::trim_playback(const std::vector<uint16_t>& slot_inputs) {
+    return trim_playback_inputs(slot_inputs);
 }
+
 //this is the "load_trimmed_playback" function back in ScrWindow.cpp, loads from a buffer into a slot, this assumes the direction byte is already taken care of in caso of the buffer coming from a file
 void PlaybackManager::load_into_slot(std::vector<char> trimmed_playback, int slot) {
     //the playback is not necessarily trimmed btw, just leaving for reference until I overhaul scrwindow
@@ -85,18 +55,22 @@ void PlaybackManager::load_into_slot(std::vector<char> trimmed_playback, int fac
     *(PlaybackSlot(slot).facing_direction_p) = facing_left;
     this->slots[slot - 1].load_into_slot(trimmed_playback);
 }
-void PlaybackManager::load_from_file_into_slot(char* fname, int slot)
+bool PlaybackManager::load_from_file_into_slot(char* fname, int slot)
 {
-    std::vector<char>loaded_file = this->load_from_file(fname);
-
-    if (!loaded_file.empty()) {
-        char facing_direction = loaded_file[0];
-        loaded_file.erase(loaded_file.begin());
-        //should make a set facing direction in the playbackslot maybe, if i'm not going to make a class to represent the playback by itself
-        memcpy(this->slots[slot - 1].facing_direction_p, &(facing_direction), sizeof(char));
+    PlaybackFile playback;
+    if (!this->load_from_file(fname, playback)) {
+        return false;
     }
-    if (!loaded_file.empty()) {
-        this->slots[slot - 1].load_into_slot(loaded_file);
+    load_playback_into_slot(playback, slot);
+    return true;
+}
+
+void PlaybackManager::load_playback_into_slot(const PlaybackFile& playback, int slot)
+{
+    //should make a set facing direction in the playbackslot maybe, if i'm not going to make a class to represent the playback by itself
+    memcpy(this->slots[slot - 1].facing_direction_p, &(playback.facing_direction), sizeof(char));
+    if (!playback.inputs.empty()) {
+        this->slots[slot - 1].load_inputs_into_slot(playback.inputs.data(), playback.inputs.size());
     }
 }
 
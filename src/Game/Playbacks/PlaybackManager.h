@@ -1,6 +1,7 @@
 #pragma once
 #include <vector>
 #include "PlaybackSlot.h"
+#include "PlaybackFile.h"
 #include <array>
 class PlaybackManager
 {
@@ -14,13 +15,14 @@ public:
 	std::vector<PlaybackSlot> slots; //one for each of the 4 playback slots
 
 	
-	void save_to_file(std::vector<char> slot_buffer, char facing_direction, char* fname);
-	std::vector<char> load_from_file(char* fname);/*returns the contents of the file*/
-	std::vector<char> trim_playback(std::vector<char> slot_buffer);
+	bool save_to_file(const std::vector<uint16_t>& slot_inputs, char facing_direction, int char_index, char* fname); /*always writes the current .playback version*/
+	bool load_from_file(char* fname, PlaybackFile& playback);/*reads either .playback version*/
+	std::vector<uint16_t> trim_playback(const std::vector<uint16_t>& slot_inputs);
 	void load_into_slot(std::vector<char> trimmed_playback, int slot); /*this is the "load_trimmed_playback" function back in ScrWindow.cpp, loads from a buffer into a slot, this assumes the direction byte is already taken care of in caso of the buffer coming from a file*/
 	void load_into_slot(std::vector<char> trimmed_playback, int facing_left, int slot); /*this is the "load_trimmed_playback" function back in ScrWindow.cpp, loads from a buffer into a slot, this assumes the direction byte is already taken care of in caso of the buffer coming from a file*/
 
-	void load_from_file_into_slot(char* fname, int slot); /*loads from a file into a slot doing the necessary checks to ensure the file is valid, the facing byte is correctly set and won't crash*/
+	void load_playback_into_slot(const PlaybackFile& playback, int slot); /*sets the facing byte and copies the inputs in one go*/
+	bool load_from_file_into_slot(char* fname, int slot); /*loads from a file into a slot doing the necessary checks to ensure the file is valid, the facing byte is correctly set and won't crash*/
 	void set_active_slot(int slot);
 	void set_playback_control(int playback_control); /*set to 3 to start playback without direction adjustment, 0 for dummy, 1 for recording standby, 2 for bugged recording, 3 for playback, 4 for controller, 5 for cpu, 6 for continuous playback*/
 	void set_playback_position(int frame_position);
@@ -35,23 +35,42 @@ char* PlaybackSlot::initialize_start_of_slot_inputs_p(int slot)
 }
 
 void PlaybackSlot::load_into_slot(std::vector<char> trimmed_playback) {
-	int frame_len_loaded_file = trimmed_playback.size();
-	memcpy(this->frame_len_slot_p, &(frame_len_loaded_file), 4);
-	int iter = 0;
-	for (auto input : trimmed_playback) {
-		memcpy(this->start_of_slot_inputs_p + (iter * 2), &input, 1); //sets the move
-		memset(this->start_of_slot_inputs_p + (iter * 2)+1,0x0 , 1); //zeroes the taunt(?) flag. The next step is to change all the shit regarding playback from chars to uint16, so that the extra byte for taunt(?) is included and not just zeroed
-		iter++;
+	//zeroes the taunt(?) flag, anything that has the full inputs should use load_inputs_into_slot
+	std::vector<uint16_t> inputs(trimmed_playback.size());
+	for (size_t i = 0; i < trimmed_playback.size(); i++) {
+		inputs[i] = (uint8_t)trimmed_playback[i];
 	}
+	load_inputs_into_slot(inputs.data(), inputs.size());
 }
+
+void PlaybackSlot::load_inputs_into_slot(const uint16_t* inputs, int frame_len) {
+	if (frame_len < 0) {
+		frame_len = 0;
+	}
+	if (frame_len > PLAYBACK_SLOT_MAX_FRAMES) {
+		frame_len = PLAYBACK_SLOT_MAX_FRAMES;
+	}
+	memcpy(this->start_of_slot_inputs_p, inputs, frame_len * 2);
+	memcpy(this->frame_len_slot_p, &frame_len, 4);
+}
+
 std::vector<char> PlaybackSlot::get_slot_buffer() {
-	std::vector<char> slot1_recording_frames{};
+	std::vector<uint16_t> inputs = get_slot_inputs();
+	return std::vector<char>(inputs.begin(), inputs.end());
+}
+
+std::vector<uint16_t> PlaybackSlot::get_slot_inputs() {
 	int frame_len_slot;
-	memcpy(&frame_len_slot, this->frame_len_slot_p, 4); // probably unnecessary, but dont have the time to test rn so i'll copy what i had before
-	for (int i = 0; i < frame_len_slot; i++) {
-		slot1_recording_frames.push_back(*(this->start_of_slot_inputs_p + i * 2));
+	memcpy(&frame_len_slot, this->frame_len_slot_p, 4);
+	if (frame_len_slot < 0) {
+		frame_len_slot = 0;
+	}
+	if (frame_len_slot > PLAYBACK_SLOT_MAX_FRAMES) {
+		frame_len_slot = PLAYBACK_SLOT_MAX_FRAMES;
 	}
-	return slot1_recording_frames;
+	std::vector<uint16_t> inputs(frame_len_slot);
+	memcpy(inputs.data(), this->start_of_slot_inputs_p, frame_len_slot * 2);
+	return inputs;
 }
 
 char PlaybackSlot::get_facing_direction()
@@ -1,5 +1,8 @@
 #pragma once
 #include <vector>
+#include <stdint.h>
+
+constexpr int PLAYBACK_SLOT_MAX_FRAMES = 0x960 / 2; // the slots' inputs are 0x960 bytes apart, 2 bytes per frame
 
 class PlaybackSlot
 {
@@ -8,9 +11,11 @@ public:
 	int initialize_frame_len_slot(int slot);/*initializes the frame_len_slot for the specified slot*/
 	int initialize_facing_direction_slot(int slot); /*initializes the facing_direction for the specified slot*/
 	char* initialize_start_of_slot_inputs_p(int slot); /*initializes the start_of_slot_inputs_p for the specified slot*/
-	void load_into_slot(std::vector<char> trimmed_playback); //this is the "load_trimmed_playback" function back in ScrWindow.cpp
+	void load_into_slot(std::vector<char> trimmed_playback); //this is the "load_trimmed_playback" function back in ScrWindow.cpp, only sets the low byte of each input
+	void load_inputs_into_slot(const uint16_t* inputs, int frame_len); // full 16 bit inputs in one copy, clamped to PLAYBACK_SLOT_MAX_FRAMES
 
-	std::vector<char> get_slot_buffer();
+	std::vector<char> get_slot_buffer(); // low byte of each input, what the playback editor works with
+	std::vector<uint16_t> get_slot_inputs();
 	char get_facing_direction();
 	
 	
@@ -4,8 +4,9 @@ void Player::SetCharDataPtr(const void* addr)
 {
 	m_charData = (CharData**)addr;
 }
-void Player::SetScrStates(std::vector<scrState*> states) {
-	this->states = states;
+void Player::SetScrStates(std::shared_ptr<ScrStateArena> arena) {
+	this->scr_arena = arena;
+	this->states = arena ? arena->states : std::vector<scrState*>{};
 }
 bool Player::IsCharDataNullPtr() const
 {
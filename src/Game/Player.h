@@ -1,7 +1,9 @@
 #pragma once
 #include "CharData.h"
 #include "Scr/ScrStateEntry.h"
+#include "Scr/ScrStateArena.h"
 #include <vector>
+#include <memory>
 #include "Palette/CharPaletteHandle.h"
 
 class Player
@@ -9,11 +11,12 @@ class Player
 public:
 	CharData* GetData() const;
 	CharPaletteHandle& GetPalHandle();
-	std::vector<scrState*> states{};
+	std::vector<scrState*> states{}; // owned by scr_arena
+	std::shared_ptr<ScrStateArena> scr_arena;
 
 
 	void SetCharDataPtr(const void* addr);
-	void SetScrStates(std::vector<scrState*>);
+	void SetScrStates(std::shared_ptr<ScrStateArena> arena); // frees the previous script's states once nothing else holds them
 	bool IsCharDataNullPtr() const;
 
 
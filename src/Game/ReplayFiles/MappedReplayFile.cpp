@@ -0,0 +1,89 @@
+#include "MappedReplayFile.h"
+#include "ReplayFileManager.h"
+#include <cstring>
+
+MappedReplayFile::MappedReplayFile() {
+    file = INVALID_HANDLE_VALUE;
+    mapping = NULL;
+    view = NULL;
+    view_size = 0;
+}
+
+MappedReplayFile::MappedReplayFile(const std::string& path) : MappedReplayFile() {
+    open(path);
+}
+
+MappedReplayFile::~MappedReplayFile() {
+    close();
+}
+
+bool MappedReplayFile::open(const std::string& path) {
+    close();
+    file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+        //can't map an empty file
+        close();
+        return false;
+    }
+    view_size = (size_t)min(file_size.QuadPart, (LONGLONG)REPLAY_FILE_SIZE);
+    mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping == NULL) {
+        close();
+        return false;
+    }
+    view = (const uint8_t*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, view_size);
+    if (view == NULL) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void MappedReplayFile::close() {
+    if (view != NULL) {
+        UnmapViewOfFile(view);
+        view = NULL;
+    }
+    if (mapping != NULL) {
+        CloseHandle(mapping);
+        mapping = NULL;
+    }
+    if (file != INVALID_HANDLE_VALUE) {
+        CloseHandle(file);
+        file = INVALID_HANDLE_VALUE;
+    }
+    view_size = 0;
+}
+
+bool MappedReplayFile::is_open() const {
+    return view != NULL;
+}
+
+const ReplayFile* MappedReplayFile::get() const {
+    return (const ReplayFile*)view;
+}
+
+size_t MappedReplayFile::size() const {
+    return view_size;
+}
+
+bool MappedReplayFile::has_header() const {
+    return view_size >= 8 + 0x390;
+}
+
+bool MappedReplayFile::is_complete() const {
+    return view_size >= REPLAY_FILE_SIZE;
+}
+
+size_t MappedReplayFile::copy_to(void* dest, size_t max_size) const {
+    if (view == NULL) {
+        return 0;
+    }
+    size_t n = min(view_size, max_size);
+    memcpy(dest, view, n);
+    return n;
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <Windows.h>
+#include "ReplayFile.h"
+
+/*
+	Read only memory mapped view of a replay file, lets callers look at the ReplayFile in place instead of
+	streaming the 64 KiB into a buffer first. The view stays valid until close() or destruction.
+*/
+class MappedReplayFile {
+public:
+	MappedReplayFile();
+	MappedReplayFile(const std::string& path);
+	~MappedReplayFile();
+	MappedReplayFile(const MappedReplayFile&) = delete;
+	MappedReplayFile& operator=(const MappedReplayFile&) = delete;
+
+	bool open(const std::string& path);
+	void close();
+	bool is_open() const;
+
+	const ReplayFile* get() const; // NULL if not open. Only size() bytes are backed by the file, check has_header()/is_complete() first
+	size_t size() const;
+	bool has_header() const; // large enough for the 0x390 header replay_list.dat uses
+	bool is_complete() const; // a full REPLAY_FILE_SIZE replay
+	size_t copy_to(void* dest, size_t max_size) const; // copies min(size(), max_size) bytes, returns how many
+
+private:
+	HANDLE file;
+	HANDLE mapping;
+	const uint8_t* view;
+	size_t view_size;
+};
@@ -0,0 +1,272 @@
+#include "ReplayArchiveIndex.h"
+#include "ReplayFileManager.h"
+#include "MappedReplayFile.h"
+#include "Core/utils.h"
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+#include <cwctype>
+#include <experimental/filesystem>
+
+static const char REPLAY_ARCHIVE_INDEX_MAGIC[4] = { 'R', 'A', 'I', 'X' };
+
+static std::wstring to_lower(std::wstring s) {
+    for (auto& c : s) {
+        c = towlower(c);
+    }
+    return s;
+}
+
+static bool name_contains(const wchar_t* name, size_t name_max, const std::wstring& needle_lower) {
+    if (needle_lower.empty()) {
+        return true;
+    }
+    std::wstring n(name, wcsnlen(name, name_max));
+    return to_lower(n).find(needle_lower) != std::wstring::npos;
+}
+
+ReplayArchiveIndex::ReplayArchiveIndex(std::string index_path) {
+    this->index_path = index_path;
+    loaded = false;
+    order_dirty = true;
+    holding_adds = false;
+}
+
+int64_t ReplayArchiveIndex::get_archive_mtime() {
+    std::error_code ec;
+    auto t = std::experimental::filesystem::last_write_time(REPLAY_ARCHIVE_FOLDER_PATH, ec);
+    if (ec) {
+        return 0;
+    }
+    return (int64_t)t.time_since_epoch().count();
+}
+
+bool ReplayArchiveIndex::load() {
+    records.clear();
+    by_filename.clear();
+    order_dirty = true;
+    loaded = true;
+
+    std::ifstream f(index_path, std::ios::binary);
+    if (!f.good()) {
+        return rebuild();
+    }
+    ReplayArchiveIndexHeader header;
+    f.read((char*)&header, sizeof(header));
+    if (!f || memcmp(header.magic, REPLAY_ARCHIVE_INDEX_MAGIC, 4) != 0
+        || header.version != REPLAY_ARCHIVE_INDEX_VERSION
+        || header.record_size != sizeof(ReplayArchiveRecord)
+        || header.archive_mtime != get_archive_mtime()) {
+        f.close();
+        return rebuild();
+    }
+    records.resize(header.count);
+    f.read((char*)records.data(), (std::streamsize)header.count * sizeof(ReplayArchiveRecord));
+    if (!f) {
+        f.close();
+        return rebuild();
+    }
+    for (int i = 0; i < (int)records.size(); i++) {
+        records[i].filename[REPLAY_ARCHIVE_FILENAME_MAX - 1] = 0;
+        by_filename[records[i].filename] = i;
+    }
+    return true;
+}
+
+bool ReplayArchiveIndex::rebuild() {
+    records.clear();
+    by_filename.clear();
+    order_dirty = true;
+    loaded = true;
+
+    std::error_code ec;
+    if (std::experimental::filesystem::exists(REPLAY_ARCHIVE_FOLDER_PATH, ec)) {
+        for (const auto& entry : std::experimental::filesystem::directory_iterator(REPLAY_ARCHIVE_FOLDER_PATH)) {
+            std::string filename = entry.path().filename().string();
+            if (filename.size() >= REPLAY_ARCHIVE_FILENAME_MAX) {
+                continue;
+            }
+            MappedReplayFile file(REPLAY_ARCHIVE_FOLDER_PATH + filename);
+            if (!file.has_header()) {
+                continue;
+            }
+            ReplayArchiveRecord record;
+            memset(&record, 0, sizeof(record));
+            memcpy(&record.header, (const char*)file.get() + 8, sizeof(record.header));
+            strncpy(record.filename, filename.c_str(), REPLAY_ARCHIVE_FILENAME_MAX - 1);
+            by_filename[filename] = (int)records.size();
+            records.push_back(record);
+        }
+    }
+    return save();
+}
+
+bool ReplayArchiveIndex::save() {
+    std::ofstream out(index_path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        return false;
+    }
+    ReplayArchiveIndexHeader header;
+    memcpy(header.magic, REPLAY_ARCHIVE_INDEX_MAGIC, 4);
+    header.version = REPLAY_ARCHIVE_INDEX_VERSION;
+    header.record_size = sizeof(ReplayArchiveRecord);
+    header.count = (uint32_t)records.size();
+    header.archive_mtime = get_archive_mtime();
+    out.write((char*)&header, sizeof(header));
+    out.write((char*)records.data(), (std::streamsize)records.size() * sizeof(ReplayArchiveRecord));
+    return out.good();
+}
+
+bool ReplayArchiveIndex::write_record(int index) {
+    std::fstream out(index_path, std::ios::binary | std::ios::in | std::ios::out);
+    if (!out.is_open()) {
+        return save();
+    }
+    ReplayArchiveIndexHeader header;
+    memcpy(header.magic, REPLAY_ARCHIVE_INDEX_MAGIC, 4);
+    header.version = REPLAY_ARCHIVE_INDEX_VERSION;
+    header.record_size = sizeof(ReplayArchiveRecord);
+    header.count = (uint32_t)records.size();
+    header.archive_mtime = get_archive_mtime();
+    out.seekp(0, std::ios_base::beg);
+    out.write((char*)&header, sizeof(header));
+    out.seekp(sizeof(header) + (std::streamoff)index * sizeof(ReplayArchiveRecord), std::ios_base::beg);
+    out.write((char*)&records[index], sizeof(ReplayArchiveRecord));
+    return out.good();
+}
+
+bool ReplayArchiveIndex::add(const std::string& filename, ReplayFile* replay_file) {
+    if (!loaded) {
+        //the replay is already written so a rebuild here would pick it up too, the record below just replaces it
+        load();
+    }
+    if (filename.size() >= REPLAY_ARCHIVE_FILENAME_MAX) {
+        return false;
+    }
+    ReplayArchiveRecord record;
+    memset(&record, 0, sizeof(record));
+    strncpy(record.filename, filename.c_str(), REPLAY_ARCHIVE_FILENAME_MAX - 1);
+    memcpy(&record.header, (char*)replay_file + 8, sizeof(record.header));
+    if (holding_adds) {
+        held_adds.push_back(record);
+    }
+    return put(record);
+}
+
+bool ReplayArchiveIndex::put(const ReplayArchiveRecord& record) {
+    std::string filename = record.filename;
+    int index;
+    auto it = by_filename.find(filename);
+    if (it != by_filename.end()) {
+        index = it->second;
+        records[index] = record;
+    }
+    else {
+        index = (int)records.size();
+        records.push_back(record);
+        by_filename[filename] = index;
+        order_dirty = true;
+    }
+    return write_record(index);
+}
+
+void ReplayArchiveIndex::hold_adds() {
+    holding_adds = true;
+    held_adds.clear();
+}
+
+bool ReplayArchiveIndex::replace_with(ReplayArchiveIndex& rebuilt) {
+    std::vector<ReplayArchiveRecord> held;
+    held.swap(held_adds);
+    std::string path = index_path;
+    std::string rebuilt_path = rebuilt.index_path;
+    *this = std::move(rebuilt);
+    index_path = path;
+    holding_adds = false;
+
+    //the records written to the old file while the rebuild ran go away with it, they're put back from held below
+    std::error_code ec;
+    std::experimental::filesystem::rename(rebuilt_path, index_path, ec);
+    bool ok = ec ? save() : true;
+    //each put stamps the folder's current mtime, so the index only checks out once all of them are in
+    for (const ReplayArchiveRecord& record : held) {
+        ok = put(record) && ok;
+    }
+    return ok;
+}
+
+void ReplayArchiveIndex::sort_order() {
+    if (!order_dirty) {
+        return;
+    }
+    order.resize(records.size());
+    for (int i = 0; i < (int)order.size(); i++) {
+        order[i] = i;
+    }
+    // descending filename order means newest to oldest
+    std::sort(order.begin(), order.end(), [this](int a, int b) {
+        return strcmp(records[a].filename, records[b].filename) > 0;
+    });
+    order_dirty = false;
+}
+
+bool ReplayArchiveIndex::matches(ReplayArchiveRecord& record, int character1, const std::wstring& player1, int character2, const std::wstring& player2) {
+    ReplayFile* file = record.data();
+    if (character1 != -1 && (int)file->p1_toon != character1) {
+        return false;
+    }
+    if (character2 != -1 && (int)file->p2_toon != character2) {
+        return false;
+    }
+    return name_contains(file->p1_name, 0x12, player1) && name_contains(file->p2_name, 0x12, player2);
+}
+
+std::vector<ReplayArchiveRecord*> ReplayArchiveIndex::query(int page, int page_size, int character1, std::string player1, int character2, std::string player2) {
+    if (!loaded) {
+        load();
+    }
+    sort_order();
+    std::wstring p1 = to_lower(utf8_to_utf16(player1));
+    std::wstring p2 = to_lower(utf8_to_utf16(player2));
+
+    std::vector<ReplayArchiveRecord*> result;
+    int skip = max(0, page) * page_size;
+    for (int i : order) {
+        if (!matches(records[i], character1, p1, character2, p2)) {
+            continue;
+        }
+        if (skip > 0) {
+            skip--;
+            continue;
+        }
+        result.push_back(&records[i]);
+        if ((int)result.size() >= page_size) {
+            break;
+        }
+    }
+    return result;
+}
+
+int ReplayArchiveIndex::count_matches(int character1, std::string player1, int character2, std::string player2) {
+    if (!loaded) {
+        load();
+    }
+    std::wstring p1 = to_lower(utf8_to_utf16(player1));
+    std::wstring p2 = to_lower(utf8_to_utf16(player2));
+    int n = 0;
+    for (auto& record : records) {
+        if (matches(record, character1, p1, character2, p2)) {
+            n++;
+        }
+    }
+    return n;
+}
+
+int ReplayArchiveIndex::size() {
+    if (!loaded) {
+        load();
+    }
+    return (int)records.size();
+}
+
+ReplayArchiveIndex g_replay_archive_index;
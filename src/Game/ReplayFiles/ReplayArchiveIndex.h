@@ -0,0 +1,74 @@
+#pragma once
+#include <stdint.h>
+#include "ReplayFile.h"
+#include "ReplayList.h"
+#include <vector>
+#include <string>
+#include <unordered_map>
+#define REPLAY_ARCHIVE_INDEX_PATH "./Save/Replay/archive_index.dat" // outside of archive/ so older versions listing that folder don't pick it up
+#define REPLAY_ARCHIVE_INDEX_REBUILD_PATH "./Save/Replay/archive_index.dat.rebuild" // where ReplayArchiveJob rebuilds it, moved into place when done
+#define REPLAY_ARCHIVE_INDEX_VERSION 1
+#define REPLAY_ARCHIVE_FILENAME_MAX 128
+#pragma pack(push, 1)
+
+struct ReplayArchiveIndexHeader
+{
+	char magic[4]; // "RAIX"
+	uint32_t version;
+	uint32_t record_size;
+	uint32_t count;
+	int64_t archive_mtime; // last write time of the archive folder when the index was last synced, anything else touching it triggers a rebuild
+};
+
+struct ReplayArchiveRecord
+{
+	char filename[REPLAY_ARCHIVE_FILENAME_MAX]; // relative to REPLAY_ARCHIVE_FOLDER_PATH
+	ReplayFileHeader header; // same 0x390 bytes replay_list.dat keeps, dates/steam ids/names/characters/winner/levels
+
+	inline ReplayFile* data() { return header.data(); }
+};
+
+#pragma pack(pop)
+
+/*
+	On disk index of ./Save/Replay/archive/, one fixed size record per archived replay so listing and filtering
+	the archive never has to open the 64 KiB replay files.
+	Records are kept in the order they were added, adding a replay writes only its own record and the header.
+*/
+class ReplayArchiveIndex {
+public:
+	ReplayArchiveIndex(std::string index_path = REPLAY_ARCHIVE_INDEX_PATH);
+
+	bool load(); // reads the index, rebuilds it if missing, outdated or the archive folder was changed by something else
+	bool rebuild(); // scans the archive folder, reading only the header of each replay
+	bool add(const std::string& filename, ReplayFile* replay_file); // adds or replaces the record for filename
+
+	// while another instance rebuilds into its own file, adds here are also kept to be applied again by replace_with
+	void hold_adds();
+	// moves rebuilt's file over this one's and takes its records, then applies the adds held since hold_adds
+	bool replace_with(ReplayArchiveIndex& rebuilt);
+
+	// newest first, same order as sorting the archive filenames descending. -1/"" disable a filter, player names match case insensitive substrings
+	std::vector<ReplayArchiveRecord*> query(int page, int page_size, int character1 = -1, std::string player1 = "", int character2 = -1, std::string player2 = "");
+	int count_matches(int character1 = -1, std::string player1 = "", int character2 = -1, std::string player2 = "");
+	int size();
+
+private:
+	std::string index_path;
+	bool loaded;
+	bool order_dirty;
+	std::vector<ReplayArchiveRecord> records;
+	std::unordered_map<std::string, int> by_filename;
+	std::vector<int> order; // record indices sorted by filename descending
+	bool holding_adds;
+	std::vector<ReplayArchiveRecord> held_adds;
+
+	bool save(); // rewrites the whole index
+	bool write_record(int index); // writes a single record plus the header
+	bool put(const ReplayArchiveRecord& record);
+	void sort_order();
+	bool matches(ReplayArchiveRecord& record, int character1, const std::wstring& player1, int character2, const std::wstring& player2);
+	static int64_t get_archive_mtime();
+};
+
+extern ReplayArchiveIndex g_replay_archive_index;
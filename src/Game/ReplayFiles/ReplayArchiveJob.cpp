@@ -0,0 +1,97 @@
+#include "ReplayArchiveJob.h"
+#include "ReplayFileManager.h"
+#include <cstring>
+
+ReplayArchiveJob::ReplayArchiveJob() {
+    kind = ReplayArchiveJob_None;
+    finished = false;
+    success = false;
+    stats.reset(new ReplayArchiveStatsResult());
+    memset(stats.get(), 0, sizeof(ReplayArchiveStatsResult));
+}
+
+ReplayArchiveJob::~ReplayArchiveJob() {
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+bool ReplayArchiveJob::start(ReplayArchiveJobKind kind, std::function<bool()> work) {
+    if (thread.joinable()) {
+        return false;
+    }
+    this->kind = kind;
+    finished = false;
+    progress.done = 0;
+    progress.total = 0;
+    thread = std::thread([this, work] {
+        success = work();
+        finished = true;
+    });
+    return true;
+}
+
+bool ReplayArchiveJob::start_rebuild_index() {
+    if (thread.joinable()) {
+        return false;
+    }
+    //replays archived while it runs go to the live index and its file as usual, poll applies them again on top of the rebuild
+    g_replay_archive_index.hold_adds();
+    return start(ReplayArchiveJob_RebuildIndex, [this] {
+        index.reset(new ReplayArchiveIndex(REPLAY_ARCHIVE_INDEX_REBUILD_PATH));
+        return index->rebuild();
+    });
+}
+
+bool ReplayArchiveJob::start_build_stats(int threads) {
+    return start(ReplayArchiveJob_BuildStats, [this, threads] {
+        return ReplayArchiveStats::build(REPLAY_ARCHIVE_FOLDER_PATH, threads, *stats, &progress)
+            && ReplayArchiveStats::save(*stats);
+    });
+}
+
+bool ReplayArchiveJob::start_measure_scaling(int max_threads) {
+    return start(ReplayArchiveJob_MeasureScaling, [this, max_threads] {
+        scaling = ReplayArchiveStats::measure_scaling(REPLAY_ARCHIVE_FOLDER_PATH, max_threads, &progress);
+        return !scaling.empty();
+    });
+}
+
+ReplayArchiveJobKind ReplayArchiveJob::poll() {
+    if (!thread.joinable() || !finished) {
+        return ReplayArchiveJob_None;
+    }
+    thread.join();
+    if (kind == ReplayArchiveJob_RebuildIndex) {
+        //the records the old index handed out go away here, the caller rebuilds its page right after
+        if (!g_replay_archive_index.replace_with(*index)) {
+            success = false;
+        }
+        index.reset();
+    }
+    return kind;
+}
+
+bool ReplayArchiveJob::is_running() const {
+    return thread.joinable();
+}
+
+ReplayArchiveJobKind ReplayArchiveJob::get_kind() const {
+    return kind;
+}
+
+const ReplayArchiveProgress& ReplayArchiveJob::get_progress() const {
+    return progress;
+}
+
+bool ReplayArchiveJob::succeeded() const {
+    return success;
+}
+
+const ReplayArchiveStatsResult& ReplayArchiveJob::get_stats() const {
+    return *stats;
+}
+
+const std::vector<double>& ReplayArchiveJob::get_scaling() const {
+    return scaling;
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include "ReplayArchiveIndex.h"
+#include "ReplayArchiveStats.h"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+enum ReplayArchiveJobKind {
+	ReplayArchiveJob_None,
+	ReplayArchiveJob_RebuildIndex,
+	ReplayArchiveJob_BuildStats,
+	ReplayArchiveJob_MeasureScaling
+};
+
+/*
+	Runs the slow archive work (index rebuild, stats build, thread scaling) on its own thread so the overlay keeps drawing.
+	One job at a time: the window starts it, shows get_progress while it runs and calls poll every frame, poll hands the
+	result over on the calling thread once the job is done.
+	The index is rebuilt into its own instance and file and only moved into g_replay_archive_index by poll, readers never see it half built
+	and the game thread's adds never share a file with the worker.
+*/
+class ReplayArchiveJob {
+public:
+	ReplayArchiveJob();
+	~ReplayArchiveJob(); // waits for a running job
+	ReplayArchiveJob(const ReplayArchiveJob&) = delete;
+	ReplayArchiveJob& operator=(const ReplayArchiveJob&) = delete;
+
+	// false if a job is already running
+	bool start_rebuild_index();
+	bool start_build_stats(int threads); // also saves the result to REPLAY_ARCHIVE_STATS_PATH
+	bool start_measure_scaling(int max_threads);
+
+	ReplayArchiveJobKind poll(); // the job that just finished, ReplayArchiveJob_None while running or idle
+	bool is_running() const;
+	ReplayArchiveJobKind get_kind() const;
+	const ReplayArchiveProgress& get_progress() const;
+
+	bool succeeded() const; // of the job poll last returned
+	const ReplayArchiveStatsResult& get_stats() const; // set by BuildStats
+	const std::vector<double>& get_scaling() const; // set by MeasureScaling
+
+private:
+	ReplayArchiveJobKind kind;
+	std::thread thread;
+	std::atomic<bool> finished;
+	bool success;
+	ReplayArchiveProgress progress;
+	std::unique_ptr<ReplayArchiveIndex> index;
+	std::unique_ptr<ReplayArchiveStatsResult> stats; // a few dozen KB of matchups, kept off the window's statics
+	std::vector<double> scaling;
+
+	bool start(ReplayArchiveJobKind kind, std::function<bool()> work);
+};
@@ -0,0 +1,245 @@
+#include "ReplayArchiveStats.h"
+#include "ReplayFileManager.h"
+#include "ReplayInputCodec.h"
+#include "MappedReplayFile.h"
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <fstream>
+#include <cstring>
+#include <memory>
+#include <experimental/filesystem>
+
+static const char REPLAY_ARCHIVE_STATS_MAGIC[4] = { 'R', 'A', 'S', 'T' };
+
+struct ReplayArchiveStatsWorker {
+    int replays;
+    int invalid;
+    MatchupStats matchups[REPLAY_ARCHIVE_STATS_TOONS][REPLAY_ARCHIVE_STATS_TOONS];
+};
+
+static void add_replay(const ReplayFile* file, ReplayArchiveStatsWorker& worker) {
+    if (!g_rep_manager.check_file_validity((ReplayFile*)file)) {
+        worker.invalid++;
+        return;
+    }
+    int chunk_frames[REPLAY_INPUT_MAX_CHUNKS] = {};
+    uint64_t runs = 0;
+    ReplayInputCodec::for_each_run((const uint8_t*)file + REPLAY_INPUT_STREAM_OFFSET, REPLAY_INPUT_STREAM_SIZE,
+        [&](int chunk, uint16_t input, uint16_t count) {
+            if (input != 0) {
+                chunk_frames[chunk] += count;
+                runs++;
+            }
+            return true;
+        });
+
+    MatchupStats& stats = worker.matchups[file->p1_toon][file->p2_toon];
+    stats.games++;
+    //winner_maybe is 0-2, assuming 0 is p1 and 1 is p2
+    if (file->winner_maybe == 0) {
+        stats.p1_wins++;
+    }
+    else if (file->winner_maybe == 1) {
+        stats.p2_wins++;
+    }
+    for (int c = 0; c + 1 < REPLAY_INPUT_MAX_CHUNKS; c += 2) {
+        if (chunk_frames[c] > 0 || chunk_frames[c + 1] > 0) {
+            stats.rounds++;
+        }
+        stats.frames += chunk_frames[c] + chunk_frames[c + 1];
+    }
+    stats.input_runs += runs;
+    worker.replays++;
+}
+
+int ReplayArchiveStats::get_default_thread_count() {
+    int n = (int)std::thread::hardware_concurrency();
+    return n < 1 ? 1 : min(n, REPLAY_ARCHIVE_STATS_MAX_THREADS);
+}
+
+bool ReplayArchiveStats::build(const std::string& folder, int threads, ReplayArchiveStatsResult& result, ReplayArchiveProgress* progress) {
+    memset(&result, 0, sizeof(result));
+    std::error_code ec;
+    if (!std::experimental::filesystem::exists(folder, ec)) {
+        return false;
+    }
+    threads = max(1, min(threads, REPLAY_ARCHIVE_STATS_MAX_THREADS));
+    result.threads = threads;
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::string> paths;
+    for (const auto& entry : std::experimental::filesystem::directory_iterator(folder)) {
+        paths.push_back(entry.path().string());
+    }
+    if (progress) {
+        progress->done = 0;
+        progress->total = (int)paths.size();
+    }
+
+    std::atomic<size_t> cursor(0);
+    std::unique_ptr<ReplayArchiveStatsWorker[]> workers(new ReplayArchiveStatsWorker[threads]);
+    memset(workers.get(), 0, sizeof(ReplayArchiveStatsWorker) * threads);
+    auto work = [&](int id) {
+        ReplayArchiveStatsWorker& worker = workers[id];
+        MappedReplayFile file;
+        for (;;) {
+            size_t i = cursor.fetch_add(1);
+            if (i >= paths.size()) {
+                return;
+            }
+            if (!file.open(paths[i]) || !file.is_complete()) {
+                worker.invalid++;
+            }
+            else {
+                add_replay(file.get(), worker);
+            }
+            if (progress) {
+                progress->done++;
+            }
+        }
+    };
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; t++) {
+        pool.push_back(std::thread(work, t));
+    }
+    work(0);
+    for (auto& t : pool) {
+        t.join();
+    }
+
+    for (int t = 0; t < threads; t++) {
+        result.replays += workers[t].replays;
+        result.invalid += workers[t].invalid;
+        for (int p1 = 0; p1 < REPLAY_ARCHIVE_STATS_TOONS; p1++) {
+            for (int p2 = 0; p2 < REPLAY_ARCHIVE_STATS_TOONS; p2++) {
+                MatchupStats& dst = result.matchups[p1][p2];
+                const MatchupStats& src = workers[t].matchups[p1][p2];
+                dst.games += src.games;
+                dst.p1_wins += src.p1_wins;
+                dst.p2_wins += src.p2_wins;
+                dst.rounds += src.rounds;
+                dst.frames += src.frames;
+                dst.input_runs += src.input_runs;
+            }
+        }
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return true;
+}
+
+template <typename T, typename F>
+static void write_column(std::ofstream& out, const std::vector<std::pair<int, int>>& rows, F get) {
+    std::vector<T> column;
+    column.reserve(rows.size());
+    for (auto& row : rows) {
+        column.push_back((T)get(row.first, row.second));
+    }
+    out.write((const char*)column.data(), column.size() * sizeof(T));
+}
+
+template <typename T>
+static bool read_column(std::ifstream& in, std::vector<T>& column, uint32_t rows) {
+    column.resize(rows);
+    in.read((char*)column.data(), (std::streamsize)rows * sizeof(T));
+    return (bool)in;
+}
+
+bool ReplayArchiveStats::save(const ReplayArchiveStatsResult& result, const std::string& path) {
+    std::vector<std::pair<int, int>> rows;
+    for (int p1 = 0; p1 < REPLAY_ARCHIVE_STATS_TOONS; p1++) {
+        for (int p2 = 0; p2 < REPLAY_ARCHIVE_STATS_TOONS; p2++) {
+            if (result.matchups[p1][p2].games > 0) {
+                rows.push_back(std::make_pair(p1, p2));
+            }
+        }
+    }
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        return false;
+    }
+    uint32_t version = REPLAY_ARCHIVE_STATS_VERSION;
+    uint32_t row_count = (uint32_t)rows.size();
+    out.write(REPLAY_ARCHIVE_STATS_MAGIC, 4);
+    out.write((const char*)&version, 4);
+    out.write((const char*)&row_count, 4);
+    auto& m = result.matchups;
+    write_column<uint8_t>(out, rows, [&](int p1, int p2) { return p1; });
+    write_column<uint8_t>(out, rows, [&](int p1, int p2) { return p2; });
+    write_column<uint32_t>(out, rows, [&](int p1, int p2) { return m[p1][p2].games; });
+    write_column<uint32_t>(out, rows, [&](int p1, int p2) { return m[p1][p2].p1_wins; });
+    write_column<uint32_t>(out, rows, [&](int p1, int p2) { return m[p1][p2].p2_wins; });
+    write_column<uint32_t>(out, rows, [&](int p1, int p2) { return m[p1][p2].rounds; });
+    write_column<uint64_t>(out, rows, [&](int p1, int p2) { return m[p1][p2].frames; });
+    write_column<uint64_t>(out, rows, [&](int p1, int p2) { return m[p1][p2].input_runs; });
+    return out.good();
+}
+
+bool ReplayArchiveStats::load(ReplayArchiveStatsResult& result, const std::string& path) {
+    memset(&result, 0, sizeof(result));
+    std::ifstream in(path, std::ios::binary);
+    char magic[4];
+    uint32_t version = 0;
+    uint32_t row_count = 0;
+    in.read(magic, 4);
+    in.read((char*)&version, 4);
+    in.read((char*)&row_count, 4);
+    if (!in || memcmp(magic, REPLAY_ARCHIVE_STATS_MAGIC, 4) != 0 || version != REPLAY_ARCHIVE_STATS_VERSION) {
+        return false;
+    }
+    std::vector<uint8_t> p1_toon, p2_toon;
+    std::vector<uint32_t> games, p1_wins, p2_wins, rounds;
+    std::vector<uint64_t> frames, input_runs;
+    if (!read_column(in, p1_toon, row_count) || !read_column(in, p2_toon, row_count)
+        || !read_column(in, games, row_count) || !read_column(in, p1_wins, row_count)
+        || !read_column(in, p2_wins, row_count) || !read_column(in, rounds, row_count)
+        || !read_column(in, frames, row_count) || !read_column(in, input_runs, row_count)) {
+        return false;
+    }
+    for (uint32_t i = 0; i < row_count; i++) {
+        if (p1_toon[i] >= REPLAY_ARCHIVE_STATS_TOONS || p2_toon[i] >= REPLAY_ARCHIVE_STATS_TOONS) {
+            continue;
+        }
+        MatchupStats& stats = result.matchups[p1_toon[i]][p2_toon[i]];
+        stats.games = games[i];
+        stats.p1_wins = p1_wins[i];
+        stats.p2_wins = p2_wins[i];
+        stats.rounds = rounds[i];
+        stats.frames = frames[i];
+        stats.input_runs = input_runs[i];
+        result.replays += games[i];
+    }
+    return true;
+}
+
+std::vector<double> ReplayArchiveStats::measure_scaling(const std::string& folder, int max_threads, ReplayArchiveProgress* progress) {
+    std::vector<double> seconds;
+    std::unique_ptr<ReplayArchiveStatsResult> result(new ReplayArchiveStatsResult());
+    if (progress) {
+        progress->done = 0;
+        progress->total = 1 + max_threads * REPLAY_ARCHIVE_SCALING_PASSES;
+    }
+    //untimed pass first, otherwise 1 thread reads the files from disk and every count after it from the OS cache
+    if (!build(folder, max_threads, *result)) {
+        return seconds;
+    }
+    if (progress) {
+        progress->done++;
+    }
+    for (int threads = 1; threads <= max_threads; threads++) {
+        double best = 0;
+        for (int pass = 0; pass < REPLAY_ARCHIVE_SCALING_PASSES; pass++) {
+            if (!build(folder, threads, *result)) {
+                return seconds;
+            }
+            if (pass == 0 || result->seconds < best) {
+                best = result->seconds;
+            }
+            if (progress) {
+                progress->done++;
+            }
+        }
+        seconds.push_back(best);
+    }
+    return seconds;
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <stdint.h>
+#include <atomic>
+#include <vector>
+#include <string>
+#define REPLAY_ARCHIVE_STATS_PATH "./Save/Replay/archive_stats.dat"
+#define REPLAY_ARCHIVE_STATS_VERSION 1
+#define REPLAY_ARCHIVE_STATS_TOONS 0x25 // check_file_validity accepts toons 0 to 0x24
+#define REPLAY_ARCHIVE_STATS_MAX_THREADS 16
+#define REPLAY_ARCHIVE_SCALING_PASSES 3 // timed builds per thread count, the fastest one is kept
+
+struct MatchupStats {
+	uint32_t games;
+	uint32_t p1_wins;
+	uint32_t p2_wins;
+	uint32_t rounds;
+	uint64_t frames; // both players, so twice the game length
+	uint64_t input_runs; // (input, count) pairs, how often the held input changed
+
+	double get_input_density() const { return frames ? input_runs * 60.0 / frames : 0; } // input changes per second per player
+};
+
+struct ReplayArchiveStatsResult {
+	int threads;
+	int replays;
+	int invalid;
+	double seconds;
+	MatchupStats matchups[REPLAY_ARCHIVE_STATS_TOONS][REPLAY_ARCHIVE_STATS_TOONS]; // [p1_toon][p2_toon]
+};
+
+struct ReplayArchiveProgress {
+	std::atomic<int> done;
+	std::atomic<int> total; // 0 until the amount of work is known
+
+	ReplayArchiveProgress() : done(0), total(0) {}
+};
+
+/*
+	Walks the replay archive on a pool of worker threads, validating each header and decoding its inputs
+	into per matchup aggregates. Files are handed out through a shared atomic cursor so a thread that
+	finishes early keeps pulling work until the whole list is done, each thread aggregates on its own
+	and the results are merged at the end.
+
+	The result is saved as columns (all p1 toons, then all p2 toons, then all game counts, ...) of the
+	matchups that have at least one game:
+	header: magic "RAST", uint32 version, uint32 row_count
+	columns: uint8 p1_toon[], uint8 p2_toon[], uint32 games[], uint32 p1_wins[], uint32 p2_wins[], uint32 rounds[], uint64 frames[], uint64 input_runs[]
+*/
+class ReplayArchiveStats {
+public:
+	static bool build(const std::string& folder, int threads, ReplayArchiveStatsResult& result, ReplayArchiveProgress* progress = nullptr); // progress counts files
+	static bool save(const ReplayArchiveStatsResult& result, const std::string& path = REPLAY_ARCHIVE_STATS_PATH);
+	static bool load(ReplayArchiveStatsResult& result, const std::string& path = REPLAY_ARCHIVE_STATS_PATH);
+	static std::vector<double> measure_scaling(const std::string& folder, int max_threads, ReplayArchiveProgress* progress = nullptr); // seconds taken with 1..max_threads threads, progress counts builds
+	static int get_default_thread_count();
+};
@@ -4,7 +4,6 @@
 #include <iostream>
 #include <fstream>
 #include <vector>
-#include <regex>
 #include <experimental/filesystem>
 #include "Game/characters.h"
 #include "Game/ScenesManager/ScenesManager.h"
@@ -14,6 +13,9 @@
 #include <atlstr.h>
 #include <Web/url_downloader.h>
 #include "ReplayList.h"
+#include "ReplayArchiveIndex.h"
+#include "MappedReplayFile.h"
+#include <chrono>
 
 //#define REPLAY_FILE_SIZE 65536
 //#define REPLAY_FOLDER_PATH "./Save/Replay/"
@@ -77,14 +79,9 @@ void replace_all(
                 fpath += ".dat";
             }
    
-            std::streampos fileSize;
-            std::ifstream file(fpath, std::ios::binary);
-            if (file.good()) {
-                file.seekg(0, std::ios::end);
-                fileSize = file.tellg();
-                file.seekg(0, std::ios::beg);
-
-                file.read((char*)&replay_file, fileSize);
+            MappedReplayFile file(fpath);
+            if (file.is_open()) {
+                file.copy_to(&replay_file, sizeof(replay_file));
                 isLoaded = true;
                 return true;
             }
@@ -101,9 +98,9 @@ void replace_all(
         if (buffer == NULL)
             buffer = (ReplayFile*)(GetBbcfBaseAdress() + 0x115b470 + 0x54ed8); // base->static_CBattleReplayDataManager.replay_buffer;
 
-        std::ifstream file(full_path, std::ios::binary);
-        if (file.good()) {
-            file.read((char*)buffer, REPLAY_FILE_SIZE);
+        MappedReplayFile file(full_path);
+        if (file.is_open()) {
+            file.copy_to(buffer, REPLAY_FILE_SIZE);
             return true;
         }
         return false;
@@ -207,32 +204,31 @@ void replace_all(
         if (out.is_open()) {
             out.write((char*)replay_file, REPLAY_FILE_SIZE);
             out.close();
+            g_replay_archive_index.add(new_fname, replay_file);
             return true;
         }
         return false;
     }
 
+    static bool is_replay_slot_filename(const std::string& filename) {
+        // replayNN.dat
+        return filename.size() == 12 && filename.compare(0, 6, "replay") == 0
+            && isdigit((unsigned char)filename[6]) && isdigit((unsigned char)filename[7])
+            && filename.compare(8, 4, ".dat") == 0;
+    }
+
 	void ReplayFileManager::archive_replays() {
         std::vector<std::string> replay_paths;
         for (const auto& entry : std::experimental::filesystem::directory_iterator(REPLAY_FOLDER_PATH)) {
-            std::string path = std::string(entry.path().string());
-            
-            std::regex r(".+(replay\\d\\d.dat)");
-            std::smatch m;
-            std::regex_search(path, m, r);
-            if (m[1].str() != "") {
-                replay_paths.push_back(m[1].str());
-                auto tst = m[1].str();
+            std::string filename = entry.path().filename().string();
+            if (is_replay_slot_filename(filename)) {
+                replay_paths.push_back(filename);
             }
-         
         }
-        std::string replay_archive_folder_path = REPLAY_ARCHIVE_FOLDER_PATH;
-        CreateDirectoryA(REPLAY_ARCHIVE_FOLDER_PATH, NULL);
         for (auto el : replay_paths) {
-            load_replay(el);
-            //load_replay("test.dat");
-            auto new_fname = build_file_name();
-            save_replay(replay_archive_folder_path + new_fname);
+            if (load_replay(el)) {
+                archive_replay(&replay_file);
+            }
         }
 
     }   
@@ -361,56 +357,44 @@ bool ReplayFileManager::check_file_validity(ReplayFile* file) {
     }
     return true;
 }
-void ReplayFileManager::load_replay_list_from_archive(int page) {
-    // load filenames
-    std::vector<std::string> all_filenames;
-    for (const auto& f : std::experimental::filesystem::directory_iterator(REPLAY_ARCHIVE_FOLDER_PATH)) {
-        std::string pp = f.path().filename().string();
-        all_filenames.push_back(pp);
-    }
-        
-    std::sort(all_filenames.begin(), all_filenames.end(), std::greater<std::string>()); // descending filename order means newest to oldest
-
+void ReplayFileManager::load_replay_list_from_archive(int page, int character1, std::string player1, int character2, std::string player2) {
+    // page through the archive index, the replay files themselves are never opened here
     const int page_size = 100;
-    std::vector<std::string> page_filenames = std::vector<std::string>(all_filenames.begin() + max(0, min(page * page_size, all_filenames.size())),
-                                                                        all_filenames.begin() + max(0, min((page + 1) * page_size, all_filenames.size())));
+    std::vector<ReplayArchiveRecord*> page_records = g_replay_archive_index.query(page, page_size, character1, player1, character2, player2);
 
     // overwrite replay list
     char* base = GetBbcfBaseAdress();
     ReplayList* replay_list = (ReplayList*)(base + 0xAA9808);
     char* replay_file_template = base + 0x4AA66C;
 
-    CreateDirectory(L"./Save/Replay/tmp/", NULL); // the 100 visible files will be copied into a new dir
+    CreateDirectory(L"./Save/Replay/tmp/", NULL); // the 100 visible files will be linked into a new dir
     WriteToProtectedMemory((uintptr_t)replay_file_template, "tmp/rp%02d.dat", 15);
     template_modified = true;
 
-    int n = page_filenames.size();
+    // the game reads the page by template name, give it hard links to the archived files instead of copies.
+    // both live under Save/Replay/ so they are on the same volume, CopyFile is only the fallback (e.g. FAT32)
+    auto start = std::chrono::steady_clock::now();
+    int n = page_records.size();
     int j = 0;
     int valid_replay_count = 0;
     for (; j < n; j++) {
-        
-  
-        //std::filesystem::copy_file(std::filesystem::path(replay_dir + "/" + page_filenames[j]), std::filesystem::path(new_name)); // crashes?
-        // copy file with basic C++
-        std::ifstream f(REPLAY_ARCHIVE_FOLDER_PATH + page_filenames[j], std::ios::binary);
-
-
-        f.seekg(8, std::ios_base::beg);
-        f.read((char*)&replay_list->replays[valid_replay_count], 0x390);
-
-        if (check_file_validity( (replay_list->replays[valid_replay_count].data()) )) {
-            //only copy the file to tmp if it's valid
-            std::string new_name = std::to_string(valid_replay_count);
-            new_name = "Save/Replay/tmp/rp" + std::string(2 - min(2, new_name.length()), '0') + new_name + ".dat";
-            f.seekg(0, std::ios_base::beg);
-            std::ofstream dest(new_name, std::ios::binary);
-            dest << f.rdbuf();
-            dest.close();
-            valid_replay_count += 1;
+        if (!check_file_validity(page_records[j]->data())) {
+            continue;
+        }
+        //only link the file to tmp if it's valid
+        std::string src_name = REPLAY_ARCHIVE_FOLDER_PATH + std::string(page_records[j]->filename);
+        std::string new_name = std::to_string(valid_replay_count);
+        new_name = "Save/Replay/tmp/rp" + std::string(2 - min(2, new_name.length()), '0') + new_name + ".dat";
+        DeleteFileA(new_name.c_str());
+        if (!CreateHardLinkA(new_name.c_str(), src_name.c_str(), NULL)
+            && !CopyFileA(src_name.c_str(), new_name.c_str(), FALSE)) {
+            continue;
         }
-        f.close();
+        memcpy(&replay_list->replays[valid_replay_count], &page_records[j]->header, 0x390);
+        valid_replay_count += 1;
         //replay_list->order[j] = n - 1 - j; // set order, most recent replay first
     }
+    last_page_build_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
     // if we have less than 100 replays, hide the rest
     for (; valid_replay_count < 100; valid_replay_count++) {
         replay_list->replays[valid_replay_count].data()->valid = 0;
@@ -29,11 +29,12 @@ public:
 	void archive_replays();
 
 	bool template_modified = false;
+	long long last_page_build_us = 0; // how long linking the last archive page into tmp/ took
 	
 	void bbcf_sort_replay_list();
 	void load_replay_list_default();
 	void load_replay_list_default_repair();
-	void load_replay_list_from_archive(int page);
+	void load_replay_list_from_archive(int page, int character1 = -1, std::string player1 = "", int character2 = -1, std::string player2 = "");
 	void load_replay_list_from_db(int page, int character1 = -1, std::string player1 = "", int character2 = -1, std::string player2 = "");
 
 	int get_selected_replay_index();
@@ -0,0 +1,111 @@
+#include "ReplayInputCodec.h"
+#include <cstring>
+
+static inline void write_pair(uint8_t* out, uint16_t input, uint16_t count) {
+    out[0] = (uint8_t)(input & 0xFF);
+    out[1] = (uint8_t)(input >> 8);
+    out[2] = (uint8_t)(count & 0xFF);
+    out[3] = (uint8_t)(count >> 8);
+}
+
+const ReplayInputChunk* ReplayInputs::get_chunk(int round, int player) const {
+    int index = round * 2 + player;
+    if (index < 0 || index >= (int)chunks.size()) {
+        return NULL;
+    }
+    return &chunks[index];
+}
+
+int ReplayInputs::get_round_count() const {
+    //rounds that were never played still get their separators
+    int rounds = (int)chunks.size() / 2;
+    while (rounds > 0 && chunks[rounds * 2 - 2].frames.empty() && chunks[rounds * 2 - 1].frames.empty()) {
+        rounds--;
+    }
+    return rounds;
+}
+
+bool ReplayInputCodec::decode(const uint8_t* stream, size_t size, ReplayInputs& out) {
+    out.chunks.clear();
+    out.chunks.resize(REPLAY_INPUT_MAX_CHUNKS);
+    bool overflow = false;
+    int closed = for_each_run(stream, size, [&](int chunk, uint16_t input, uint16_t count) {
+        if (input == 0) {
+            out.chunks[chunk].separator_count = count;
+            return true;
+        }
+        auto& frames = out.chunks[chunk].frames;
+        if (frames.size() + count > REPLAY_INPUT_CHUNK_FRAMES) {
+            overflow = true;
+            return false;
+        }
+        frames.insert(frames.end(), count, input);
+        return true;
+    });
+    if (overflow) {
+        return false;
+    }
+    //empty chunks are kept too, their separator counts are part of the stream
+    out.chunks.resize(closed);
+    return true;
+}
+
+bool ReplayInputCodec::decode_to_chunks(const uint8_t* stream, size_t size, uint16_t* out, int max_chunks, int* frame_counts) {
+    memset(out, 0, (size_t)max_chunks * REPLAY_INPUT_CHUNK_SIZE);
+    memset(frame_counts, 0, (size_t)max_chunks * sizeof(int));
+    bool overflow = false;
+    for_each_run(stream, size, [&](int chunk, uint16_t input, uint16_t count) {
+        if (input == 0) {
+            return true;
+        }
+        if (chunk >= max_chunks || frame_counts[chunk] + count > REPLAY_INPUT_CHUNK_FRAMES) {
+            overflow = true;
+            return false;
+        }
+        uint16_t* dst = out + (size_t)chunk * REPLAY_INPUT_CHUNK_FRAMES + frame_counts[chunk];
+        for (uint16_t i = 0; i < count; i++) {
+            dst[i] = input;
+        }
+        frame_counts[chunk] += count;
+        return true;
+    });
+    return !overflow;
+}
+
+bool ReplayInputCodec::encode(const ReplayInputs& in, uint8_t* stream, size_t size) {
+    memset(stream, 0, size);
+    size_t pos = 0;
+    if (in.chunks.size() > REPLAY_INPUT_MAX_CHUNKS) {
+        return false;
+    }
+    for (const ReplayInputChunk& chunk : in.chunks) {
+        size_t i = 0;
+        while (i < chunk.frames.size()) {
+            uint16_t input = chunk.frames[i];
+            size_t run = 1;
+            while (i + run < chunk.frames.size() && chunk.frames[i + run] == input && run < 0xFFFF) {
+                run++;
+            }
+            if (pos + 4 > size) {
+                return false;
+            }
+            write_pair(stream + pos, input, (uint16_t)run);
+            pos += 4;
+            i += run;
+        }
+        if (pos + 4 > size) {
+            return false;
+        }
+        //a (0, 0) separator would read back as the end of the stream
+        write_pair(stream + pos, 0, chunk.separator_count != 0 ? chunk.separator_count : 1);
+        pos += 4;
+    }
+    return true;
+}
+
+bool ReplayInputCodec::decode_file(const uint8_t* replay_file, size_t size, ReplayInputs& out) {
+    if (size < REPLAY_INPUT_STREAM_OFFSET + REPLAY_INPUT_STREAM_SIZE) {
+        return false;
+    }
+    return decode(replay_file + REPLAY_INPUT_STREAM_OFFSET, REPLAY_INPUT_STREAM_SIZE, out);
+}
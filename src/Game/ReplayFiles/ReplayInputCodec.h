@@ -0,0 +1,60 @@
+#pragma once
+#include <stdint.h>
+#include <cstddef>
+#include <vector>
+#define REPLAY_INPUT_STREAM_OFFSET 0x8D0 // ReplayFile::replay_inputs
+#define REPLAY_INPUT_STREAM_SIZE 0xF730
+#define REPLAY_INPUT_CHUNK_SIZE 0x7080 // one round of one player once unpacked, 2 bytes per frame
+#define REPLAY_INPUT_CHUNK_FRAMES (REPLAY_INPUT_CHUNK_SIZE / 2)
+#define REPLAY_INPUT_MAX_CHUNKS 10 // round1 p1, round1 p2, round2 p1, ...
+
+struct ReplayInputChunk {
+	std::vector<uint16_t> frames; // one input per frame, lowest 4 bits numpad direction then a bit per button
+	uint16_t separator_count = 1; // count of the (0, count) pair that closed the chunk, kept so encoding gives back the same stream
+};
+
+struct ReplayInputs {
+	std::vector<ReplayInputChunk> chunks; // every chunk closed by a separator, including the empty ones of rounds never played
+
+	int get_round_count() const; // rounds with inputs, the empty trailing ones aren't counted
+	const ReplayInputChunk* get_chunk(int round, int player) const; // NULL if the replay doesn't have that round
+};
+
+/*
+	Portable codec for the (uint16 input, uint16 count) pairs replays store their inputs as, no game process needed.
+	for_each_run streams the pairs without building anything, decode/decode_to_chunks expand them into per frame inputs
+	(decode_to_chunks gives the same layout the game's unpack_replay_buffer writes) and encode packs them back.
+	A pair with input 0 ends a chunk, 0 is never a real input since neutral is 5.
+	encode(decode(stream)) gives back the same bytes, tools/ReplayCodec checks that over a folder of replays.
+*/
+class ReplayInputCodec {
+public:
+	// callback(int chunk, uint16_t input, uint16_t count) for every pair, input == 0 is the separator closing chunk.
+	// stops early if it returns false, returns how many chunks were closed by a separator
+	template <typename F>
+	static int for_each_run(const uint8_t* stream, size_t size, F callback);
+
+	static bool decode(const uint8_t* stream, size_t size, ReplayInputs& out);
+	static bool decode_to_chunks(const uint8_t* stream, size_t size, uint16_t* out, int max_chunks, int* frame_counts); // out has max_chunks * REPLAY_INPUT_CHUNK_FRAMES entries
+	static bool encode(const ReplayInputs& in, uint8_t* stream, size_t size); // false if it doesn't fit, the rest of the stream is zeroed
+	static bool decode_file(const uint8_t* replay_file, size_t size, ReplayInputs& out); // a whole replay file, REPLAY_FILE_SIZE bytes
+};
+
+template <typename F>
+int ReplayInputCodec::for_each_run(const uint8_t* stream, size_t size, F callback) {
+	int chunk = 0;
+	for (size_t i = 0; i + 4 <= size && chunk < REPLAY_INPUT_MAX_CHUNKS; i += 4) {
+		uint16_t input = (uint16_t)(stream[i] | (stream[i + 1] << 8));
+		uint16_t count = (uint16_t)(stream[i + 2] | (stream[i + 3] << 8));
+		if (input == 0 && count == 0) {
+			break; // zero padding after the last chunk
+		}
+		if (!callback(chunk, input, count)) {
+			break;
+		}
+		if (input == 0) {
+			chunk++;
+		}
+	}
+	return chunk;
+}
@@ -0,0 +1,105 @@
+#include "CheckpointScheduler.h"
+#include <iterator>
+
+CheckpointScheduler::CheckpointScheduler() {
+	min_step = CHECKPOINT_MIN_STEP;
+	memory_budget = (size_t)CHECKPOINT_DEFAULT_MEMORY_BUDGET_MB * 1024 * 1024;
+}
+
+bool CheckpointScheduler::should_save(unsigned int framecount) const {
+	auto it = checkpoints.upper_bound(framecount);
+	if (it == checkpoints.begin()) {
+		return true;
+	}
+	--it;
+	return framecount - it->first >= (unsigned int)min_step;
+}
+
+void CheckpointScheduler::add(unsigned int framecount, int store_index) {
+	checkpoints[framecount] = store_index;
+}
+
+int CheckpointScheduler::find_nearest(unsigned int framecount) const {
+	auto it = checkpoints.upper_bound(framecount);
+	if (it == checkpoints.begin()) {
+		return -1;
+	}
+	--it;
+	return it->second;
+}
+
+unsigned int CheckpointScheduler::get_nearest_frame(unsigned int framecount) const {
+	auto it = checkpoints.upper_bound(framecount);
+	if (it == checkpoints.begin()) {
+		return 0;
+	}
+	--it;
+	return it->first;
+}
+
+int CheckpointScheduler::enforce_budget(SnapshotStore& store, unsigned int current_frame) {
+	//the encoded size only drops once the worker has folded them, so the count comes from the average checkpoint size
+	//and the next save corrects it. Called before a save, the drops queued by the previous one are done by then
+	size_t encoded = store.get_encoded_bytes();
+	int count = store.size();
+	if (encoded <= memory_budget || count == 0) {
+		return 0;
+	}
+	size_t average = encoded / count + 1;
+	int to_drop = (int)((encoded - memory_budget + average - 1) / average);
+	if (to_drop > CHECKPOINT_MAX_DROPS_PER_SAVE) {
+		to_drop = CHECKPOINT_MAX_DROPS_PER_SAVE;
+	}
+
+	int dropped = 0;
+	while (dropped < to_drop && checkpoints.size() > 2) {
+		//score = gap left behind if removed / distance from the current frame, lowest goes
+		auto victim = checkpoints.end();
+		double victim_score = 0;
+		auto prev = checkpoints.begin();
+		for (auto it = std::next(checkpoints.begin()); it != checkpoints.end(); prev = it, ++it) {
+			auto next = std::next(it);
+			unsigned int next_frame = next != checkpoints.end() ? next->first : (it->first > current_frame ? it->first : current_frame);
+			unsigned int distance = it->first > current_frame ? it->first - current_frame : current_frame - it->first;
+			if (distance < (unsigned int)min_step) {
+				continue; //keep what's right around the current frame
+			}
+			double score = (double)(next_frame - prev->first) / (double)(distance + 1);
+			if (victim == checkpoints.end() || score < victim_score) {
+				victim = it;
+				victim_score = score;
+			}
+		}
+		if (victim == checkpoints.end() || !remove(store, victim)) {
+			break;
+		}
+		dropped++;
+	}
+	return dropped;
+}
+
+bool CheckpointScheduler::remove(SnapshotStore& store, std::map<unsigned int, int>::iterator it) {
+	int store_index = it->second;
+	if (!store.remove_async(store_index)) {
+		return false;
+	}
+	checkpoints.erase(it);
+	for (auto& checkpoint : checkpoints) {
+		if (checkpoint.second > store_index) {
+			checkpoint.second -= 1;
+		}
+	}
+	return true;
+}
+
+void CheckpointScheduler::clear() {
+	checkpoints.clear();
+}
+
+int CheckpointScheduler::size() const {
+	return (int)checkpoints.size();
+}
+
+const std::map<unsigned int, int>& CheckpointScheduler::get_checkpoints() const {
+	return checkpoints;
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include "Game/SnapshotApparatus/SnapshotStore.h"
+#include <map>
+
+#define CHECKPOINT_MIN_STEP 30 // densest spacing in frames, what you get right behind the current frame
+#define CHECKPOINT_DEFAULT_MEMORY_BUDGET_MB 64
+#define CHECKPOINT_MAX_DROPS_PER_SAVE 4 // bounds the victim search on the game thread, the folds themselves run on the store's worker
+
+/*
+	Decides when replay rewind saves a checkpoint and which ones to drop once the snapshot store goes over its memory budget.
+	New checkpoints are saved every CHECKPOINT_MIN_STEP frames, when over budget the checkpoint whose removal leaves the
+	smallest gap relative to its distance from the current frame is dropped, so spacing grows the further back you go.
+	The round start checkpoint is never dropped. Only the choice is made here, the store folds the dropped ones on its worker.
+*/
+class CheckpointScheduler {
+public:
+	CheckpointScheduler();
+
+	int min_step;
+	size_t memory_budget; // in bytes, compared against the store's encoded size
+
+	bool should_save(unsigned int framecount) const; // true if there is no checkpoint within min_step frames at or before framecount
+	void add(unsigned int framecount, int store_index);
+	int find_nearest(unsigned int framecount) const; // store index of the latest checkpoint at or before framecount, -1 if none
+	unsigned int get_nearest_frame(unsigned int framecount) const; // framecount of that checkpoint, 0 if none
+	int enforce_budget(SnapshotStore& store, unsigned int current_frame); // queues enough drops for the store to fit, returns how many
+	void clear();
+
+	int size() const;
+	const std::map<unsigned int, int>& get_checkpoints() const;
+
+private:
+	std::map<unsigned int, int> checkpoints; // framecount -> snapshot store index, sorted for O(log n) lookups
+	bool remove(SnapshotStore& store, std::map<unsigned int, int>::iterator it);
+};
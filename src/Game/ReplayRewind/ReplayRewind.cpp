@@ -3,90 +3,42 @@
 #include "Core/interfaces.h"
 #include "Game/gamestates.h"
 #include "Game/CharData.h"
+#include "Core/Settings.h"
+#include <chrono>
+
+#define SEEK_MAX_SIMULATED_FRAMES 3600 // safety cap on the fast forward loop, a minute of gameplay
 
 ReplayRewind::ReplayRewind() {
     rec = false;
     FIRST_CHECKPOINT_FRAME = 0;
-    FRAME_STEP = 540;
+    FRAME_STEP = 180;
     playing = false;
     curr_frame = 0;
     prev_frame;
     rewind_pos = 0;
     round_start_frame = 0;
-    frame_checkpoints = {};
-    frame_checkpoints_clipped = std::vector<unsigned int>{};
     snap_apparatus_replay_rewind = nullptr;
+    last_seek_us = 0;
+    last_seek_checkpoint_frame = 0;
+    last_seek_frames_simulated = 0;
+    last_thin_us = 0;
+    last_thin_dropped = 0;
+    if (Settings::settingsIni.replayRewindMemoryBudgetMB > 0) {
+        checkpoint_scheduler.memory_budget = (size_t)Settings::settingsIni.replayRewindMemoryBudgetMB * 1024 * 1024;
+    }
 
 }
 unsigned int ReplayRewind::count_entities(bool unk_status2) {
     if (!g_interfaces.player1.IsCharDataNullPtr() && !g_interfaces.player2.IsCharDataNullPtr()) {
-        std::vector<int*> entities{};
-        std::vector<CharData**> entities_char_data{};
-        for (int i = 0; i < 252; i++) {
-            entities.push_back((g_gameVals.pEntityList + i));
-            //entities_char_data.push_back((CharData*)(g_gameVals.pEntityList + i));
-        }
-        for (auto entity_ptr : entities) {
-            entities_char_data.push_back((CharData**)entity_ptr);
-        }
-        auto tst = entities_char_data[0];
-        auto r = 0;
-        for (auto entity : entities_char_data) {
-            if ((*entity)->unknownStatus1 != NULL) {
-                if (unk_status2) {
-                    if ((*entity)->unknown_status2 != NULL && (*entity)->unknown_status2 == 2) {
-                        r++;
-                    }
-                }
-                else {
-                    r++;
-                }
-            }
-        }
-        return r;
-        //auto tst = &entities_char_data[0]->frame_count_minus_1;
+        entity_tracker.refresh_active();
+        return unk_status2 ? entity_tracker.get_status2_count() : entity_tracker.get_active_count();
     }
     return 0;
 }
 
-std::vector<int> ReplayRewind::find_nearest_checkpoint(std::vector<unsigned int> frameCount) {
-    //returns a vector with the fist being the nearest pos in the checkpoints for a backwards and the second for the fwd, -1 if not available
-    auto fc = *g_gameVals.pFrameCount;
-    int nearest_back = 9999999;
-    int nearest_back_pos = -1;
-    int nearest_fwd = 9999999;
-    int nearest_fwd_pos = -1;
-    int i = 0;
-    if (frameCount.size() == 0) {
-        static_DAT_of_PTR_on_load_4* DAT_on_load_4_addr = (static_DAT_of_PTR_on_load_4*)(GetBbcfBaseAdress() + 0x612718);
-        SnapshotManager* snap_manager = 0;
-        snap_manager = DAT_on_load_4_addr->ptr_snapshot_manager_mine;
-        auto stru = snap_manager->_saved_states_related_struct;
-        frameCount = std::vector<unsigned int>{};
-        for (int i = 0; (i < 10) && (stru[i]._framecount != 0); i++) {
-            frameCount.push_back(stru[i]._framecount);
-        }
-    }
-    for (auto frameCheckpoint : frameCount) {
-        if ((fc - frameCheckpoint < fc - nearest_back && fc - frameCheckpoint >60)) {
-            nearest_back = frameCheckpoint;
-            nearest_back_pos = i;
-        }
-        if ((frameCheckpoint - fc < nearest_fwd - fc && frameCheckpoint - fc >60)) {
-            nearest_fwd = frameCheckpoint;
-            nearest_fwd_pos = i;
-        }
-
-
-        i++;
-    }
-    if (frameCount.empty()) {
-        return std::vector<int>{-1, -1};
-    }
-    if (frameCount.size() < nearest_back_pos + 1) {
-        nearest_fwd_pos = -1;
-    }
-    return std::vector<int>{nearest_back_pos, nearest_fwd_pos};
+int ReplayRewind::find_nearest_checkpoint(unsigned int target_frame) {
+    //returns the snapshot store index of the latest checkpoint at or before target_frame, -1 if not available
+    return checkpoint_scheduler.find_nearest(target_frame);
 }
 
 void ReplayRewind::OnUpdate() {
@@ -100,8 +52,6 @@ void ReplayRewind::OnUpdate() {
 
     auto bbcf_base_adress = GetBbcfBaseAdress();
     char* ptr_replay_theater_current_frame = bbcf_base_adress + 0x11C0348;
-    std::vector<unsigned int> frame_checkpoints_clipped;
-    frame_checkpoints_clipped = std::vector<unsigned int>{};
 
 
     if (*(bbcf_base_adress + 0x8F7758) == 0) {
@@ -114,6 +64,9 @@ void ReplayRewind::OnUpdate() {
                 g_interfaces.player2.GetData())) {
                 delete snap_apparatus_replay_rewind;
                 snap_apparatus_replay_rewind = new SnapshotApparatus();
+                //the new apparatus has an empty store, the scheduler's frame->index map would point into nothing
+                rewind_pos = 0;
+                checkpoint_scheduler.clear();
             }
             /*if (*g_gameVals.pGameMode == GameMode_ReplayTheater && *g_gameVals.pMatchState == MatchState_Fight) {
                 toggle_unknown2_asm_code();
@@ -127,8 +80,9 @@ void ReplayRewind::OnUpdate() {
                     rec = false;
                     //framestates = {};
                     snap_apparatus_replay_rewind->clear_count();
+                    snap_apparatus_replay_rewind->clear_store();
                     rewind_pos = 0;
-                    frame_checkpoints.clear();
+                    checkpoint_scheduler.clear();
                     //force clear the vectors
                     return;
                 }
@@ -161,14 +115,16 @@ void ReplayRewind::OnUpdate() {
             {
 
                 rewind_pos = 0;
-                frame_checkpoints.clear();
+                checkpoint_scheduler.clear();
                 snap_apparatus_replay_rewind->clear_framecounts();
                 snap_apparatus_replay_rewind->clear_count();
+                snap_apparatus_replay_rewind->clear_store();
                 rec = true;
-                snap_apparatus_replay_rewind->save_snapshot(0);
+                if (snap_apparatus_replay_rewind->save_snapshot_prealloc()) {
+                    checkpoint_scheduler.add(*g_gameVals.pFrameCount, snap_apparatus_replay_rewind->snapshot_store.size() - 1);
+                }
                 FIRST_CHECKPOINT_FRAME = *g_gameVals.pFrameCount;
                 LAST_SAVED_ROUND = *(bbcf_base_adress + 0x11C034C);
-                frame_checkpoints.push_back(*g_gameVals.pFrameCount);
                 prev_frame = *g_gameVals.pFrameCount;
                 p2_to_check = g_interfaces.player2.GetData();
                 p1_to_check = g_interfaces.player1.GetData();
@@ -179,10 +135,11 @@ void ReplayRewind::OnUpdate() {
             if (*g_gameVals.pFrameCount == round_start_frame && *g_gameVals.pMatchState == MatchState_Fight && FIRST_CHECKPOINT_FRAME == 0) {
                 //snap_apparatus_replay_rewind->clear_framecounts();
                 rec = true;
-                snap_apparatus_replay_rewind->save_snapshot(0);
+                if (snap_apparatus_replay_rewind->save_snapshot_prealloc()) {
+                    checkpoint_scheduler.add(*g_gameVals.pFrameCount, snap_apparatus_replay_rewind->snapshot_store.size() - 1);
+                }
                 FIRST_CHECKPOINT_FRAME = *g_gameVals.pFrameCount;
                 LAST_SAVED_ROUND = *(bbcf_base_adress + 0x11C034C);
-                frame_checkpoints.push_back(*g_gameVals.pFrameCount);
                 prev_frame = *g_gameVals.pFrameCount;
 
             }
@@ -200,9 +157,10 @@ void ReplayRewind::OnUpdate() {
                 rec = false;
                 //frames_recorded = 0;
                 rewind_pos = 0;
-                frame_checkpoints.clear();
+                checkpoint_scheduler.clear();
                 snap_apparatus_replay_rewind->clear_framecounts();
                 snap_apparatus_replay_rewind->clear_count();
+                snap_apparatus_replay_rewind->clear_store();
                 round_start_frame = 0;
                 FIRST_CHECKPOINT_FRAME = 0;
             }
@@ -223,22 +181,22 @@ void ReplayRewind::OnUpdate() {
                 
 
 
-                //Here is where the recording is done on the appropriate frames
+                //Here is where the recording is done on the appropriate frames, the scheduler keeps them dense near the current frame and thins older ones to stay in budget
                 if (rec && *g_gameVals.pGameMode == GameMode_ReplayTheater) {
-                    auto save = true;
-                    for (auto saved_frame : frame_checkpoints) {
-                        if (curr_frame == saved_frame) {
-                            save = false;
+                    if (checkpoint_scheduler.should_save(curr_frame)) {
+                        //thin before saving, by now the worker is done with the previous checkpoint so the sizes are settled
+                        auto thin_start = std::chrono::steady_clock::now();
+                        int dropped = checkpoint_scheduler.enforce_budget(snap_apparatus_replay_rewind->snapshot_store, curr_frame);
+                        if (dropped > 0) {
+                            last_thin_dropped = dropped;
+                            last_thin_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - thin_start).count();
+                        }
+                        if (snap_apparatus_replay_rewind->save_snapshot_prealloc()) {
+                            checkpoint_scheduler.add(curr_frame, snap_apparatus_replay_rewind->snapshot_store.size() - 1);
+                            // frames_recorded += 1;
+                            rewind_pos += 1;
+                            prev_frame = curr_frame;
                         }
-                    }
-                    if (((curr_frame - FIRST_CHECKPOINT_FRAME == 0) || (curr_frame - FIRST_CHECKPOINT_FRAME) % FRAME_STEP == 0)
-                        && save == true) {
-
-                        snap_apparatus_replay_rewind->save_snapshot(0);
-                        frame_checkpoints.push_back(*g_gameVals.pFrameCount);
-                        // frames_recorded += 1;
-                        rewind_pos += 1;
-                        prev_frame = curr_frame;
                     }
                 }
 
@@ -249,14 +207,45 @@ void ReplayRewind::OnUpdate() {
 }
 
 void ReplayRewind::rewind_to_nearest() {
-    int pos = ReplayRewind::find_nearest_checkpoint(frame_checkpoints_clipped)[0];
-    if (pos != -1) {
-        auto bbcf_base_adress = GetBbcfBaseAdress();
-        snap_apparatus_replay_rewind->load_snapshot_index(pos);
-
+    //goes back FRAME_STEP frames
+    unsigned int fc = *g_gameVals.pFrameCount;
+    unsigned int target_frame = fc > (unsigned int)FRAME_STEP ? fc - FRAME_STEP : 0;
+    if (seek_to_frame(target_frame)) {
         //starts the replay
-        char* replay_theather_speed = bbcf_base_adress + 0x11C0350;
+        char* replay_theather_speed = GetBbcfBaseAdress() + 0x11C0350;
         *replay_theather_speed = 0;
-        this->rewind_pos = pos;
     }
+}
+
+bool ReplayRewind::seek_to_frame(unsigned int target_frame) {
+    if (snap_apparatus_replay_rewind == nullptr || checkpoint_scheduler.size() == 0) {
+        return false;
+    }
+    auto start = std::chrono::steady_clock::now();
+
+    int pos = ReplayRewind::find_nearest_checkpoint(target_frame);
+    if (pos == -1) {
+        //target is before the round start checkpoint, go to the round start
+        pos = checkpoint_scheduler.get_checkpoints().begin()->second;
+    }
+    if (!snap_apparatus_replay_rewind->load_snapshot_prealloc(pos)) {
+        return false;
+    }
+    this->rewind_pos = pos;
+    last_seek_checkpoint_frame = *g_gameVals.pFrameCount;
+
+    //fast forward from the checkpoint to the exact frame, stops early if the game refuses to step
+    int simulated = 0;
+    while (*g_gameVals.pFrameCount < target_frame && simulated < SEEK_MAX_SIMULATED_FRAMES) {
+        unsigned int frame_before = *g_gameVals.pFrameCount;
+        if (!snap_apparatus_replay_rewind->advance_frame() || *g_gameVals.pFrameCount == frame_before) {
+            break;
+        }
+        simulated++;
+    }
+    last_seek_frames_simulated = simulated;
+    curr_frame = *g_gameVals.pFrameCount;
+
+    last_seek_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    return true;
 }
\ No newline at end of file
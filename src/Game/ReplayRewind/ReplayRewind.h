@@ -1,6 +1,8 @@
 #pragma once
 #include <vector>
 #include "Game/SnapshotApparatus/SnapshotApparatus.h"
+#include "CheckpointScheduler.h"
+#include "Game/ReplayStates/EntityTracker.h"
 
 
 
@@ -10,10 +12,13 @@ public:
     ReplayRewind();
 	void OnUpdate();
     void rewind_to_nearest();
+    bool seek_to_frame(unsigned int target_frame); //restores the nearest checkpoint at or before target_frame then simulates up to it
 	unsigned int count_entities(bool unk_status2);
-	std::vector<int> find_nearest_checkpoint(std::vector<unsigned int>);
+	int find_nearest_checkpoint(unsigned int target_frame);
 
     SnapshotApparatus* snap_apparatus_replay_rewind;
+    CheckpointScheduler checkpoint_scheduler;
+    EntityTracker entity_tracker;
 
 
     int prev_match_state;
@@ -21,7 +26,7 @@ public:
     //static int first_checkpoint = 0;
     int FIRST_CHECKPOINT_FRAME;
     char LAST_SAVED_ROUND;// = *(bbcf_base_adress + 0x11C034C);
-    int FRAME_STEP;
+    int FRAME_STEP; //how far back a rewind goes, the checkpoint spacing itself is up to checkpoint_scheduler
     CharData* p1_to_check;// = g_interfaces.player1.GetData;
     CharData* p2_to_check;// = g_interfaces.player1;
     bool playing;
@@ -30,7 +35,10 @@ public:
     //static int frames_recorded = 0;
     int rewind_pos;
     int round_start_frame;
-    std::vector<unsigned int> frame_checkpoints;
-    std::vector<unsigned int> frame_checkpoints_clipped;
+    long long last_seek_us; //how long the last seek took, restore + fast forward
+    unsigned int last_seek_checkpoint_frame;
+    int last_seek_frames_simulated;
+    long long last_thin_us; //game thread cost of the last enforce_budget that dropped something, the folds are on the store's worker
+    int last_thin_dropped;
 
 };
@@ -0,0 +1,57 @@
+#include "EntityTracker.h"
+#include "Core/interfaces.h"
+#include <cstring>
+
+static inline bool test_bit(const uint32_t* bits, int slot) {
+    return (bits[slot >> 5] >> (slot & 31)) & 1;
+}
+
+static inline void set_bit(uint32_t* bits, int slot) {
+    bits[slot >> 5] |= 1u << (slot & 31);
+}
+
+EntityTracker::EntityTracker() {
+    reset();
+}
+
+void EntityTracker::reset() {
+    memset(active_bits, 0, sizeof(active_bits));
+    active_count = 0;
+    status2_count = 0;
+}
+
+EntityData* EntityTracker::get_entity(int slot) const {
+    return *(EntityData**)(g_gameVals.pEntityList + slot);
+}
+
+void EntityTracker::refresh_active() {
+    memset(active_bits, 0, sizeof(active_bits));
+    active_count = 0;
+    status2_count = 0;
+    if (g_gameVals.pEntityList == NULL) {
+        return;
+    }
+    for (int slot = 0; slot < ENTITY_TRACKER_SLOTS; slot++) {
+        EntityData* entity = get_entity(slot);
+        if (entity == NULL || entity->unknownStatus1 == 0) {
+            continue;
+        }
+        set_bit(active_bits, slot);
+        active_count++;
+        if (entity->unknown_status2 == 2) {
+            status2_count++;
+        }
+    }
+}
+
+bool EntityTracker::is_active(int slot) const {
+    return test_bit(active_bits, slot);
+}
+
+int EntityTracker::get_active_count() const {
+    return active_count;
+}
+
+int EntityTracker::get_status2_count() const {
+    return status2_count;
+}
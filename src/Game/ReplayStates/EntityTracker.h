@@ -0,0 +1,28 @@
+#pragma once
+#include "Game/EntityData.h"
+#include <stdint.h>
+
+#define ENTITY_TRACKER_SLOTS 252 // whole pEntityList, players included
+#define ENTITY_TRACKER_BITMAP_WORDS ((ENTITY_TRACKER_SLOTS + 31) / 32)
+
+/*
+    Keeps which pEntityList slots are active as a bitmap, refresh_active() only reads the status of each slot.
+*/
+class EntityTracker {
+public:
+    EntityTracker();
+
+    void refresh_active();
+    void reset();
+
+    bool is_active(int slot) const;
+    EntityData* get_entity(int slot) const;
+
+    int get_active_count() const;
+    int get_status2_count() const; // active entities with unknown_status2 == 2
+
+private:
+    uint32_t active_bits[ENTITY_TRACKER_BITMAP_WORDS];
+    int active_count;
+    int status2_count;
+};
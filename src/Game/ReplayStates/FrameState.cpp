@@ -3,6 +3,7 @@
 #include "Core/utils.h"
 #include "Game/gamestates.h"
 #include "Psapi.h"
+#include <chrono>
 #include <cstdlib>
 #include <iostream>
 #include <fstream>
@@ -11,7 +12,74 @@
 #include <memory>
 #include "FrameState.h"
 
+EntitySnapshotArena::EntitySnapshotArena() {
+    active_count = 0;
+    last_capture_us = 0;
+}
+
+void EntitySnapshotArena::capture() {
+    auto start = std::chrono::steady_clock::now();
+    tracker.refresh_active();
+    active_count = 0;
+    for (int i = 0; i < FRAME_STATE_ENTITY_SLOTS; i++) {
+        int slot = FRAME_STATE_FIRST_ENTITY_SLOT + i;
+        if (!tracker.is_active(slot)) {
+            continue;
+        }
+        if (active_count == (int)data.size()) {
+            data.emplace_back();
+            addresses.push_back(NULL);
+        }
+        EntityData* entity = tracker.get_entity(slot);
+        memcpy(&data[active_count], entity, sizeof(EntityData));
+        addresses[active_count] = entity;
+        active_count++;
+    }
+    last_capture_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+void EntitySnapshotArena::restore(bool round_start) {
+    if (!round_start) {
+        return;
+    }
+    for (int i = 0; i < active_count; i++) {
+        EntityData* entity = addresses[i];
+        if (entity->enemyChar != NULL) {
+            data[i].enemyChar = entity->enemyChar;
+            memcpy(entity, &data[i], sizeof(EntityData));
+        }
+    }
+    for (int i = 0; i < FRAME_STATE_ENTITY_SLOTS; i++) {
+        int slot = FRAME_STATE_FIRST_ENTITY_SLOT + i;
+        EntityData* entity = tracker.get_entity(slot);
+        if (entity == NULL) {
+            continue;
+        }
+        if (!tracker.is_active(slot) && entity->unknownStatus1 != 0 && entity->enemyChar != NULL) {
+            //wasn't alive when captured, this used to be restored by copying the idle entity back over it
+            entity->unknownStatus1 = 0;
+        }
+        if (entity->unknown_status2 == 2) {
+            ///really need further insight into the unknown status 2
+            entity->unknown_status2 = 0;
+        }
+    }
+}
+
+int EntitySnapshotArena::get_active_count() const {
+    return active_count;
+}
+
+long long EntitySnapshotArena::get_last_capture_us() const {
+    return last_capture_us;
+}
+
 FrameState::FrameState() {
+    entities = std::make_shared<EntitySnapshotArena>();
+    capture();
+}
+
+void FrameState::capture() {
     if (!g_interfaces.player1.IsCharDataNullPtr() && !g_interfaces.player2.IsCharDataNullPtr()) {
         p1 = *g_interfaces.player1.GetData();
         p2 = *g_interfaces.player2.GetData();
@@ -28,31 +96,8 @@ FrameState::FrameState() {
         cam_mystery_vals1 = FrameState::get_camera_mystery_vals1();
         cam_mystery_vals2 = FrameState::get_camera_mystery_vals2();
 
-        //ownedEntites = save_owned_entities();
-        //gets first non player entity adress: 
         //entity data is not actually CharData sized!! they prob share a superclass
-        auto entity_size = 0x2248;
-        //full_entity_list = std::make_shared< std::array<EntityData, 250>>();
-        full_entity_map = std::make_shared<std::map<EntityData*, EntityData>>();
-
-        int* first_entity = *((int**)(g_gameVals.pEntityList + (2)));
-        int* last_entity = *((int**)(g_gameVals.pEntityList + (251)));
-
-        for (int i = 0; i < 250; i++){ 
-            EntityData** entity = (EntityData**)(g_gameVals.pEntityList + (2) + i);
-            (*full_entity_map)[*entity] = **entity;
-            
-            }
-        
-        
-        //memcpy(&(*full_entity_list)[0], first_entity, last_entity - first_entity);
-
-        //secondary_entity_pointers_list = std::array<size_t, 252> {};
-
-       /* int* secondary_entity_pointers_list_start = g_gameVals.pEntityList + 254;
-        memcpy(&secondary_entity_pointers_list[0], secondary_entity_pointers_list_start, 252);*/
-
-
+        entities->capture();
     }
 }
 
@@ -173,28 +218,7 @@ void FrameState::load_frame_state(bool round_start= false) {
         memcpy(ptr_D3CAM_upVector, &(camUpVector[0]), 12);
         *g_gameVals.viewMatrix = viewMatrix;
 
-        // ownedEntites = save_owned_entities();
-        //gets first non player etity adress: 
-        int* first_entity = *((int**)(g_gameVals.pEntityList + (2)));
-        int* last_entity = *((int**)(g_gameVals.pEntityList + (251)));
-        //just say they are from player 1 to stop the check from failing, need to change later
-        if (round_start) {
-            for (auto& entity : *full_entity_map) {
-                if (entity.first != NULL 
-                    /*&& entity.first->unknownStatus1*/ 
-                    && entity.first->enemyChar != NULL
-                    ) {
-                    entity.second.enemyChar = entity.first->enemyChar;
-                    memcpy(entity.first, &entity.second, sizeof(EntityData));
-                }
-                if (entity.first != NULL && entity.first->unknown_status2 == 2) {
-                    ///really need further insight into the unknown status 2
-                    entity.first->unknown_status2 = 0;
-                }
-                //memcpy(entity.first, &entity.second, sizeof(EntityData));
-            }
-            
-        }
+        entities->restore(round_start);
 
     }
 }
\ No newline at end of file
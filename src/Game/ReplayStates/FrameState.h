@@ -4,11 +4,39 @@
 #include "Core/utils.h"
 #include "Game/gamestates.h"
 #include "Game/EntityData.h"
+#include "EntityTracker.h"
 #include <ctime>
 #include <cstdlib>
 #include <array>
 #include <map>
 #include <memory>
+#include <vector>
+#define FRAME_STATE_FIRST_ENTITY_SLOT 2 // pEntityList[0] and [1] are the players, saved separately as p1/p2
+#define FRAME_STATE_ENTITY_SLOTS 250
+
+/*
+    Flat snapshot of the non player entities. Only the active ones are copied, packed at the front of the storage,
+    which grows to the most entities seen active at once instead of holding all FRAME_STATE_ENTITY_SLOTS.
+    Every active entity is copied on each capture: hashing an entity to skip unchanged ones measured several
+    times slower than the memcpy it saved.
+*/
+class EntitySnapshotArena {
+public:
+    EntitySnapshotArena();
+
+    void capture();
+    void restore(bool round_start);
+    int get_active_count() const;
+    long long get_last_capture_us() const;
+
+private:
+    std::vector<EntityData> data; // packed copies of the active entities
+    std::vector<EntityData*> addresses; // live address each packed copy came from
+    EntityTracker tracker; // which slots were active as of the last capture
+    int active_count;
+    long long last_capture_us;
+};
+
 struct ChildEntity {
     uint8_t offset_ownerEntity;
     uint8_t offset_pEntityList;
@@ -20,7 +48,7 @@ public:
     CharData p2;
     //std::map<CharData*, CharData> ownedEntites;
     //std::shared_ptr<std::array<EntityData, 250>> full_entity_list;
-    std::shared_ptr<std::map<EntityData*, EntityData>> full_entity_map;
+    std::shared_ptr<EntitySnapshotArena> entities;
     std::array<size_t, 252> secondary_entity_pointers_list;
     //std::vector<uint8_t> savedpEntityList;
 
@@ -38,6 +66,7 @@ public:
 
 
     FrameState();
+    void capture(); //recaptures into this FrameState, reusing its entity arena
     std::map<CharData*, CharData> save_owned_entities();
 
     void load_frame_state(bool round_start);
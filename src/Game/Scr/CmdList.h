@@ -4,7 +4,8 @@
 #include <vector>
 #include <string>
 #include <algorithm>
-std::vector<unsigned int> size_4{ 23125,
+#include <stdint.h>
+constexpr unsigned int size_4[] = { 23125,
   30057,
   30021,
   30072,
@@ -203,7 +204,7 @@ std::vector<unsigned int> size_4{ 23125,
 	  2005,
 	  2008,
 	  2009 };
-std::vector<unsigned int> size_8{ 9072,
+constexpr unsigned int size_8[] = { 9072,
  4024,
  4025,
  4022,
@@ -879,7 +880,7 @@ std::vector<unsigned int> size_8{ 9072,
 	43,
 	11000
 };
-std::vector<unsigned int> size_12{ 19016,
+constexpr unsigned int size_12[] = { 19016,
   23047,
   22004,
   1063,
@@ -981,7 +982,7 @@ std::vector<unsigned int> size_12{ 19016,
   103,
 	//same
 	3028, 23001, 12054, 29, 4 };
-std::vector<unsigned int> size_16{ 30055,
+constexpr unsigned int size_16[] = { 30055,
   30056,
   1085,
   14018,
@@ -1020,7 +1021,7 @@ std::vector<unsigned int> size_16{ 30055,
   8003 ,
 	///dsd
 	39, 8011, 18 };
-std::vector<unsigned int> size_20{ 12019,
+constexpr unsigned int size_20[] = { 12019,
   32,
   14017,
   30083,
@@ -1042,7 +1043,7 @@ std::vector<unsigned int> size_20{ 12019,
 	7001, 7004, 69 ,
 	//manual
 	41 };
-std::vector<unsigned int> size_24{ 5001,
+constexpr unsigned int size_24[] = { 5001,
   3068,
   9013,
   11058,
@@ -1057,9 +1058,9 @@ std::vector<unsigned int> size_24{ 5001,
   49,
   40,
   30093 };
-std::vector<unsigned int> size_28{ 62, 12041, 12032, 30050, 21009, 30049, 66, 48 };
-std::vector<unsigned int> size_32{ 9012, 11074, 47 };
-std::vector<unsigned int> size_36{ 14074,
+constexpr unsigned int size_28[] = { 62, 12041, 12032, 30050, 21009, 30049, 66, 48 };
+constexpr unsigned int size_32[] = { 9012, 11074, 47 };
+constexpr unsigned int size_36[] = { 14074,
   14071,
   14070,
   14073,
@@ -1094,7 +1095,7 @@ std::vector<unsigned int> size_36{ 14074,
   30090,
 	//same
 	0, 23148, 7000, 7003, 26, 21, 14068, 14069, 14027, 10, 8 };
-std::vector<unsigned int> size_40{ 4021,
+constexpr unsigned int size_40[] = { 4021,
   30001,
   23146,
   14035,
@@ -1116,12 +1117,83 @@ std::vector<unsigned int> size_40{ 4021,
 	12018, 28,
 	//manual
 	2, 4000, 4001, 14001 };
-std::vector<unsigned int> size_44{ 9011, 23155, 21015, 58, 14044, 16000, 16001,/*same*/ 14048 };
-std::vector<unsigned int> size_48{ 23144, 17011, 23183 };
-std::vector<unsigned int> size_52{ 4018, 61 };
-std::vector<unsigned int> size_68{ 23051, 23, 4003, 12045, 70, 13040, 23030 };
-std::vector<unsigned int> size_72{ 7005 };
-std::vector<unsigned int> size_84{ 7007 };
-std::vector<unsigned int> size_88{ 9010, 9009 };
-std::vector<unsigned int> size_132{ 18003 };
-std::vector<unsigned int> size_148{ 18011 };
\ No newline at end of file
+constexpr unsigned int size_44[] = { 9011, 23155, 21015, 58, 14044, 16000, 16001,/*same*/ 14048 };
+constexpr unsigned int size_48[] = { 23144, 17011, 23183 };
+constexpr unsigned int size_52[] = { 4018, 61 };
+constexpr unsigned int size_68[] = { 23051, 23, 4003, 12045, 70, 13040, 23030 };
+constexpr unsigned int size_72[] = { 7005 };
+constexpr unsigned int size_84[] = { 7007 };
+constexpr unsigned int size_88[] = { 9010, 9009 };
+constexpr unsigned int size_132[] = { 18003 };
+constexpr unsigned int size_148[] = { 18011 };
+
+//opcode -> full command size lookup, built at compile time from the lists above so the script walker doesn't have to search them
+#define SCR_CMD_TABLE_SIZE 30094 // highest opcode in the lists + 1
+
+struct ScrCmdSizeTable {
+	uint8_t sizes[SCR_CMD_TABLE_SIZE]; // size in bytes including the opcode itself, 0 if the opcode isn't in any list
+};
+
+template <size_t N>
+constexpr unsigned int max_cmd(const unsigned int (&cmds)[N]) {
+	unsigned int highest = 0;
+	for (size_t i = 0; i < N; i++) {
+		if (cmds[i] > highest) {
+			highest = cmds[i];
+		}
+	}
+	return highest;
+}
+
+constexpr unsigned int higher_cmd(unsigned int a, unsigned int b) {
+	return a > b ? a : b;
+}
+
+template <size_t N, typename... Lists>
+constexpr unsigned int max_cmd(const unsigned int (&cmds)[N], const Lists&... lists) {
+	return higher_cmd(max_cmd(cmds), max_cmd(lists...));
+}
+
+static_assert(max_cmd(size_4, size_8, size_12, size_16, size_20, size_24, size_28, size_32, size_36, size_40, size_44,
+	size_48, size_52, size_68, size_72, size_84, size_88, size_132, size_148) < SCR_CMD_TABLE_SIZE,
+	"an opcode in the lists doesn't fit in the size table, raise SCR_CMD_TABLE_SIZE");
+
+template <size_t N>
+constexpr void add_cmd_sizes(ScrCmdSizeTable& table, const unsigned int (&cmds)[N], uint8_t size) {
+	for (size_t i = 0; i < N; i++) {
+		if (table.sizes[cmds[i]] == 0) { //first list wins, same order the lists used to be searched in
+			table.sizes[cmds[i]] = size;
+		}
+	}
+}
+
+constexpr ScrCmdSizeTable make_cmd_size_table() {
+	ScrCmdSizeTable table{};
+	add_cmd_sizes(table, size_4, 4);
+	add_cmd_sizes(table, size_8, 8);
+	add_cmd_sizes(table, size_12, 12);
+	add_cmd_sizes(table, size_16, 16);
+	add_cmd_sizes(table, size_20, 20);
+	add_cmd_sizes(table, size_24, 24);
+	add_cmd_sizes(table, size_28, 28);
+	add_cmd_sizes(table, size_32, 32);
+	add_cmd_sizes(table, size_36, 36);
+	add_cmd_sizes(table, size_40, 40);
+	add_cmd_sizes(table, size_44, 44);
+	add_cmd_sizes(table, size_48, 48);
+	add_cmd_sizes(table, size_52, 52);
+	add_cmd_sizes(table, size_68, 68);
+	add_cmd_sizes(table, size_72, 72);
+	add_cmd_sizes(table, size_84, 84);
+	add_cmd_sizes(table, size_88, 88);
+	add_cmd_sizes(table, size_132, 132);
+	add_cmd_sizes(table, size_148, 148);
+	return table;
+}
+
+constexpr ScrCmdSizeTable SCR_CMD_SIZES = make_cmd_size_table();
+static_assert(SCR_CMD_SIZES.sizes[23125] == 4 && SCR_CMD_SIZES.sizes[9072] == 8 && SCR_CMD_SIZES.sizes[18011] == 148, "opcode size table out of sync with the lists");
+
+constexpr int get_cmd_size(unsigned int cmd) {
+	return cmd < SCR_CMD_TABLE_SIZE ? SCR_CMD_SIZES.sizes[cmd] : 0;
+}
@@ -0,0 +1,365 @@
+#include "ScrScriptCache.h"
+#include "Game/Jonb/JonbDBReader.h"
+#include "Core/hash.h"
+#include <Windows.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <cstdio>
+#define _SILENCE_EXPERIMENTAL_FILESYSTEM_DEPRECATION_WARNING
+#include <experimental/filesystem>
+#include <fstream>
+#include <unordered_map>
+#include <vector>
+
+ScrScriptCache g_scr_script_cache;
+
+//every plain number in scrState, in file order
+static unsigned int scrState::* const state_fields[] = {
+	&scrState::frames, &scrState::damage, &scrState::atk_type, &scrState::atk_level, &scrState::hitstun,
+	&scrState::blockstun, &scrState::hitstop, &scrState::starter_rating, &scrState::attack_p1, &scrState::attack_p2,
+	&scrState::hit_overhead, &scrState::hit_low, &scrState::hit_air_unblockable, &scrState::fatal_counter,
+};
+
+//hashes the index plus every parsed state body, through the end of the one that starts last
+static bool hash_scr_index(char* index, char* base, const char* end, uint64_t& hash) {
+	int n_funcs;
+	memcpy(&n_funcs, index, 4);
+	if (n_funcs <= 0 || n_funcs > SCR_SCRIPT_CACHE_MAX_FUNCS) {
+		return false;
+	}
+	size_t index_size = 4 + (size_t)n_funcs * 36;
+	int max_offset = 0;
+	for (int i = 0; i < n_funcs - 1; i++) { // same states the parser goes through, the last entry isn't one of them
+		int offset;
+		memcpy(&offset, index + 4 + i * 36 + 32, 4);
+		if (offset > max_offset) {
+			max_offset = offset;
+		}
+	}
+	size_t script_size = max_offset + get_state_size(base + max_offset, end);
+	hash = fnv1a64_words(index, index_size, hash);
+	hash = fnv1a64_words(base, script_size, hash);
+	return true;
+}
+
+uint64_t ScrScriptCache::hash_script(char* bbcf_base_addr, const ScrScriptLocation& location) {
+	uint64_t hash = FNV1A64_OFFSET;
+	if (!hash_scr_index(location.scr_index, location.scr_base, location.scr_end, hash)
+		|| !hash_scr_index(location.ea_scr_index, location.ea_scr_base, location.ea_scr_end, hash)) {
+		return 0;
+	}
+	//the whole jonbin FPAC, index and entries, the parse reads the hitbox counts out of the entries
+	JonbDBIndexHeader* jonb_index_header = JonbDBReader::get_index_header(bbcf_base_addr, location.player_num);
+	if (jonb_index_header != NULL && jonb_index_header->offset_to_first_full_entry <= jonb_index_header->total_size
+		&& jonb_index_header->total_size < SCR_SCRIPT_CACHE_MAX_JONB_SIZE) {
+		hash = fnv1a64_words(jonb_index_header, jonb_index_header->total_size, hash);
+	}
+	else if (jonb_index_header != NULL && jonb_index_header->offset_to_first_full_entry < SCR_SCRIPT_CACHE_MAX_JONB_SIZE) {
+		hash = fnv1a64_words(jonb_index_header, jonb_index_header->offset_to_first_full_entry, hash);
+	}
+	return hash;
+}
+
+std::string ScrScriptCache::get_path(int char_index, uint64_t content_hash) {
+	char filename[64];
+	sprintf_s(filename, sizeof(filename), "%02d_%016llx.scrc", char_index, (unsigned long long)content_hash);
+	return std::string(SCR_SCRIPT_CACHE_FOLDER) + filename;
+}
+
+std::shared_ptr<ScrStateArena> ScrScriptCache::get(char* bbcf_base_addr, int player_num, bool force_parse) {
+	auto start = std::chrono::steady_clock::now();
+	ScrScriptLocation location;
+	if (!locate_scr(bbcf_base_addr, player_num, location)) {
+		return std::make_shared<ScrStateArena>();
+	}
+	uint64_t content_hash = hash_script(bbcf_base_addr, location);
+	if (content_hash == 0) {
+		return std::make_shared<ScrStateArena>();
+	}
+	auto key = std::make_pair(location.char_index, content_hash);
+
+	std::lock_guard<std::mutex> lock(mutex);
+	std::shared_ptr<ScrStateArena> arena;
+	if (!force_parse) {
+		auto cached = entries.find(key);
+		if (cached != entries.end()) {
+			arena = cached->second;
+			arena->rebase(location.scr_base, location.ea_scr_base); // rematches can load the same script at a new address
+			memory_hits++;
+		}
+		else {
+			std::string path = get_path(location.char_index, content_hash);
+			arena = load(path, location.char_index, content_hash, location);
+			if (arena) {
+				disk_hits++;
+				//eviction goes by write time, touching it keeps a script that's still in use
+				std::error_code ec;
+				std::experimental::filesystem::last_write_time(path, std::experimental::filesystem::file_time_type::clock::now(), ec);
+			}
+		}
+	}
+	if (!arena) {
+		arena = parse_scr_uncached(bbcf_base_addr, location);
+		parses++;
+		CreateDirectoryA(SCR_SCRIPT_CACHE_FOLDER, NULL);
+		if (save(*arena, location.char_index, content_hash, get_path(location.char_index, content_hash))) {
+			evict(SCR_SCRIPT_CACHE_MAX_BYTES);
+		}
+	}
+	entries[key] = arena;
+	last_get_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+	return arena;
+}
+
+void ScrScriptCache::clear() {
+	std::lock_guard<std::mutex> lock(mutex);
+	entries.clear();
+}
+
+int ScrScriptCache::get_size() {
+	std::lock_guard<std::mutex> lock(mutex);
+	return (int)entries.size();
+}
+
+void ScrScriptCache::evict(uint64_t max_bytes) {
+	namespace fs = std::experimental::filesystem;
+	struct CacheFile {
+		fs::path path;
+		fs::file_time_type time;
+		uintmax_t size;
+	};
+	std::vector<CacheFile> files;
+	uintmax_t total = 0;
+	std::error_code ec;
+	for (fs::directory_iterator it(SCR_SCRIPT_CACHE_FOLDER, ec); !ec && it != fs::directory_iterator(); it.increment(ec)) {
+		if (it->path().extension() != ".scrc") {
+			continue;
+		}
+		CacheFile file;
+		file.path = it->path();
+		file.size = fs::file_size(file.path, ec);
+		file.time = fs::last_write_time(file.path, ec);
+		if (ec) {
+			ec.clear();
+			continue;
+		}
+		total += file.size;
+		files.push_back(file);
+	}
+	std::sort(files.begin(), files.end(), [](const CacheFile& a, const CacheFile& b) { return a.time < b.time; });
+	for (const CacheFile& file : files) {
+		if (total <= max_bytes) {
+			break;
+		}
+		if (fs::remove(file.path, ec)) {
+			total -= file.size;
+		}
+	}
+}
+
+static void write_u32(std::ofstream& out, uint32_t val) {
+	out.write((const char*)&val, 4);
+}
+
+static void write_track(std::ofstream& out, size_t frame_count, const std::vector<uint8_t>& packed) {
+	write_u32(out, (uint32_t)frame_count);
+	out.write((const char*)packed.data(), (frame_count + 1) / 2);
+}
+
+bool ScrScriptCache::save(const ScrStateArena& arena, int char_index, uint64_t content_hash, const std::string& path) {
+	//EA states first so the EA pairs can refer to them by position
+	std::vector<const scrState*> all_states(arena.ea_states.begin(), arena.ea_states.end());
+	all_states.insert(all_states.end(), arena.states.begin(), arena.states.end());
+	std::unordered_map<const scrState*, uint32_t> state_ids;
+	std::unordered_map<const std::string*, uint32_t> name_ids;
+	std::vector<const std::string*> names;
+	auto name_id = [&](const ScrName& name) {
+		auto it = name_ids.find(name.str);
+		if (it != name_ids.end()) {
+			return it->second;
+		}
+		name_ids[name.str] = (uint32_t)names.size();
+		names.push_back(name.str);
+		return (uint32_t)names.size() - 1;
+	};
+	for (size_t i = 0; i < all_states.size(); i++) {
+		const scrState* state = all_states[i];
+		state_ids[state] = (uint32_t)i;
+		name_id(state->name);
+		for (auto& name : state->whiff_cancel) {
+			name_id(name);
+		}
+		for (auto& name : state->hit_or_block_cancel) {
+			name_id(name);
+		}
+	}
+
+	std::ofstream out(path, std::ios::binary | std::ios::trunc);
+	if (!out.is_open()) {
+		return false;
+	}
+	out.write(SCR_SCRIPT_CACHE_MAGIC, 4);
+	write_u32(out, SCR_SCRIPT_CACHE_VERSION);
+	write_u32(out, (uint32_t)char_index);
+	out.write((const char*)&content_hash, 8);
+	write_u32(out, (uint32_t)names.size());
+	write_u32(out, (uint32_t)arena.ea_states.size());
+	write_u32(out, (uint32_t)arena.states.size());
+	for (auto name : names) {
+		uint8_t len = (uint8_t)min(name->size(), (size_t)255);
+		out.write((const char*)&len, 1);
+		out.write(name->data(), len);
+	}
+	for (size_t i = 0; i < all_states.size(); i++) {
+		const scrState* state = all_states[i];
+		char* base = i < arena.ea_states.size() ? arena.ea_scr_base : arena.scr_base;
+		write_u32(out, name_ids[state->name.str]);
+		write_u32(out, (uint32_t)(state->addr - base));
+		for (auto field : state_fields) {
+			write_u32(out, state->*field);
+		}
+		write_u32(out, (uint32_t)state->whiff_cancel.size());
+		for (auto& name : state->whiff_cancel) {
+			write_u32(out, name_ids[name.str]);
+		}
+		write_u32(out, (uint32_t)state->hit_or_block_cancel.size());
+		for (auto& name : state->hit_or_block_cancel) {
+			write_u32(out, name_ids[name.str]);
+		}
+		write_track(out, state->frame_activity_status.size(), state->frame_activity_status.get_packed());
+		write_track(out, state->frame_invuln_status.size(), state->frame_invuln_status.get_packed());
+		write_u32(out, (uint32_t)state->frame_EA_effect_pairs.size());
+		for (auto& pair : state->frame_EA_effect_pairs) {
+			auto id = state_ids.find(pair.second);
+			write_u32(out, pair.first);
+			write_u32(out, id != state_ids.end() ? id->second : 0xFFFFFFFF);
+		}
+	}
+	return out.good();
+}
+
+//bounds checked reader over the whole file, any short read marks it as failed
+struct ScrCacheReader {
+	const std::vector<char>& data;
+	size_t pos;
+	bool failed;
+
+	ScrCacheReader(const std::vector<char>& data) : data(data), pos(0), failed(false) {}
+	const char* take(size_t size) {
+		if (failed || data.size() - pos < size) {
+			failed = true;
+			return NULL;
+		}
+		const char* ptr = data.data() + pos;
+		pos += size;
+		return ptr;
+	}
+	uint32_t u32() {
+		uint32_t val = 0;
+		const char* ptr = take(4);
+		if (ptr) {
+			memcpy(&val, ptr, 4);
+		}
+		return val;
+	}
+	// two frames to a byte, counted without the + 1 so a count of 0xFFFFFFFF can't wrap around to 0 bytes
+	const char* frames(uint32_t count) {
+		return take((size_t)(count / 2) + (count & 1));
+	}
+};
+
+std::shared_ptr<ScrStateArena> ScrScriptCache::load(const std::string& path, int char_index, uint64_t content_hash, const ScrScriptLocation& location) {
+	std::ifstream in(path, std::ios::binary | std::ios::ate);
+	if (!in.is_open()) {
+		return nullptr;
+	}
+	std::vector<char> data((size_t)in.tellg());
+	in.seekg(0);
+	in.read(data.data(), data.size());
+	if (!in) {
+		return nullptr;
+	}
+
+	ScrCacheReader reader(data);
+	const char* magic = reader.take(4);
+	uint32_t version = reader.u32();
+	uint32_t file_char_index = reader.u32();
+	uint64_t file_hash = 0;
+	const char* hash_ptr = reader.take(8);
+	if (hash_ptr) {
+		memcpy(&file_hash, hash_ptr, 8);
+	}
+	uint32_t name_count = reader.u32();
+	uint32_t ea_state_count = reader.u32();
+	uint32_t state_count = reader.u32();
+	if (reader.failed || memcmp(magic, SCR_SCRIPT_CACHE_MAGIC, 4) != 0 || version != SCR_SCRIPT_CACHE_VERSION
+		|| file_char_index != (uint32_t)char_index || file_hash != content_hash
+		|| name_count > data.size() || ea_state_count + (size_t)state_count > data.size()) {
+		return nullptr;
+	}
+
+	std::shared_ptr<ScrStateArena> arena = std::make_shared<ScrStateArena>();
+	arena->scr_base = location.scr_base;
+	arena->ea_scr_base = location.ea_scr_base;
+	std::vector<ScrName> names;
+	for (uint32_t i = 0; i < name_count && !reader.failed; i++) {
+		const char* len = reader.take(1);
+		const char* chars = len ? reader.take((uint8_t)*len) : NULL;
+		if (chars) {
+			names.push_back(arena->intern(std::string(chars, (uint8_t)*len).c_str()));
+		}
+	}
+	std::vector<scrState*> all_states;
+	for (uint32_t i = 0; i < ea_state_count + state_count; i++) {
+		all_states.push_back(arena->new_state());
+	}
+	auto read_name = [&]() {
+		uint32_t id = reader.u32();
+		if (id >= names.size()) {
+			reader.failed = true;
+			return ScrName();
+		}
+		return names[id];
+	};
+	for (uint32_t i = 0; i < all_states.size() && !reader.failed; i++) {
+		scrState* state = all_states[i];
+		state->name = read_name();
+		state->addr = (i < ea_state_count ? location.ea_scr_base : location.scr_base) + reader.u32();
+		for (auto field : state_fields) {
+			state->*field = reader.u32();
+		}
+		uint32_t whiff_count = reader.u32();
+		for (uint32_t j = 0; j < whiff_count && !reader.failed; j++) {
+			state->whiff_cancel.push_back(read_name());
+		}
+		uint32_t hit_or_block_count = reader.u32();
+		for (uint32_t j = 0; j < hit_or_block_count && !reader.failed; j++) {
+			state->hit_or_block_cancel.push_back(read_name());
+		}
+		uint32_t activity_frames = reader.u32();
+		const char* activity = reader.frames(activity_frames);
+		if (activity) {
+			state->frame_activity_status.assign_packed((const uint8_t*)activity, activity_frames);
+		}
+		uint32_t invuln_frames = reader.u32();
+		const char* invuln = reader.frames(invuln_frames);
+		if (invuln) {
+			state->frame_invuln_status.assign_packed((const uint8_t*)invuln, invuln_frames);
+		}
+		uint32_t pair_count = reader.u32();
+		for (uint32_t j = 0; j < pair_count && !reader.failed; j++) {
+			uint32_t frame = reader.u32();
+			uint32_t id = reader.u32();
+			if (id < all_states.size()) {
+				state->frame_EA_effect_pairs.push_back({ frame, all_states[id] });
+			}
+		}
+	}
+	if (reader.failed) {
+		return nullptr;
+	}
+	arena->ea_states.assign(all_states.begin(), all_states.begin() + ea_state_count);
+	arena->states.assign(all_states.begin() + ea_state_count, all_states.end());
+	return arena;
+}
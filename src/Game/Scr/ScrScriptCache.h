@@ -0,0 +1,52 @@
+#pragma once
+#include "ScrStateArena.h"
+#include "ScrStateReader.h"
+#include <stdint.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#define SCR_SCRIPT_CACHE_FOLDER "BBCF_IM\\ScrCache\\"
+#define SCR_SCRIPT_CACHE_MAGIC "SCRC"
+#define SCR_SCRIPT_CACHE_VERSION 2 // bump whenever parse_state changes what it pulls out of a script, old files are then ignored
+#define SCR_SCRIPT_CACHE_MAX_FUNCS 0x10000 // sanity bound on an index's function count before hashing it
+#define SCR_SCRIPT_CACHE_MAX_JONB_SIZE 0x4000000 // same for the jonbin FPAC size
+#define SCR_SCRIPT_CACHE_MAX_BYTES (32 * 1024 * 1024) // the folder is trimmed to this after every save, least recently used files go first
+
+/*
+	Parsed scripts keyed by (charIndex, content hash). The hash covers the script and EA indexes, the script bodies
+	through the end of the last state and the whole jonbin FPAC, so a modded script or hitbox file gets parsed on its own.
+	Both players and every caller share the same arena, it's kept in memory for the whole session and saved to
+	SCR_SCRIPT_CACHE_FOLDER so the first load of a character in a later session skips the parse as well. A load from
+	disk touches the file and every save trims the folder back under SCR_SCRIPT_CACHE_MAX_BYTES, oldest files first.
+
+	File: magic "SCRC", uint32 version, int32 char_index, uint64 content_hash, uint32 name_count, uint32 ea_state_count, uint32 state_count
+	names: uint8 length, chars
+	states, EA ones first: uint32 name, uint32 addr offset from its script base, uint32 fields (see state_fields), uint32 count + uint32 names
+	for both cancel lists, uint32 frame_count + packed bytes for activity and invuln, uint32 count + (uint32 frame, uint32 state) EA pairs
+*/
+class ScrScriptCache {
+public:
+	std::shared_ptr<ScrStateArena> get(char* bbcf_base_addr, int player_num, bool force_parse = false); // force_parse replaces whatever was cached for that script
+	void clear(); // memory only, the files stay
+
+	int get_size();
+	int memory_hits = 0;
+	int disk_hits = 0;
+	int parses = 0;
+	long long last_get_us = 0;
+
+	static uint64_t hash_script(char* bbcf_base_addr, const ScrScriptLocation& location);
+	static std::string get_path(int char_index, uint64_t content_hash);
+	static bool save(const ScrStateArena& arena, int char_index, uint64_t content_hash, const std::string& path);
+	static std::shared_ptr<ScrStateArena> load(const std::string& path, int char_index, uint64_t content_hash, const ScrScriptLocation& location);
+	static void evict(uint64_t max_bytes); // deletes the least recently used files until the folder fits in max_bytes
+
+private:
+	std::mutex mutex;
+	std::map<std::pair<int, uint64_t>, std::shared_ptr<ScrStateArena> > entries;
+};
+
+extern ScrScriptCache g_scr_script_cache;
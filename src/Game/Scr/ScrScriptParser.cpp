@@ -0,0 +1,432 @@
+#include "ScrScriptParser.h"
+#include "CmdList.h"
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+
+static bool is_index_in_bounds(char* index, int n_funcs, const char* end) {
+	if (end == NULL) {
+		return true;
+	}
+	return n_funcs >= 0 && end - index >= 4 && (size_t)n_funcs <= (size_t)(end - index - 4) / 36;
+}
+
+bool locate_scr_blob(char* scr, size_t scr_size, char* ea_scr, size_t ea_scr_size, ScrScriptLocation& location) {
+	//dumps taken straight from memory still have the FPAC header in front of the index
+	if (scr_size >= OFFSET_FROM_FPAC && memcmp(scr, "FPAC", 4) == 0) {
+		scr += OFFSET_FROM_FPAC;
+		scr_size -= OFFSET_FROM_FPAC;
+	}
+	if (scr_size < 4 || ea_scr_size < 4) {
+		return false;
+	}
+	int n_funcs;
+	int ea_n_funcs;
+	memcpy(&n_funcs, scr, 4);
+	memcpy(&ea_n_funcs, ea_scr, 4);
+	if (!is_index_in_bounds(scr, n_funcs, scr + scr_size) || !is_index_in_bounds(ea_scr, ea_n_funcs, ea_scr + ea_scr_size)) {
+		return false;
+	}
+	location.player_num = 0;
+	location.char_index = -1;
+	location.scr_index = scr;
+	location.scr_base = scr + 4 + n_funcs * 36;
+	location.scr_end = scr + scr_size;
+	location.ea_scr_index = ea_scr;
+	location.ea_scr_base = ea_scr + 4 + ea_n_funcs * 36;
+	location.ea_scr_end = ea_scr + ea_scr_size;
+	return true;
+}
+
+std::shared_ptr<ScrStateArena> parse_scr_script(const ScrScriptLocation& location, const JonbDB* jonb_db, ScrParseReport* report) {
+	std::shared_ptr<ScrStateArena> arena = std::make_shared<ScrStateArena>();
+	char* scr_index = location.scr_index;
+	char* ea_scr_index = location.ea_scr_index;
+	arena->scr_base = location.scr_base;
+	arena->ea_scr_base = location.ea_scr_base;
+
+	std::vector<scrState*>& states_parsed = arena->states;
+	std::vector<scrState*>& ea_states_parsed = arena->ea_states;
+	/*doing the EA before the main states*/
+	std::map<std::string, scrState*> ea_state_map = {};  //ea_sstate_map to reference in the main state parsing. This way recursive ea_states(ea states called from ea state) won't work, I need to find a better way later.
+	int ea_n_funcs;
+	int ea_func_num = 0;
+	int ea_i = 0;
+	memcpy(&ea_n_funcs, ea_scr_index, 4);
+	ea_i += 4;
+	if (!is_index_in_bounds(ea_scr_index, ea_n_funcs, location.ea_scr_end)) {
+		return arena;
+	}
+	while (ea_func_num < ea_n_funcs - 1) {
+		char ea_name_index[32];
+		int ea_pos_before_offset;
+		memcpy(ea_name_index, ea_scr_index + ea_i, 32);
+		ea_i += 32;
+		memcpy(&ea_pos_before_offset, ea_scr_index + ea_i, 4);
+		ea_i += 4;
+
+		char* ea_addr = (location.ea_scr_base + ea_pos_before_offset);
+		if (location.ea_scr_end != NULL && ea_pos_before_offset < 0) {
+			ea_func_num += 1;
+			continue;
+		}
+		parse_state(ea_addr, location.ea_scr_end, *arena, ea_states_parsed, jonb_db, &ea_state_map, report);
+		ea_func_num += 1;
+	}
+
+	//builds ea_state_map to reference in the main state parsing.
+	for (auto& state : ea_states_parsed) {
+		ea_state_map[state->name.get()] = state;
+	}
+
+	/*ending the EA*/
+
+		int n_funcs;
+		int func_num = 0;
+		int i = 0;
+		memcpy(&n_funcs, scr_index, 4);
+		i += 4;
+		if (!is_index_in_bounds(scr_index, n_funcs, location.scr_end)) {
+			return arena;
+		}
+		while (func_num < n_funcs - 1) {
+			char name_index[32];
+			int pos_before_offset;
+			memcpy(name_index, scr_index + i, 32);
+			i += 32;
+			memcpy(&pos_before_offset, scr_index + i, 4);
+			i += 4;
+
+			char* addr = (location.scr_base + pos_before_offset);
+			if (location.scr_end != NULL && pos_before_offset < 0) {
+				func_num += 1;
+				continue;
+			}
+			parse_state(addr, location.scr_end, *arena, states_parsed, jonb_db, &ea_state_map, report);
+			func_num += 1;
+		}
+
+
+
+	//states_parsed.insert(states_parsed.end(), ea_states_parsed.begin(), ea_states_parsed.end());
+		
+	return arena;
+}
+static bool is_sprite_active_frame(char* name_addr, const JonbDB* jonb_db) {
+	if (name_addr == nullptr || jonb_db == nullptr) { return false; }
+	const JonbDBSprite* sprite = jonb_db->find(name_addr); //the sprite command's string[32] is the jonbin name
+	return sprite != NULL && sprite->hitbox_count > 0;
+}
+
+int parse_state(char* addr, 
+				const char* end,
+				ScrStateArena& arena,
+				std::vector<scrState*>& states_parsed, 
+				const JonbDB* jonb_db, 
+				std::map<std::string, scrState*>* ea_state_map,
+				ScrParseReport* report,
+				unsigned int* state_size) {
+	if (end != NULL && addr + 40 > end) {
+		if (report) {
+			report->truncated_states++;
+		}
+		if (state_size) {
+			*state_size = 0;
+		}
+		return 1;
+	}
+	scrState* s = arena.new_state();
+
+	s->addr = addr;
+	uint32_t CMD;
+	unsigned int offset = 0;
+	unsigned int prev_frames = 0; //saving the frames before the call to sprite, because functions that apply to those begin at the start of the sprite(), not at the end, such as invuln frames and spawning EA effects
+	//memcpy(&s->name, addr + offset, 32);
+	offset += 4;
+	s->name = arena.intern(addr + offset);
+	//cout << s->name << endl;
+	offset += 32;
+	memcpy(&CMD, addr + offset, 4);
+
+	//CMD = *(addr + offset);
+	offset += 4;
+	FrameInvuln invuln = FrameInvuln::None; //flag to turn on/off invuln windows
+	//int iter = 0;
+	//PS: I may have been calling uint32 char for some reason here, not sure why tbh, gotta double check before changing the comments
+	while (CMD != 0x1) {
+		///remember to check for the configuration of defaults, 17000 up to 17006
+		if (CMD == 0x2) {
+			///sprite call(string[32],char) name of sprite and frames
+			//if (s->name == "NmlAtk5B") {
+			//	auto tsts = 1;
+			//	std::string cmd_str32(addr + offset);
+			//}
+			bool is_active = is_sprite_active_frame(addr + offset, jonb_db);//there's some weirdness on some moves, such as izayoi's "CmdActFDash", showing hitboxes when there shouldn't be
+			offset += 32;
+			//unsigned int frames;
+			uint32_t frames;
+			/////memcpy(&frames, addr + offset, 4);
+			frames = *(addr + offset);
+			FrameActivity activity_status = is_active? FrameActivity::Active: FrameActivity::Inactive;
+			offset += 4;
+			prev_frames = s->frames;
+			s->frames += frames;
+			for (uint32_t i = 0; i < frames;  i++) {
+				//if (frames == 32767){
+				if (frames == 0xffffffff || frames == 32767) {
+					s->frame_activity_status.push_back((FrameActivity)(0x10 | (uint16_t)activity_status));
+					s->frame_invuln_status.push_back(invuln);
+					break;
+				}
+				s->frame_activity_status.push_back(activity_status);
+				//sets the invuln
+				s->frame_invuln_status.push_back(invuln);
+				if (i > 100) {/*I still don't know why some sprites have absurdly long durations(well, actually is -1), such as jin's and izayoi's 6B, don't think its a parsing issue tbh*/
+					break;
+				}
+			}
+		}
+		else if (CMD == 4000) {
+			//EA state call(string[32],char); name of EA state and position
+			if (!ea_state_map->empty()) {
+				std::string cmd_str32(addr + offset);
+				auto match = ea_state_map->find(cmd_str32); //try to find the string[32] of the command in the map
+				if (match != ea_state_map->end()) { //safety check
+					scrState* entry = ea_state_map->at(cmd_str32);
+					s->frame_EA_effect_pairs.push_back({ prev_frames, entry });
+				}
+			}
+			offset += 32;
+			//offsets the position
+			offset += 4;
+		}
+		else if (CMD == 22007) {
+			//setInvincible call(char); 0 if not set invincible, 1 if set. If CMD 22019 doesnt appear later assume full invincibility
+			uint32_t argument = *(uint32_t*)(addr + offset);
+			if (argument == 1) {//when invuln is turned on/off I need to retroactively remove the last sprite length added, since it applies its effect to the start, not end of the sprite
+				invuln = FrameInvuln::All;
+				for (unsigned int i = prev_frames; i < s->frames; i++) {
+					s->frame_invuln_status.set(i, invuln);
+				}
+			}
+			else {
+				//when invuln is turned on/off I need to retroactively remove the last sprite length added, since it applies its effect to the start, not end of the sprite
+				invuln = FrameInvuln::None;
+				for (unsigned int i = prev_frames; i < s->frames; i++) {
+					s->frame_invuln_status.set(i, invuln);
+				}
+			}
+			
+			offset += 4;
+		}
+		else if (CMD == 22019) {
+			//setInvincibleArgs call(char,char,char,char,char); they are equivalent to the flags for each property, head, body, leg, approach, throw. 0 for not set 1 for set.
+			uint16_t head = *(uint32_t*)(addr + offset) * (uint16_t)FrameInvuln::Head;
+			offset += 4;
+			uint16_t body = *(uint32_t*)(addr + offset) * (uint16_t)FrameInvuln::Body;
+			offset += 4;
+			uint16_t leg = *(uint32_t*)(addr + offset) * (uint16_t)FrameInvuln::Foot;
+			offset += 4;
+			offset += 4; //approach, idk what approach is, I assume its projectile which is not implemented yet
+			uint16_t thro = *(uint32_t*)(addr + offset) * (uint16_t)FrameInvuln::Throw; //thro is throw, throw is a reserved word
+			offset += 4;
+			invuln = (FrameInvuln)(head | body | leg  | thro);// note the missing projectile assumed "approach" since its not implemented yet
+			for (unsigned int i = prev_frames; i < s->frames; i++) {//when invuln is turned on/off I need to retroactively remove the last sprite length added, since it applies its effect to the start, not end of the sprite
+				s->frame_invuln_status.set(i, invuln);
+			}
+
+		}
+		else if (CMD == 2002 || CMD == 23027) {
+			//refreshMultihit(more like disableHitbox)  call() 2002
+			//DisableAttackRestOfMove() call() 23027
+			//this will disable the hitbox of the last sprite, its listed by dantation as startMultihit but its more akin to disablehitbox.
+			for (unsigned int i = prev_frames; i < s->frames; i++) {//when hitbox is disabled I need to retroactively remove the last sprite length added, since it applies its effect to the start, not end of the sprite
+				if (i < s->frame_activity_status.size()) {//need to check due to edge cases where sprites last absurdly long(or are -1)
+				s->frame_activity_status.set(i, FrameActivity::Inactive);
+			}
+				//else {
+				//	auto tst = 1;
+				//}
+			}
+		}
+		//still need to get the guard point CMD
+		else if (CMD == 9003) {
+			///Damage call(char) set dmg 
+			memcpy(&s->damage, addr + offset, 4);
+			offset += 4;
+		}
+		else if (CMD == 9001) {
+			///Damage call(char) set atk_type
+			//unsigned int atk_type;
+			//atk_type = *(addr + offset);
+			memcpy(&s->atk_type, addr + offset, 4);
+
+			offset += 4;
+			//s->atk_type = atk_type;
+		}
+		else if (CMD == 9002) {
+			///Damage call(char) set atk_level
+			///unsigned int atk_level;
+			//atk_level = *(addr + offset);
+			memcpy(&s->atk_level, addr + offset, 4);
+			offset += 4;
+			//s->atk_level = atk_level;
+		}
+		else if (CMD == 9154) {
+			///hitstun call(char) set hitstun when not tied to atk_level
+			//unsigned int hitstun;
+			//memcpy(&hitstun, addr + offset, 4);
+			memcpy(&s->hitstun, addr + offset, 4);
+			offset += 4;
+			//s->hitstun = hitstun;
+		}
+		else if (CMD == 11000) {
+			///hitstop call(char) set hitstop
+			//unsigned int hitstop;
+			memcpy(&s->hitstop, addr + offset, 4);
+			offset += 4;
+			//s->hitstop = hitstop;
+		}
+		else if (CMD == 9274) {
+			///attack_p1 call(char) set attack_p1
+			unsigned int attack_p1;
+			memcpy(&attack_p1, addr + offset, 4);
+			offset += 4;
+			s->attack_p1 = attack_p1;
+		}
+		else if (CMD == 9286) {
+			///attack_p2 call(char) set attack_p2
+			unsigned int attack_p2;
+			memcpy(&attack_p2, addr + offset, 4);
+			offset += 4;
+			s->attack_p2 = attack_p2;
+		}
+		else if (CMD == 11036) {
+			///hitOverhead call(char) set hitOverhead
+			unsigned int hit_overhead;
+			memcpy(&hit_overhead, addr + offset, 4);
+			offset += 4;
+			s->hit_overhead = hit_overhead;
+		}
+		else if (CMD == 11035) {
+			///hitLow call(char) set hitLow
+			unsigned int hit_low;
+			memcpy(&hit_low, addr + offset, 4);
+			offset += 4;
+			s->hit_low = hit_low;
+		}
+		else if (CMD == 11037) {
+			///HitAirUnblockable call(char) set HitAirUnblockable
+			unsigned int hit_air_unblockable;
+			memcpy(&hit_air_unblockable, addr + offset, 4);
+			offset += 4;
+			s->hit_air_unblockable = hit_air_unblockable;
+		}
+		else if (CMD == 14068) {
+			///whiffCancel call(string[32]) set whiffcancel to moves
+			ScrName whiff_cancel = arena.intern(addr + offset);
+			//memcpy(&whiff_cancel, addr + offset, 4);
+			offset += 32;
+			s->whiff_cancel.push_back(whiff_cancel);
+		}
+		else if (CMD == 14069) {
+			///hit or block cancel call(string[32]) set hit or block cancel to moves
+			ScrName hit_or_block_cancel = arena.intern(addr + offset);
+			//memcpy(&whiff_cancel, addr + offset, 4);
+			offset += 32;
+			s->hit_or_block_cancel.push_back(hit_or_block_cancel);
+		}
+
+		else if (CMD == 11088) {
+			///starter rating call(char) set starter rating
+			memcpy(&s->fatal_counter, addr + offset, 4);
+			offset += 4;
+		}
+		else if (CMD == 12051) {
+			///starter rating call(char) set starter rating
+			unsigned int starter_rating;
+			memcpy(&starter_rating, addr + offset, 4);
+			offset += 4;
+			s->starter_rating = starter_rating;
+		}
+		else if (CMD == 11028) {
+			///blockstun call(char) set blockstun
+			unsigned int blockstun;
+			memcpy(&blockstun, addr + offset, 4);
+			offset += 4;
+			s->blockstun = blockstun;
+		}
+
+		//these are the commands in the script in not interested in using
+		else if (int cmd_size = get_cmd_size(CMD)) {
+			offset += cmd_size - 4;
+		}
+
+
+		else if (CMD == 23030) {
+			//calls private function (string[32], x, x, x, x, x, x, x, x)
+			offset += 32;
+			offset += 4 * 8;
+		}
+
+		else if (CMD == 23183) {
+			///(string[32], x, x, x)
+			offset += 32;
+			offset += 4 * 3;
+		}
+		else if (CMD == 4003) {
+			///(string[32],string[32])
+			offset += 32;
+			offset += 32;
+
+		}
+		else if (CMD == 7006 || CMD == 7007) {
+			///(string[16], x, string[16], x, string[16], x, string[16], x)
+			offset += 16 * 3;
+			offset += 4 * 3;
+		}
+		else if (CMD == 12045) {
+			///(x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x) 
+			offset += 4 * 16;
+		}
+		else {
+			///if (CMD != 7) { 
+
+			if (report) {
+				report->unknown_opcodes.push_back({ s->name.get(), offset, CMD });
+			}
+			else {
+				std::cout << s->name.get() << ":  offset: " << offset << " |  b10:  " << CMD << "| hex:" << std::hex << CMD << std::dec << std::endl;
+			}
+			break;
+			//}; 
+		};
+
+		if (end != NULL && addr + offset + 4 > end) {
+			if (report) {
+				report->truncated_states++;
+			}
+			break;
+		}
+		memcpy(&CMD, addr + offset, 4);
+		//CMD = *(unsigned long*)(addr + offset);
+		offset += 4;
+
+	}
+	states_parsed.push_back(s);
+	if (state_size) {
+		*state_size = offset;
+	}
+	return 0;
+}
+
+unsigned int get_state_size(char* addr, const char* end) {
+	ScrStateArena arena;
+	std::vector<scrState*> states;
+	std::map<std::string, scrState*> ea_state_map;
+	ScrParseReport report; // keeps unknown opcodes off stdout
+	unsigned int size = 0;
+	parse_state(addr, end, arena, states, NULL, &ea_state_map, &report, &size);
+	return size;
+}
+
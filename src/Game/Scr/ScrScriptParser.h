@@ -0,0 +1,44 @@
+#pragma once
+#include <stdint.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Game/Jonb/JonbDB.h"
+#include "ScrStateArena.h"
+
+/*
+	The script parser itself, it only ever sees pointers into a script so it runs the same over the game's
+	memory (ScrStateReader finds those) or over a dumped file. Nothing in here touches the game.
+*/
+
+constexpr auto OFFSET_FROM_FPAC = 0x60;
+#define SCR_PARSE_PADDING 256 // bytes past a script's end that have to stay readable, the last command's arguments are read before the bound is checked
+
+//where a script lives, in game memory or a loaded file
+struct ScrScriptLocation {
+	int player_num; // whose copy is read, P1's when both players are on the same character. 0 for files
+	int char_index;
+	char* scr_index;
+	char* scr_base; // pre_init, the index offsets are relative to it
+	char* ea_scr_index;
+	char* ea_scr_base;
+	char* scr_end = NULL; // only known for files, NULL means unbounded
+	char* ea_scr_end = NULL;
+};
+
+struct ScrUnknownOpcode {
+	std::string state;
+	unsigned int offset; // from the start of the state
+	uint32_t cmd;
+};
+
+struct ScrParseReport {
+	std::vector<ScrUnknownOpcode> unknown_opcodes; // every state the parser gave up on, it keeps what it got up to there
+	int truncated_states = 0; // ran into the end of the file before the end of the state
+};
+
+bool locate_scr_blob(char* scr, size_t scr_size, char* ea_scr, size_t ea_scr_size, ScrScriptLocation& location); // scr_XX.bin and scr_XXea.bin contents, both padded by SCR_PARSE_PADDING
+std::shared_ptr<ScrStateArena> parse_scr_script(const ScrScriptLocation& location, const JonbDB* jonb_db, ScrParseReport* report = NULL); // report NULL logs unknown opcodes to stdout like before
+int parse_state(char* addr, const char* end, ScrStateArena& arena, std::vector<scrState*>& states_parsed, const JonbDB* jonb_db, std::map<std::string, scrState*>* ea_state_map, ScrParseReport* report, unsigned int* state_size = NULL); // state_size gets how many bytes of the state the parser went through
+unsigned int get_state_size(char* addr, const char* end); // bytes parse_state reads of the state at addr, up to the end of its body
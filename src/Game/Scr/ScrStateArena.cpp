@@ -0,0 +1,52 @@
+#include "ScrStateArena.h"
+#include <cstring>
+
+scrState* ScrStateArena::new_state() {
+	storage.emplace_back();
+	return &storage.back();
+}
+
+ScrName ScrStateArena::intern(const char* name) {
+	if (name == NULL) {
+		return ScrName();
+	}
+	size_t len = 0;
+	while (len < 32 && name[len] != 0) {
+		len++;
+	}
+	auto it = names.emplace(name, len).first;
+	return ScrName(&*it);
+}
+
+void ScrStateArena::rebase(char* new_scr_base, char* new_ea_scr_base) {
+	if (new_scr_base == scr_base && new_ea_scr_base == ea_scr_base) {
+		return;
+	}
+	for (auto state : states) {
+		state->addr = new_scr_base + (state->addr - scr_base);
+		state->replaced_state_script[0] = 0; // any override was made on the old copy
+	}
+	for (auto state : ea_states) {
+		state->addr = new_ea_scr_base + (state->addr - ea_scr_base);
+		state->replaced_state_script[0] = 0;
+	}
+	scr_base = new_scr_base;
+	ea_scr_base = new_ea_scr_base;
+}
+
+int ScrStateArena::get_state_count() const {
+	return (int)storage.size();
+}
+
+size_t ScrStateArena::get_memory_usage() const {
+	size_t total = storage.size() * sizeof(scrState);
+	for (auto& state : storage) {
+		total += state.frame_activity_status.get_memory_usage() + state.frame_invuln_status.get_memory_usage();
+		total += (state.whiff_cancel.capacity() + state.hit_or_block_cancel.capacity()) * sizeof(ScrName);
+		total += state.frame_EA_effect_pairs.capacity() * sizeof(std::pair<unsigned int, const scrState*>);
+	}
+	for (auto& name : names) {
+		total += sizeof(std::string) + name.capacity();
+	}
+	return total;
+}
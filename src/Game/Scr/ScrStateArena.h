@@ -0,0 +1,31 @@
+#pragma once
+#include "ScrStateEntry.h"
+#include <deque>
+#include <vector>
+#include <string>
+#include <unordered_set>
+
+/*
+	Owns every scrState parsed from one character's script, main and EA states, plus a pool of interned names
+	(state names and the move names in cancel lists repeat a lot). States are never freed one by one, dropping
+	the arena frees the whole script in one go.
+*/
+class ScrStateArena {
+public:
+	std::vector<scrState*> states; // main states, in script order
+	std::vector<scrState*> ea_states;
+	char* scr_base = NULL; // script memory the states' addr point into, EA states use ea_scr_base
+	char* ea_scr_base = NULL;
+
+	scrState* new_state();
+	ScrName intern(const char* name); // name is read up to its terminator or 32 chars, like the script's string[32]
+
+	void rebase(char* new_scr_base, char* new_ea_scr_base); // the same script was loaded again somewhere else, moves every addr over
+
+	int get_state_count() const;
+	size_t get_memory_usage() const; // rough, states + packed frame tracks + pooled names
+
+private:
+	std::deque<scrState> storage; // deque so pointers handed out stay valid as it grows
+	std::unordered_set<std::string> names; // node based, interned pointers stay valid on rehash
+};
@@ -1,6 +1,9 @@
 #pragma once
 #include <vector>
 #include <string>
+#include <iterator>
+#include <stdexcept>
+#include <stdint.h>
 enum class FrameActivity {
 	// 0x0 - 0xf first 4 bits are frame activity
 	Active = 0x0, //used when there are active hitboxes
@@ -52,9 +55,94 @@ enum class FrameInvuln {
 	//All = Head | Body | Foot | Throw | Proj, 
 	// missing projectile invuln
 };
-//gotta remember to clean up the memory afterwards
+//name owned by a ScrStateArena's string pool, reads like a const std::string
+struct ScrName {
+	const std::string* str = &get_empty();
+
+	ScrName() {}
+	ScrName(const std::string* interned) : str(interned) {}
+
+	const std::string& get() const { return *str; }
+	operator const std::string&() const { return *str; }
+	const char* c_str() const { return str->c_str(); }
+	size_t size() const { return str->size(); }
+	const char& operator[](size_t i) const { return (*str)[i]; }
+	bool operator==(const char* other) const { return *str == other; }
+	bool operator==(const std::string& other) const { return *str == other; }
+	bool operator!=(const char* other) const { return *str != other; }
+
+	static const std::string& get_empty() { static const std::string empty; return empty; }
+};
+
+//per frame values packed 2 per byte, FrameActivity and FrameInvuln both fit in 4 bits
+inline uint8_t pack_frame_value(FrameActivity v) { return (uint8_t)(((uint16_t)v & 0x3) | (((uint16_t)v & 0x10) >> 2)); }
+inline uint8_t pack_frame_value(FrameInvuln v) { return (uint8_t)((uint16_t)v & 0xF); }
+template <typename T> T unpack_frame_value(uint8_t v);
+template <> inline FrameActivity unpack_frame_value<FrameActivity>(uint8_t v) { return (FrameActivity)((v & 0x3) | ((v & 0x4) << 2)); }
+template <> inline FrameInvuln unpack_frame_value<FrameInvuln>(uint8_t v) { return (FrameInvuln)v; }
+
+template <typename T>
+class ScrFrameTrack {
+public:
+	class const_iterator {
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef T value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const T* pointer;
+		typedef T reference;
+
+		const_iterator(const ScrFrameTrack* track, size_t i) : track(track), i(i) {}
+		T operator*() const { return (*track)[i]; }
+		const_iterator& operator++() { i++; return *this; }
+		const_iterator operator++(int) { const_iterator prev = *this; i++; return prev; }
+		bool operator==(const const_iterator& other) const { return i == other.i; }
+		bool operator!=(const const_iterator& other) const { return i != other.i; }
+	private:
+		const ScrFrameTrack* track;
+		size_t i;
+	};
+
+	void push_back(T v) {
+		if ((count & 1) == 0) {
+			packed.push_back(pack_frame_value(v));
+		}
+		else {
+			packed.back() |= pack_frame_value(v) << 4;
+		}
+		count++;
+	}
+	void set(size_t i, T v) {
+		uint8_t& byte = packed.at(i >> 1);
+		int shift = (i & 1) * 4;
+		byte = (uint8_t)((byte & ~(0xF << shift)) | (pack_frame_value(v) << shift));
+	}
+	T operator[](size_t i) const { return unpack_frame_value<T>((packed[i >> 1] >> ((i & 1) * 4)) & 0xF); }
+	T at(size_t i) const {
+		if (i >= count) {
+			throw std::out_of_range("ScrFrameTrack");
+		}
+		return (*this)[i];
+	}
+	size_t size() const { return count; }
+	bool empty() const { return count == 0; }
+	size_t get_memory_usage() const { return packed.capacity(); }
+	const std::vector<uint8_t>& get_packed() const { return packed; }
+	void assign_packed(const uint8_t* data, size_t frame_count) { // for ScrScriptCache, data holds frame_count / 2 rounded up bytes
+		packed.assign(data, data + frame_count / 2 + (frame_count & 1));
+		count = frame_count;
+	}
+	const_iterator begin() const { return const_iterator(this, 0); }
+	const_iterator end() const { return const_iterator(this, count); }
+
+private:
+	std::vector<uint8_t> packed;
+	size_t count = 0;
+};
+
+//owned by the ScrStateArena it was parsed into, pointers stay valid until that arena is destroyed
 struct scrState {
-	std::string name = "";
+	ScrName name;
 	char* addr = NULL;
 	unsigned int frames = 0;
 	unsigned int damage = 0;
@@ -70,11 +158,10 @@ struct scrState {
 	unsigned int hit_low = 0;
 	unsigned int hit_air_unblockable = 0;
 	unsigned int fatal_counter = 0;
-	std::vector<std::string> whiff_cancel = {};
-	std::vector<std::string> hit_or_block_cancel = {};
-	//std::vector<std::string> frame_activity_status = {};
-	std::vector<FrameActivity> frame_activity_status = {}; //vector of combinations from FrameActivity
-	std::vector<FrameInvuln> frame_invuln_status = {}; //vector of combinations from Frameinvuln
-	std::vector<std::pair<unsigned int, scrState> >frame_EA_effect_pairs = {};// holds all the EA states the script spawns. First is the frame where it spawns, second is the scState of the EA state.
+	std::vector<ScrName> whiff_cancel = {};
+	std::vector<ScrName> hit_or_block_cancel = {};
+	ScrFrameTrack<FrameActivity> frame_activity_status; //combinations from FrameActivity, one per frame
+	ScrFrameTrack<FrameInvuln> frame_invuln_status; //combinations from Frameinvuln, one per frame
+	std::vector<std::pair<unsigned int, const scrState*> >frame_EA_effect_pairs = {};// holds all the EA states the script spawns. First is the frame where it spawns, second is the EA state, in the same arena.
 	char* replaced_state_script[36]{};
 };
\ No newline at end of file
@@ -5,9 +5,13 @@
 #include <map>
 #include "Game/Jonb/JonbDBReader.h"
 #include "Game/Jonb/JonbDBEntry.h"
+#include <memory>
 #include "ScrStateEntry.h"
+#include "ScrStateArena.h"
+#include "ScrScriptParser.h"
 
 
-std::vector<scrState*> parse_scr(char* bbcf_base_addr, int player_num);
-int parse_state(char* addr, std::vector<scrState*>& states_parsed, std::map<std::string, JonbDBEntry>*, std::map<std::string, scrState*>* ea_state_map);
+bool locate_scr(char* bbcf_base_addr, int player_num, ScrScriptLocation& location);
+std::shared_ptr<ScrStateArena> parse_scr(char* bbcf_base_addr, int player_num); // goes through g_scr_script_cache, every returned state lives as long as the arena
+std::shared_ptr<ScrStateArena> parse_scr_uncached(char* bbcf_base_addr, const ScrScriptLocation& location);
 void override_state(char* addr, char* new_state);
\ No newline at end of file
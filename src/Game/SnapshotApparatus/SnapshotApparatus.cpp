@@ -9,6 +9,7 @@
 #include <array>
 #include <map>
 #include <memory>
+#include <chrono>
 #include "SnapshotApparatus.h"
 //#include "Core/Interfaces.h"
 
@@ -16,6 +17,7 @@ SnapshotApparatus::SnapshotApparatus() {
 	this->p1_ptr = g_interfaces.player1.GetData();
 	this->p2_ptr = g_interfaces.player2.GetData();
 	this->snapshot_count = 0;
+	this->last_save_us = 0;
 		char* base_addr = GetBbcfBaseAdress();
 		void* addr = base_addr + 0x65bd08;
 		SteamPeer2PeerBackend* bckend = *(SteamPeer2PeerBackend**)addr;
@@ -103,11 +105,8 @@ bool SnapshotApparatus::save_snapshot(Snapshot** pbuf_mine)
 }
 bool SnapshotApparatus::save_snapshot_prealloc()
 {
-	return false;
+	auto start = std::chrono::steady_clock::now();
 	char* base_addr = GetBbcfBaseAdress();
-	//memcpy(&temp_savestate_loc, savedstate_mine[savegame_index], 4);
-	//callbacks_ptr->load_game_state((unsigned char*)temp_savestate_loc);
-	/// COPIES_FROM_OUR_BUFFER_TO_FIRST_ROLLBACK_SLOT
 	static_DAT_of_PTR_on_load_4* DAT_on_load_4_addr = (static_DAT_of_PTR_on_load_4*)(base_addr + 0x612718);
 	SnapshotManager* snap_manager = 0;
 	if (DAT_on_load_4_addr) {
@@ -128,10 +127,15 @@ bool SnapshotApparatus::save_snapshot_prealloc()
 	this->callbacks_ptr->save_game_state((unsigned char**)pbuf,
 		&sizeofstate, //&counter_of_some_sort, I still dont know for sure if this is supposed to be the counter or the sie 
 		&checksum); //I assume this is supposed to be checksum but idk
-	//!!!!UNCOMMENT LATER WHEN STATIC EXISTS
-	//void* pbuf_mine = &snapshot_replay_pre_allocated[this->snapshot_count % SNAPSHOT_PREALLOC_SIZE];
-	//this->snapshot_count += 1;
-	//memcpy(pbuf_mine, *pbuf, 0xa10000);
+	if (*pbuf == nullptr) {
+		return false;
+	}
+	snap_manager->_saved_states_related_struct[this->snapshot_count % 10]._framecount = *g_gameVals.pFrameCount;
+	this->snapshot_count += 1;
+	//the ring slot is still used as the game's buffer, our own copy goes to the store as a delta against the previous checkpoint
+	//only the copy into a staging buffer happens here, the encoding is done on the store's worker thread
+	this->snapshot_store.push_async(*g_gameVals.pFrameCount, *pbuf);
+	this->last_save_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
 
 	return true;
 }
@@ -183,12 +187,8 @@ bool SnapshotApparatus::load_snapshot(Snapshot* buf)
 }
 bool SnapshotApparatus::load_snapshot_prealloc(int index)
 {
-	return false;
-	/* leave buf as zero to not involve our own buffers and just the "built in" snapshot buffer of 10*/
 	char* base_addr = GetBbcfBaseAdress();
 
-	//memcpy(&temp_savestate_loc, savedstate_mine[savegame_index], 4);
-	//callbacks_ptr->load_game_state((unsigned char*)temp_savestate_loc);
 	/// COPIES_FROM_OUR_BUFFER_TO_FIRST_ROLLBACK_SLOT
 	static_DAT_of_PTR_on_load_4* DAT_on_load_4_addr = (static_DAT_of_PTR_on_load_4*)(base_addr + 0x612718);
 	SnapshotManager* snap_manager = 0;
@@ -198,12 +198,13 @@ bool SnapshotApparatus::load_snapshot_prealloc(int index)
 	else {
 		return false;
 	}
+	if (this->snapshot_count == 0) {
+		return false;
+	}
 	unsigned char* dest_buf = (unsigned char*)snap_manager->_saved_states_related_struct[(snapshot_count - 1) % 10]._ptr_buf_saved_frame;
-	//!!!!UNCOMMENT LATER WHEN STATIC EXISTS
-	//void* buf = &snapshot_replay_pre_allocated[index % SNAPSHOT_PREALLOC_SIZE];
-	//if (buf != 0) {
-	//	memcpy(dest_buf, buf, 0xA10000);
-	//}
+	if (dest_buf == nullptr || !this->snapshot_store.restore(index, dest_buf)) {
+		return false;
+	}
 
 	/// COPIES_FROM_OUR_BUFFER_TO_FIRST_ROLLBACK_SLOT_END
 	///PRELUDE
@@ -217,18 +218,12 @@ bool SnapshotApparatus::load_snapshot_prealloc(int index)
 	WriteToProtectedMemory((uintptr_t)ptr_oldmem_load + 2, nops, 1);
 	/// PRELUDE_END
 
-
-
-
-
-	//unsigned char* buf = (unsigned char*)snap_manager->_saved_states_related_struct[(savegame_count % 10) - 1]._ptr_buf_saved_frame;
 	this->callbacks_ptr->load_game_state(dest_buf);
 
 	///CLEANUP
 	WriteToProtectedMemory((uintptr_t)ptr_oldmem_load, oldmem_load, 3);
 	///CLEANUP_END
 	return true;
-	return false;
 }
 bool SnapshotApparatus::load_snapshot_index(int index) {
 	/* leave buf as zero to not involve our own buffers and just the "built in" snapshot buffer of 10*/
@@ -272,6 +267,13 @@ bool SnapshotApparatus::load_snapshot_index(int index) {
 	///CLEANUP_END
 	return true;
 }
+bool SnapshotApparatus::advance_frame() {
+	if (this->callbacks_ptr == nullptr || this->callbacks_ptr->advance_frame == nullptr) {
+		return false;
+	}
+	this->callbacks_ptr->advance_frame();
+	return true;
+}
 bool SnapshotApparatus::check_if_valid(CharData* p1, CharData* p2)
 {
 	if (this->p1_ptr == p1 && this->p2_ptr == p2) {
@@ -284,6 +286,10 @@ void SnapshotApparatus::clear_count()
 {
 	this->snapshot_count = 0;
 }
+void SnapshotApparatus::clear_store()
+{
+	this->snapshot_store.clear();
+}
 bool SnapshotApparatus::clear_framecounts() {
 	char* base_addr = GetBbcfBaseAdress();
 	static_DAT_of_PTR_on_load_4* DAT_on_load_4_addr = (static_DAT_of_PTR_on_load_4*)(base_addr + 0x612718);
@@ -301,35 +307,10 @@ bool SnapshotApparatus::clear_framecounts() {
 	return true;
 }
 
-int SnapshotApparatus::get_nearest_prealloc_frame(int current_frame, std::map<int, Snapshot*> frame_snap_map) {
-	
-	return -1;
-
-		//if -1 is returned nothing was found
-	int closest_index = -1;
-	int lowest_delta = 6000000;
-	int iterator = 0;
-	if (this->snapshot_count == 0) {
+int SnapshotApparatus::get_nearest_prealloc_frame(int current_frame) {
+	//if -1 is returned nothing was found
+	if (current_frame < 0) {
 		return -1;
 	}
-	for (auto const& x : frame_snap_map) {
-		uint32_t snap_frame = x.first;
-		if ((current_frame - snap_frame) < lowest_delta) {
-			lowest_delta = current_frame - snap_frame;
-			closest_index = iterator;
-		}
-		iterator += 1;
-	}
-	//for (int i = 0; i < this->snapshot_count-1; i++) {
-		//CharData p1_chardata = snapshot_replay_pre_allocated[i % SNAPSHOT_PREALLOC_SIZE].p1_chardata_training_;
-		////p1_chardata = (void*)&snapshot_replay_pre_allocated[i % SNAPSHOT_PREALLOC_SIZE] + 0x623E10;
-	//	uint32_t snap_frame = p1_chardata.frame_count_minus_1;
-		//if ((current_frame - snap_frame) < lowest_delta) {
-	//		lowest_delta = current_frame - snap_frame;
-	//		closest_index = i;
-	//	}
-	//}
-	return closest_index;
+	return this->snapshot_store.find_nearest_index((unsigned int)current_frame);
 }
-
-
@@ -1,8 +1,8 @@
 #pragma once
 #include "Game/GhidraDefs.h"
 #include "Game/CharData.h"
+#include "SnapshotStore.h"
 #include <map>
-#define SNAPSHOT_PREALLOC_SIZE  1
 
 class Snapshot {
 public:
@@ -11,9 +11,7 @@ public:
 	
 };
 
-//!!!!!!!!!!!!Uncomment this later(and all the functions related to it) when I go back to working on rewind!!!! leaving out for possible crash reasons
-//static Snapshot snapshot_replay_pre_allocated[SNAPSHOT_PREALLOC_SIZE]; //keeping this with only one element for now while its not used for any implementation to save space
-//!!!!!!!!!!!!!!!!
+//the old static snapshot_replay_pre_allocated array is replaced by SnapshotStore, the *_prealloc functions save/load through snapshot_store
 
 
 class SnapshotApparatus {
@@ -25,18 +23,22 @@ public:
 	CharData* p2_ptr; //p2 CharData*
 	//p1 and p2 ptrs are used for now to determine when I need to remake the snapshot
 	GGPOSessionCallbacks*  callbacks_ptr;
+	SnapshotStore snapshot_store; //delta compressed checkpoints, not limited to the 10 slots of the SnapshotManager
+	long long last_save_us; //game thread cost of the last save_snapshot_prealloc
 	//Snapshot* p_snapshot_reseve;
 	//Snapshot** pp_snapshot_reseve;
 	SnapshotApparatus();
 
 	
 bool save_snapshot(Snapshot** pbuf);
-bool save_snapshot_prealloc();
+bool save_snapshot_prealloc(); //saves into snapshot_store, returns false if it couldn't save
 bool load_snapshot(Snapshot* buf);
-bool load_snapshot_prealloc(int index);
+bool load_snapshot_prealloc(int index); //index into snapshot_store
 bool load_snapshot_index(int index);
+bool advance_frame(); //runs one simulation step without rendering, same path ggpo uses to resimulate on rollback
 bool check_if_valid(CharData* p1, CharData* p2);
 void clear_count();
+void clear_store();
 bool clear_framecounts();
-int get_nearest_prealloc_frame(int current_frame, std::map<int, Snapshot*> frame_snap_map);
+int get_nearest_prealloc_frame(int current_frame);
 };
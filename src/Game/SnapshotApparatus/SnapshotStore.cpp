@@ -0,0 +1,382 @@
+#include "SnapshotStore.h"
+#include "Core/hash.h"
+#include <chrono>
+#include <cstring>
+
+static inline void write_u32(std::vector<uint8_t>& out, uint32_t val) {
+	uint8_t bytes[4];
+	memcpy(bytes, &val, 4);
+	out.insert(out.end(), bytes, bytes + 4);
+}
+
+static inline uint8_t xor_at(const uint8_t* cur, const uint8_t* prev, size_t i) {
+	return prev ? (uint8_t)(cur[i] ^ prev[i]) : cur[i];
+}
+
+SnapshotStore::SnapshotStore(size_t snapshot_size, int keyframe_interval) {
+	this->snapshot_size = snapshot_size;
+	this->keyframe_interval = keyframe_interval > 0 ? keyframe_interval : 1;
+	this->encoded_bytes = 0;
+	this->deltas_since_keyframe = 0;
+	this->last_stage_us = 0;
+	this->last_encode_us = 0;
+	this->last_decode_us = 0;
+	this->last_remove_us = 0;
+	this->pending_delta = 0;
+	this->worker_busy = false;
+	this->stop_worker = false;
+}
+
+SnapshotStore::~SnapshotStore() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stop_worker = true;
+	}
+	cv_queued.notify_all();
+	if (worker.joinable()) {
+		worker.join();
+	}
+}
+
+void SnapshotStore::encode_delta(const uint8_t* cur, const uint8_t* prev, size_t size, std::vector<uint8_t>& out) {
+	out.clear();
+	size_t i = 0;
+	while (i < size) {
+		//unchanged run, compared a word at a time since most of the state doesn't move between checkpoints
+		size_t zero_start = i;
+		if (prev) {
+			while (i + 4 <= size && memcmp(cur + i, prev + i, 4) == 0) {
+				i += 4;
+			}
+		}
+		else {
+			uint32_t word;
+			while (i + 4 <= size && (memcpy(&word, cur + i, 4), word == 0)) {
+				i += 4;
+			}
+		}
+		while (i < size && xor_at(cur, prev, i) == 0) {
+			i++;
+		}
+		size_t zero_len = i - zero_start;
+
+		//changed run, ends once SNAPSHOT_STORE_MIN_ZERO_RUN unchanged bytes are found in a row
+		size_t literal_start = i;
+		size_t zeros = 0;
+		while (i < size) {
+			if (xor_at(cur, prev, i) == 0) {
+				zeros++;
+				if (zeros >= SNAPSHOT_STORE_MIN_ZERO_RUN) {
+					break;
+				}
+			}
+			else {
+				zeros = 0;
+			}
+			i++;
+		}
+		size_t literal_end = i;
+		if (zeros >= SNAPSHOT_STORE_MIN_ZERO_RUN) {
+			literal_end = i - (SNAPSHOT_STORE_MIN_ZERO_RUN - 1);
+		}
+		i = literal_end;
+
+		write_u32(out, (uint32_t)zero_len);
+		write_u32(out, (uint32_t)(literal_end - literal_start));
+		for (size_t j = literal_start; j < literal_end; j++) {
+			out.push_back(xor_at(cur, prev, j));
+		}
+	}
+	out.shrink_to_fit();
+}
+
+bool SnapshotStore::apply_delta(const uint8_t* encoded, size_t encoded_size, uint8_t* buf, size_t size) {
+	size_t in = 0;
+	size_t pos = 0;
+	while (in + 8 <= encoded_size) {
+		uint32_t zero_len;
+		uint32_t literal_len;
+		memcpy(&zero_len, encoded + in, 4);
+		memcpy(&literal_len, encoded + in + 4, 4);
+		in += 8;
+		pos += zero_len;
+		if (pos + literal_len > size || in + literal_len > encoded_size) {
+			return false;
+		}
+		for (uint32_t j = 0; j < literal_len; j++) {
+			buf[pos + j] ^= encoded[in + j];
+		}
+		pos += literal_len;
+		in += literal_len;
+	}
+	return in == encoded_size;
+}
+
+void SnapshotStore::encode_and_append(unsigned int framecount, const uint8_t* buf, bool queued) {
+	//previous and deltas_since_keyframe are only touched on the worker or with it idle, no lock needed for them
+	auto start = std::chrono::steady_clock::now();
+
+	SnapshotStoreEntry entry;
+	entry.framecount = framecount;
+	entry.is_keyframe = previous.empty() || deltas_since_keyframe + 1 >= keyframe_interval;
+	deltas_since_keyframe = entry.is_keyframe ? 0 : deltas_since_keyframe + 1;
+	entry.content_hash = fnv1a64_words(buf, snapshot_size);
+	encode_delta(buf, entry.is_keyframe ? nullptr : previous.data(), snapshot_size, entry.encoded);
+
+	previous.resize(snapshot_size);
+	memcpy(previous.data(), buf, snapshot_size);
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		encoded_bytes += entry.encoded.size();
+		entries.push_back(std::move(entry));
+		if (queued) {
+			pending_delta--;
+		}
+	}
+
+	last_encode_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+int SnapshotStore::push(unsigned int framecount, const unsigned char* buf) {
+	flush();
+	encode_and_append(framecount, buf, false);
+	return size() - 1;
+}
+
+void SnapshotStore::start_worker() {
+	if (worker.joinable()) {
+		return;
+	}
+	staging.resize(SNAPSHOT_STORE_STAGING_BUFFERS);
+	for (int i = 0; i < SNAPSHOT_STORE_STAGING_BUFFERS; i++) {
+		staging[i].data.resize(snapshot_size);
+		free_staging.push_back(i);
+	}
+	worker = std::thread(&SnapshotStore::worker_loop, this);
+}
+
+int SnapshotStore::push_async(unsigned int framecount, const unsigned char* buf) {
+	auto start = std::chrono::steady_clock::now();
+	int staging_id;
+	int index;
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		start_worker();
+		cv_done.wait(lock, [this] { return !free_staging.empty(); });
+		staging_id = free_staging.back();
+		free_staging.pop_back();
+		index = (int)entries.size() + pending_delta;
+		pending_delta++;
+	}
+
+	staging[staging_id].framecount = framecount;
+	memcpy(staging[staging_id].data.data(), buf, snapshot_size);
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		queued_jobs.push_back(SnapshotStoreJob{ staging_id, -1 });
+	}
+	cv_queued.notify_one();
+
+	last_stage_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+	return index;
+}
+
+bool SnapshotStore::remove_async(int index) {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (index < 0 || index >= (int)entries.size() + pending_delta) {
+			return false;
+		}
+		start_worker();
+		queued_jobs.push_back(SnapshotStoreJob{ -1, index });
+		pending_delta--;
+	}
+	cv_queued.notify_one();
+	return true;
+}
+
+void SnapshotStore::worker_loop() {
+	for (;;) {
+		SnapshotStoreJob job;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			cv_queued.wait(lock, [this] { return stop_worker || !queued_jobs.empty(); });
+			if (queued_jobs.empty()) {
+				return;
+			}
+			job = queued_jobs.front();
+			queued_jobs.pop_front();
+			worker_busy = true;
+		}
+
+		if (job.staging_id >= 0) {
+			encode_and_append(staging[job.staging_id].framecount, staging[job.staging_id].data.data(), true);
+		}
+		else {
+			remove_entry(job.remove_index, true);
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (job.staging_id >= 0) {
+				free_staging.push_back(job.staging_id);
+			}
+			worker_busy = false;
+		}
+		cv_done.notify_all();
+	}
+}
+
+void SnapshotStore::flush() {
+	std::unique_lock<std::mutex> lock(mutex);
+	cv_done.wait(lock, [this] { return queued_jobs.empty() && !worker_busy; });
+}
+
+bool SnapshotStore::restore(int index, unsigned char* out_buf) {
+	flush();
+	std::lock_guard<std::mutex> lock(mutex);
+	auto start = std::chrono::steady_clock::now();
+	if (!rebuild(index, out_buf)) {
+		return false;
+	}
+	last_decode_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+	return true;
+}
+
+bool SnapshotStore::rebuild(int index, unsigned char* out_buf) {
+	if (index < 0 || index >= (int)entries.size() || out_buf == nullptr) {
+		return false;
+	}
+	int keyframe = index;
+	while (keyframe > 0 && !entries[keyframe].is_keyframe) {
+		keyframe--;
+	}
+	memset(out_buf, 0, snapshot_size);
+	for (int i = keyframe; i <= index; i++) {
+		auto& entry = entries[i];
+		if (!apply_delta(entry.encoded.data(), entry.encoded.size(), out_buf, snapshot_size)) {
+			return false;
+		}
+	}
+#ifdef _DEBUG
+	if (fnv1a64_words(out_buf, snapshot_size) != entries[index].content_hash) {
+		return false;
+	}
+#endif
+	return true;
+}
+
+bool SnapshotStore::remove(int index) {
+	flush();
+	return remove_entry(index, false);
+}
+
+bool SnapshotStore::remove_entry(int index, bool queued) {
+	//entries only change on the worker or with it idle, so the fold reads them unlocked and only the swap in takes the lock
+	auto start = std::chrono::steady_clock::now();
+	bool valid = index >= 0 && index < (int)entries.size();
+	bool newest = valid && index == (int)entries.size() - 1;
+	bool fold = valid && !newest && !entries[index + 1].is_keyframe;
+	bool ok = valid;
+	std::vector<uint8_t> folded;
+	if (newest && index > 0) {
+		//the newest one is the base for the next push, rebuild the one before it in its place
+		rebuild(index - 1, previous.data());
+	}
+	else if (fold) {
+		//next ^= removed, a keyframe folded into a delta gives a keyframe of the next checkpoint
+		const SnapshotStoreEntry& removed = entries[index];
+		const SnapshotStoreEntry& next = entries[index + 1];
+		scratch.resize(snapshot_size);
+		memset(scratch.data(), 0, snapshot_size);
+		ok = apply_delta(removed.encoded.data(), removed.encoded.size(), scratch.data(), snapshot_size)
+			&& apply_delta(next.encoded.data(), next.encoded.size(), scratch.data(), snapshot_size);
+		if (ok) {
+			encode_delta(scratch.data(), nullptr, snapshot_size, folded);
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (queued) {
+			//a failed fold keeps the checkpoint, the streams are all encoded here so that takes a corrupted store
+			pending_delta++;
+		}
+		if (ok) {
+			if (fold) {
+				SnapshotStoreEntry& next = entries[index + 1];
+				encoded_bytes -= next.encoded.size();
+				next.encoded.swap(folded);
+				encoded_bytes += next.encoded.size();
+				next.is_keyframe = entries[index].is_keyframe;
+			}
+			encoded_bytes -= entries[index].encoded.size();
+			entries.erase(entries.begin() + index);
+		}
+	}
+	if (ok) {
+		if (entries.empty()) {
+			previous.clear();
+		}
+		update_deltas_since_keyframe();
+		last_remove_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+	}
+	return ok;
+}
+
+void SnapshotStore::update_deltas_since_keyframe() {
+	deltas_since_keyframe = 0;
+	for (int i = (int)entries.size() - 1; i >= 0 && !entries[i].is_keyframe; i--) {
+		deltas_since_keyframe++;
+	}
+}
+
+void SnapshotStore::clear() {
+	flush();
+	std::lock_guard<std::mutex> lock(mutex);
+	entries.clear();
+	previous.clear();
+	previous.shrink_to_fit();
+	scratch.clear();
+	scratch.shrink_to_fit();
+	encoded_bytes = 0;
+	deltas_since_keyframe = 0;
+}
+
+int SnapshotStore::size() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return (int)entries.size() + pending_delta;
+}
+
+unsigned int SnapshotStore::get_framecount(int index) {
+	flush();
+	std::lock_guard<std::mutex> lock(mutex);
+	if (index < 0 || index >= (int)entries.size()) {
+		return 0;
+	}
+	return entries[index].framecount;
+}
+
+int SnapshotStore::find_nearest_index(unsigned int framecount) {
+	flush();
+	std::lock_guard<std::mutex> lock(mutex);
+	//checkpoints can be pushed out of frame order after a rewind, so look at all of them
+	int nearest = -1;
+	for (int i = 0; i < (int)entries.size(); i++) {
+		if (entries[i].framecount <= framecount
+			&& (nearest == -1 || entries[i].framecount > entries[nearest].framecount)) {
+			nearest = i;
+		}
+	}
+	return nearest;
+}
+
+size_t SnapshotStore::get_raw_bytes() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return entries.size() * snapshot_size;
+}
+
+size_t SnapshotStore::get_encoded_bytes() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return encoded_bytes;
+}
@@ -0,0 +1,100 @@
+#pragma once
+#include <stdint.h>
+#include <cstddef>
+#include <vector>
+#include <deque>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+#define SNAPSHOT_STATE_SIZE 0xa10000
+#define SNAPSHOT_STORE_KEYFRAME_INTERVAL 30 // a full (zero based) keyframe every N checkpoints, bounds how many deltas a restore has to apply
+#define SNAPSHOT_STORE_MIN_ZERO_RUN 8 // shorter unchanged gaps than this are kept inside the literal to avoid token overhead
+#define SNAPSHOT_STORE_STAGING_BUFFERS 2 // bound of the async queue, push_async waits for the worker once all of them are in use
+
+struct SnapshotStagingBuffer {
+	unsigned int framecount;
+	std::vector<uint8_t> data;
+};
+
+struct SnapshotStoreJob {
+	int staging_id; // -1 for a removal
+	int remove_index; // as the store stands once the jobs before it are done
+};
+
+struct SnapshotStoreEntry {
+	unsigned int framecount;
+	bool is_keyframe;
+	uint64_t content_hash; // hash of the raw state, used to verify restores on debug builds
+	std::vector<uint8_t> encoded; // XOR against the previously pushed checkpoint (against zero for keyframes), then RLE of the zero runs
+};
+
+/*
+	Mod owned snapshot storage, not limited to the 10 slots of the game's SnapshotManager.
+	Each pushed checkpoint is stored as a delta against the one pushed before it, every SNAPSHOT_STORE_KEYFRAME_INTERVAL
+	checkpoints a keyframe is stored instead so restoring never walks the whole chain.
+	Since deltas are XORs, removing a checkpoint is just XORing its delta into the next one, no full state rebuild needed.
+
+	Encoded stream is a sequence of tokens: (uint32 zero_run, uint32 literal_len, literal_len bytes of XORed data)
+
+	push_async only copies the state into a preallocated staging buffer, hashing and encoding happen on a worker thread.
+	remove_async queues the fold the same way. Anything that reads or changes the existing checkpoints waits for the worker
+	to be done first (flush), indices are already final when the async calls return since the worker runs the jobs in call order.
+*/
+class SnapshotStore {
+public:
+	SnapshotStore(size_t snapshot_size = SNAPSHOT_STATE_SIZE, int keyframe_interval = SNAPSHOT_STORE_KEYFRAME_INTERVAL);
+	~SnapshotStore();
+	SnapshotStore(const SnapshotStore&) = delete;
+	SnapshotStore& operator=(const SnapshotStore&) = delete;
+
+	int push(unsigned int framecount, const unsigned char* buf); // returns the index of the new checkpoint
+	int push_async(unsigned int framecount, const unsigned char* buf); // same as push but the encoding is done on the worker thread
+	void flush(); // waits until every queued checkpoint is encoded
+	bool restore(int index, unsigned char* out_buf); // rebuilds the checkpoint at index into out_buf (snapshot_size bytes)
+	bool remove(int index); // drops a checkpoint, folding its delta into the next one. Indices after it shift down by one
+	bool remove_async(int index); // same as remove but the fold is done on the worker thread, get_encoded_bytes only drops once it's done
+	void clear();
+
+	int size() const; // includes the checkpoints still queued for encoding
+	unsigned int get_framecount(int index);
+	int find_nearest_index(unsigned int framecount); // index of the latest checkpoint at or before framecount, -1 if none
+	size_t get_raw_bytes() const; // what the checkpoints would take as plain copies
+	size_t get_encoded_bytes() const;
+
+	std::atomic<long long> last_stage_us; // game thread side of push_async
+	std::atomic<long long> last_encode_us;
+	std::atomic<long long> last_decode_us;
+	std::atomic<long long> last_remove_us; // the fold and re-encode, on the worker for remove_async
+
+	static void encode_delta(const uint8_t* cur, const uint8_t* prev, size_t size, std::vector<uint8_t>& out); // prev == nullptr encodes against zero
+	static bool apply_delta(const uint8_t* encoded, size_t encoded_size, uint8_t* buf, size_t size); // buf ^= delta, false if the stream is malformed
+
+private:
+	size_t snapshot_size;
+	int keyframe_interval;
+	size_t encoded_bytes;
+	int deltas_since_keyframe;
+	std::vector<SnapshotStoreEntry> entries;
+	std::vector<uint8_t> previous; // raw copy of the last pushed checkpoint, base for the next delta
+	std::vector<uint8_t> scratch; // only allocated once a remove needs to merge two deltas
+
+	mutable std::mutex mutex; // guards changes to entries, encoded_bytes and the job queue
+	std::condition_variable cv_queued;
+	std::condition_variable cv_done;
+	std::vector<SnapshotStagingBuffer> staging;
+	std::vector<int> free_staging;
+	std::deque<SnapshotStoreJob> queued_jobs; // waiting for the worker, in call order
+	int pending_delta; // what the queued and running jobs will add to entries.size(), negative with removals
+	bool worker_busy;
+	bool stop_worker;
+	std::thread worker;
+
+	void encode_and_append(unsigned int framecount, const uint8_t* buf, bool queued);
+	bool remove_entry(int index, bool queued);
+	bool rebuild(int index, unsigned char* out_buf); // restore without the flush/lock, caller holds the mutex or is the worker
+	void start_worker(); // caller holds the mutex
+	void worker_loop();
+	void update_deltas_since_keyframe();
+};
@@ -0,0 +1,135 @@
+#include "BytePatch.h"
+
+#include <algorithm>
+#include <cstring>
+
+BytePatchGroup::BytePatchGroup(std::initializer_list<BytePatchSite> sites)
+	: m_sites(sites), m_captured(sites.size()), m_applied(false)
+{
+	MergePageRuns();
+}
+
+BytePatchGroup::BytePatchGroup(const std::vector<BytePatchSite>& sites)
+	: m_sites(sites), m_captured(sites.size()), m_applied(false)
+{
+	MergePageRuns();
+}
+
+void BytePatchGroup::MergePageRuns()
+{
+	// Sites don't move, so the page runs are worked out once
+	for (const BytePatchSite& site : m_sites)
+	{
+		uint32_t first = site.rva & ~(uint32_t)(BYTE_PATCH_PAGE_SIZE - 1);
+		uint32_t last = (site.rva + site.length - 1) | (BYTE_PATCH_PAGE_SIZE - 1);
+		m_pageRuns.push_back(std::make_pair(first, last));
+	}
+	std::sort(m_pageRuns.begin(), m_pageRuns.end());
+
+	std::vector<std::pair<uint32_t, uint32_t>> merged;
+	for (const auto& run : m_pageRuns)
+	{
+		if (!merged.empty() && run.first <= merged.back().second + 1)
+			merged.back().second = std::max(merged.back().second, run.second);
+		else
+			merged.push_back(run);
+	}
+	m_pageRuns.swap(merged);
+}
+
+bool BytePatchGroup::Apply(unsigned char* base, PageProtector& protector)
+{
+	if (m_applied)
+		return true;
+
+	for (const BytePatchSite& site : m_sites)
+	{
+		if (site.original && memcmp(base + site.rva, site.original, site.length) != 0)
+			return false;
+	}
+
+	for (size_t i = 0; i < m_sites.size(); i++)
+	{
+		m_captured[i].assign((const char*)base + m_sites[i].rva, m_sites[i].length);
+	}
+
+	if (!Write(base, protector, true))
+		return false;
+
+	m_applied = true;
+	return true;
+}
+
+bool BytePatchGroup::Revert(unsigned char* base, PageProtector& protector)
+{
+	if (!m_applied)
+		return true;
+
+	// Something else wrote over the patch since, putting the old bytes back could break that
+	for (const BytePatchSite& site : m_sites)
+	{
+		if (memcmp(base + site.rva, site.patched, site.length) != 0)
+			return false;
+	}
+
+	if (!Write(base, protector, false))
+		return false;
+
+	m_applied = false;
+	return true;
+}
+
+bool BytePatchGroup::Write(unsigned char* base, PageProtector& protector, bool apply)
+{
+	std::vector<uint32_t> oldProtections(m_pageRuns.size(), 0);
+	size_t unprotected = 0;
+	for (; unprotected < m_pageRuns.size(); unprotected++)
+	{
+		const auto& run = m_pageRuns[unprotected];
+		if (!protector.Unprotect(base + run.first, run.second - run.first + 1, oldProtections[unprotected]))
+			break;
+	}
+
+	// All or nothing, if a run can't be made writable nothing gets written
+	bool result = unprotected == m_pageRuns.size();
+	if (result)
+	{
+		for (size_t i = 0; i < m_sites.size(); i++)
+		{
+			const char* bytes = apply ? m_sites[i].patched : m_captured[i].data();
+			memcpy(base + m_sites[i].rva, bytes, m_sites[i].length);
+		}
+	}
+
+	// A run left writable isn't worth undoing the write over, the result only says whether the bytes went in
+	for (size_t i = 0; i < unprotected; i++)
+	{
+		const auto& run = m_pageRuns[i];
+		protector.Restore(base + run.first, run.second - run.first + 1, oldProtections[i]);
+	}
+
+	return result;
+}
+
+bool BytePatchGroup::IsApplied() const
+{
+	return m_applied;
+}
+
+int BytePatchGroup::GetSiteCount() const
+{
+	return (int)m_sites.size();
+}
+
+int BytePatchGroup::GetByteCount() const
+{
+	int count = 0;
+	for (const BytePatchSite& site : m_sites)
+		count += site.length;
+	return count;
+}
+
+int BytePatchGroup::GetPageRunCount() const
+{
+	return (int)m_pageRuns.size();
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+#define BYTE_PATCH_PAGE_SIZE 0x1000
+
+// One spot to overwrite, original NULL means whatever is there gets captured without being checked
+struct BytePatchSite
+{
+	uint32_t rva;
+	const char* original;
+	const char* patched;
+	int length;
+};
+
+// Makes pages writable and puts their protection back, VirtualProtect in game and a stand-in offline
+class PageProtector
+{
+public:
+	virtual ~PageProtector() {}
+	virtual bool Unprotect(void* address, size_t size, uint32_t& oldProtection) = 0;
+	virtual bool Restore(void* address, size_t size, uint32_t oldProtection) = 0;
+};
+
+/*
+	A set of byte patches that goes in and out as one. Apply checks every site against its expected original bytes
+	before touching anything, so a patch that doesn't fit (another version of the exe, or another patch already on
+	the same bytes) writes nothing. The bytes that were there are captured on apply and written back on revert.
+	Every run of pages the sites touch is unprotected once per apply or revert. Applying twice or reverting
+	something that isn't applied does nothing.
+*/
+class BytePatchGroup
+{
+public:
+	BytePatchGroup(std::initializer_list<BytePatchSite> sites);
+	explicit BytePatchGroup(const std::vector<BytePatchSite>& sites);
+
+	bool Apply(unsigned char* base, PageProtector& protector);
+	bool Revert(unsigned char* base, PageProtector& protector);
+
+	bool IsApplied() const;
+	int GetSiteCount() const;
+	int GetByteCount() const;
+	int GetPageRunCount() const;
+
+private:
+	std::vector<BytePatchSite> m_sites;
+	std::vector<std::string> m_captured; // per site, the bytes Apply replaced
+	std::vector<std::pair<uint32_t, uint32_t>> m_pageRuns; // first and last byte (RVA) of each merged run
+	bool m_applied;
+
+	void MergePageRuns();
+	bool Write(unsigned char* base, PageProtector& protector, bool apply);
+};
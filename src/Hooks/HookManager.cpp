@@ -3,8 +3,18 @@
 #include "Core/logger.h"
 
 #include <Psapi.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
 
 std::vector<functionhook_t> HookManager::hooks;
+HashSlots HookManager::hookSlots;
+long long HookManager::lastBatchUs = 0;
+PatternScanner HookManager::patternScanner;
+bool HookManager::isCollectingPatterns = false;
+double HookManager::lastScanMs = 0.0;
+bool HookManager::signatureCacheUsed = false;
+std::vector<HookManager::collectedpattern_t> HookManager::collectedPatterns;
 
 JMPBACKADDR HookManager::SetHook(const char* label, const char* pattern, const char* mask,
 	const int len, void* newFunc, bool activate)
@@ -16,6 +26,12 @@ JMPBACKADDR HookManager::SetHook(const char* label, const char* pattern, const c
 		return 0;
 	}
 
+	if (isCollectingPatterns)
+	{
+		collectedPatterns.push_back(collectedpattern_t{ label, patternScanner.AddPattern(pattern, mask), HashPattern(pattern, mask) });
+		return 0;
+	}
+
 	//check if there is already a hook registered with same label
 	int index = GetHookStructIndex(label);
 	if (index != -1)
@@ -24,9 +40,7 @@ JMPBACKADDR HookManager::SetHook(const char* label, const char* pattern, const c
 		return hooks[index].jmpBackAddr;
 	}
 
-	hooks.push_back(functionhook_t{});
-	index = hooks.size() - 1;
-	hooks[index].label = label;
+	index = AddHookStruct(label);
 	hooks[index].pattern = pattern;
 	hooks[index].mask = mask;
 	hooks[index].length = len;
@@ -75,6 +89,9 @@ JMPBACKADDR HookManager::SetHook(const char* label, DWORD startAddress, const in
 		return 0;
 	}
 
+	if (isCollectingPatterns)
+		return 0;
+
 	//check if there is already a hook registered with same label
 	int index = GetHookStructIndex(label);
 	if (index != -1)
@@ -83,9 +100,7 @@ JMPBACKADDR HookManager::SetHook(const char* label, DWORD startAddress, const in
 		return hooks[index].jmpBackAddr;
 	}
 
-	hooks.push_back(functionhook_t{});
-	index = hooks.size() - 1;
-	hooks[index].label = label;
+	index = AddHookStruct(label);
 	hooks[index].pattern = "";
 	hooks[index].mask = "";
 	hooks[index].length = len;
@@ -180,6 +195,9 @@ bool HookManager::IsHookActivated(const char* label)
 
 bool HookManager::ActivateHook(const char* label)
 {
+	if (isCollectingPatterns)
+		return false;
+
 	LOG(2, "Activating %s hook.\n", label);
 	int index = GetHookStructIndex(label);
 	if (index == -1)
@@ -260,6 +278,9 @@ bool HookManager::SetJmpBackAddr(const char* label, DWORD newJmpBackAddr)
 
 DWORD HookManager::GetStartAddress(const char* label)
 {
+	if (isCollectingPatterns)
+		return 0;
+
 	int index = GetHookStructIndex(label);
 	if (index == -1)
 	{
@@ -273,6 +294,12 @@ DWORD HookManager::GetStartAddress(const char* label)
 //registering a new hook struct without hooking
 JMPBACKADDR HookManager::RegisterHook(const char* label, const char* pattern, const char* mask, const int len)
 {
+	if (isCollectingPatterns)
+	{
+		collectedPatterns.push_back(collectedpattern_t{ label, patternScanner.AddPattern(pattern, mask), HashPattern(pattern, mask) });
+		return 0;
+	}
+
 	int index = GetHookStructIndex(label);
 	if (index != -1)
 	{
@@ -280,9 +307,7 @@ JMPBACKADDR HookManager::RegisterHook(const char* label, const char* pattern, co
 		return hooks[index].jmpBackAddr;
 	}
 
-	hooks.push_back(functionhook_t());
-	index = hooks.size() - 1;
-	hooks[index].label = label;
+	index = AddHookStruct(label);
 	hooks[index].pattern = pattern;
 	hooks[index].mask = mask;
 	hooks[index].length = len;
@@ -306,6 +331,9 @@ JMPBACKADDR HookManager::RegisterHook(const char* label, const char* pattern, co
 //bytesToReturn = 1/2/4
 int HookManager::GetOriginalBytes(const char* label, int startIndex, int bytesToReturn)
 {
+	if (isCollectingPatterns)
+		return 0;
+
 	int index = GetHookStructIndex(label);
 	if (index == -1)
 	{
@@ -332,6 +360,9 @@ int HookManager::GetOriginalBytes(const char* label, int startIndex, int bytesTo
 //bytesToReturn = 1/2/4
 int HookManager::GetBytesFromAddr(const char* label, int startIndex, int bytesToReturn)
 {
+	if (isCollectingPatterns)
+		return 0;
+
 	int index = GetHookStructIndex(label);
 	if (index == -1)
 	{
@@ -361,12 +392,17 @@ void HookManager::Cleanup()
 
 int HookManager::GetHookStructIndex(const char* label)
 {
-	for (unsigned int i = 0; i < hooks.size(); i++)
-	{
-		if (strcmp(hooks[i].label.c_str(), label) == 0)
-			return i;
-	}
-	return -1;
+	return hookSlots.Find(fnv1a32(label), [label](uint32_t index) { return strcmp(hooks[index].label.c_str(), label) == 0; });
+}
+
+int HookManager::AddHookStruct(const char* label)
+{
+	hooks.push_back(functionhook_t{});
+	int index = hooks.size() - 1;
+	hooks[index].label = label;
+	hookSlots.Insert(fnv1a32(label), index);
+
+	return index;
 }
 
 bool HookManager::RestoreOriginalBytes(int index)
@@ -398,18 +434,140 @@ bool HookManager::PlaceHook(void* toHook, void* ourFunc, int len)
 	if (!VirtualProtect(toHook, len, PAGE_EXECUTE_READWRITE, &curProtection))
 		return false;
 
+	WriteJump(toHook, ourFunc, len);
+
+	DWORD temp;
+	if (!VirtualProtect(toHook, len, curProtection, &temp))
+		return false;
+
+	return true;
+}
+
+void HookManager::WriteJump(void* toHook, void* ourFunc, int len)
+{
 	memset(toHook, 0x90, len);
 
 	DWORD relativeAddress = ((DWORD)ourFunc - (DWORD)toHook) - 5;
 
 	*(BYTE*)toHook = 0xE9;
 	*(DWORD*)((DWORD)toHook + 1) = relativeAddress;
+}
 
-	DWORD temp;
-	if (!VirtualProtect(toHook, len, curProtection, &temp))
-		return false;
+bool HookManager::ActivateHooks(const std::vector<std::string>& labels)
+{
+	return SetHooksActivated(labels, true);
+}
 
-	return true;
+bool HookManager::DeactivateHooks(const std::vector<std::string>& labels)
+{
+	return SetHooksActivated(labels, false);
+}
+
+long long HookManager::GetLastBatchUs()
+{
+	return lastBatchUs;
+}
+
+bool HookManager::SetHooksActivated(const std::vector<std::string>& labels, bool activate)
+{
+	auto start = std::chrono::steady_clock::now();
+	bool result = true;
+
+	//hooks that actually need writing, a label can show up more than once
+	std::vector<int> toWrite;
+	for (const std::string& label : labels)
+	{
+		int index = GetHookStructIndex(label.c_str());
+		if (index == -1)
+		{
+			LOG(2, "%s hook not found!\n", label.c_str());
+			result = false;
+			continue;
+		}
+
+		functionhook_t& hook = hooks[index];
+		if (hook.activated == activate || std::find(toWrite.begin(), toWrite.end(), index) != toWrite.end())
+			continue;
+
+		if (!hook.startAddress || (activate && (hook.length < 5 || hook.length > MAX_LENGTH)))
+		{
+			LOG(2, "%s hook failed.\n", label.c_str());
+			result = false;
+			continue;
+		}
+
+		toWrite.push_back(index);
+	}
+
+	//pages the hooks sit on, merged into runs so each run gets unprotected once
+	const DWORD pageMask = 0xFFF;
+	std::vector<std::pair<DWORD, DWORD>> pageRuns;
+	for (int index : toWrite)
+	{
+		DWORD first = hooks[index].startAddress & ~pageMask;
+		DWORD last = (hooks[index].startAddress + hooks[index].length - 1) | pageMask;
+		pageRuns.push_back(std::make_pair(first, last));
+	}
+	std::sort(pageRuns.begin(), pageRuns.end());
+
+	std::vector<std::pair<DWORD, DWORD>> merged;
+	for (const auto& run : pageRuns)
+	{
+		if (!merged.empty() && run.first <= merged.back().second + 1)
+			merged.back().second = max(merged.back().second, run.second);
+		else
+			merged.push_back(run);
+	}
+
+	std::vector<DWORD> oldProtections(merged.size(), 0);
+	std::vector<bool> unprotected(merged.size(), false);
+	for (size_t i = 0; i < merged.size(); i++)
+	{
+		unprotected[i] = VirtualProtect((void*)merged[i].first, merged[i].second - merged[i].first + 1,
+			PAGE_EXECUTE_READWRITE, &oldProtections[i]) != 0;
+	}
+
+	for (int index : toWrite)
+	{
+		functionhook_t& hook = hooks[index];
+
+		//skip hooks whose run couldn't be made writable
+		bool writable = false;
+		for (size_t i = 0; i < merged.size(); i++)
+		{
+			if (hook.startAddress >= merged[i].first && hook.startAddress <= merged[i].second)
+			{
+				writable = unprotected[i];
+				break;
+			}
+		}
+		if (!writable)
+		{
+			LOG(2, "%s hook failed.\n", hook.label.c_str());
+			result = false;
+			continue;
+		}
+
+		if (activate)
+			WriteJump((void*)hook.startAddress, hook.newFunc, hook.length);
+		else
+			memcpy((void*)hook.startAddress, hook.originalBytes, hook.length);
+
+		hook.activated = activate;
+	}
+
+	for (size_t i = 0; i < merged.size(); i++)
+	{
+		DWORD temp;
+		if (unprotected[i] && !VirtualProtect((void*)merged[i].first, merged[i].second - merged[i].first + 1, oldProtections[i], &temp))
+			result = false;
+	}
+
+	lastBatchUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+	LOG(2, "%s %d hooks with %d protection changes in %lldus\n", activate ? "Activated" : "Deactivated",
+		(int)toWrite.size(), (int)merged.size() * 2, lastBatchUs);
+
+	return result;
 }
 
 int HookManager::OverWriteBytesAtRVA(const DWORD rva, const char* newBytes, const int byteLen)
@@ -439,93 +597,304 @@ int HookManager::OverWriteBytesAtRVA(const DWORD rva, const char* newBytes, cons
   DWORD temp;
   if (!VirtualProtect((void*)addr, byteLength, curProtection, &temp))
     return 0;
-  
+
+  return 1;
 }
 
 int HookManager::OverWriteBytes(void* startAddress, void* endAddress, const char* pattern,
 	const char* mask, const char* newBytes)
 {
-	int overwrittenCount = 0;
+	const unsigned char* base = (const unsigned char*)startAddress;
+	const size_t size = (DWORD)endAddress - (DWORD)startAddress;
+	const size_t patternLength = strlen(mask);
 
-	DWORD base = (DWORD)startAddress;
-	DWORD size = (DWORD)endAddress - (DWORD)startAddress;
+	//find every match first so the range only gets unprotected once
+	std::vector<unsigned char*> matches;
+	for (size_t offset = 0; offset + patternLength <= size;)
+	{
+		const unsigned char* match = PatternScanner::FindFirst(base + offset, size - offset, pattern, mask);
+		if (!match)
+			break;
 
-	//Get length for our mask, this will allow us to loop through our array
-	DWORD patternLength = (DWORD)strlen(mask);
+		matches.push_back((unsigned char*)match);
+		offset = match - base + 1;
+	}
 
-	for (DWORD i = 0; i < size - patternLength; i++)
+	if (matches.empty())
+		return 0;
+
+	unsigned char* first = matches.front();
+	size_t length = matches.back() + patternLength - first;
+
+	DWORD curProtection;
+	if (!VirtualProtect(first, length, PAGE_EXECUTE_READWRITE, &curProtection))
+		return 0;
+
+	for (unsigned char* match : matches)
 	{
-		bool found = true;
-		for (DWORD j = 0; j < patternLength; j++)
-		{
-			//if we have a ? in our mask then we have true by default, 
-			//or if the bytes match then we keep searching until finding it or not
-			found &= mask[j] == '?' || pattern[j] == *(char*)(base + i + j);
-		}
-		//found = true, our entire pattern was found
-		//return the memory addy so we can write to it
-		if (found)
-		{
-			char* toOverwrite = (char*)base + i;
+		memcpy(match, newBytes, patternLength);
+	}
 
-			DWORD curProtection;
-			if (!VirtualProtect(toOverwrite, patternLength, PAGE_EXECUTE_READWRITE, &curProtection))
-				return overwrittenCount;
+	DWORD temp;
+	VirtualProtect(first, length, curProtection, &temp);
 
-			for (int k = 0; k < patternLength; k++)
-			{
-				*((BYTE*)(toOverwrite + k)) = newBytes[k];
-			}
+	return (int)matches.size();
+}
+
+DWORD HookManager::FindPattern(const char* pattern, const char* mask)
+{
+	//answered by the batched scan if the pattern was collected for it
+	int id = patternScanner.FindPatternId(pattern, mask);
+	if (patternScanner.IsScanned(id))
+	{
+		return (DWORD)patternScanner.GetMatch(id);
+	}
 
-			overwrittenCount++;
+	//Having the values right is ESSENTIAL, this makes sure
+	//that we don't scan unwanted memory and leading our game to crash
+	DWORD base = 0;
+	DWORD size = 0;
+	if (!GetModuleRange(base, size))
+		return 0;
 
-			DWORD temp;
-			if (!VirtualProtect(toOverwrite, patternLength, curProtection, &temp))
-				return overwrittenCount;
-		}
+	return (DWORD)PatternScanner::FindFirst((const unsigned char*)base, size, pattern, mask);
+}
+
+bool HookManager::GetModuleRange(DWORD& base, DWORD& size)
+{
+	static DWORD moduleBase = 0;
+	static DWORD moduleSize = 0;
+
+	if (!moduleBase)
+	{
+		////////
+		//Get all module related information
+		//Get process name
+		TCHAR szFileName[MAX_PATH + 1];
+		GetModuleFileName(NULL, szFileName, MAX_PATH + 1);
+
+		MODULEINFO modinfo = { 0 };
+		HMODULE hModule = GetModuleHandle(szFileName);
+		if (hModule == 0)
+			return false;
+		GetModuleInformation(GetCurrentProcess(), hModule, &modinfo, sizeof(MODULEINFO));
+		////////
+
+		moduleBase = (DWORD)modinfo.lpBaseOfDll;
+		moduleSize = (DWORD)modinfo.SizeOfImage;
 	}
-	return overwrittenCount;
+
+	base = moduleBase;
+	size = moduleSize;
+	return moduleBase != 0;
 }
 
-DWORD HookManager::FindPattern(const char* pattern, const char* mask)
+void HookManager::BeginPatternCollection()
 {
-	////////
-	//Get all module related information
-	//Get process name
-	TCHAR szFileName[MAX_PATH + 1];
-	GetModuleFileName(NULL, szFileName, MAX_PATH + 1);
+	LOG(2, "HookManager::BeginPatternCollection\n");
+	isCollectingPatterns = true;
+}
 
-	MODULEINFO modinfo = { 0 };
-	HMODULE hModule = GetModuleHandle(szFileName);
-	if (hModule == 0)
+int HookManager::ScanCollectedPatterns()
+{
+	isCollectingPatterns = false;
+
+	DWORD base = 0;
+	DWORD size = 0;
+	if (!GetModuleRange(base, size))
+	{
+		LOG(2, "ScanCollectedPatterns: module not found\n");
 		return 0;
-	GetModuleInformation(GetCurrentProcess(), hModule, &modinfo, sizeof(MODULEINFO));
-	////////
+	}
 
-	//Assign our base and module size
-	//Having the values right is ESSENTIAL, this makes sure
-	//that we don't scan unwanted memory and leading our game to crash
-	DWORD base = (DWORD)modinfo.lpBaseOfDll;
-	DWORD size = (DWORD)modinfo.SizeOfImage;
+	auto start = std::chrono::steady_clock::now();
+	uint64_t codeHash = HashCodeSections(base);
 
-	//Get length for our mask, this will allow us to loop through our array
-	DWORD patternLength = (DWORD)strlen(mask);
+	signatureCacheUsed = ResolveFromSignatureCache(codeHash, base, size);
+	if (!signatureCacheUsed)
+	{
+		patternScanner.ResetMatches();
+		patternScanner.Scan((const unsigned char*)base, size);
+		if (!SaveSignatureCache(codeHash, base))
+			LOG(2, "ScanCollectedPatterns: could not write %s\n", SIGNATURE_CACHE_PATH);
+	}
+	lastScanMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	int found = patternScanner.GetMatchCount();
+	LOG(2, "ScanCollectedPatterns: %d/%d patterns found in %.2fms (%s)\n", found, patternScanner.GetPatternCount(), lastScanMs,
+		signatureCacheUsed ? "cached" : "scanned");
+	return found;
+}
+
+uint64_t HookManager::HashCodeSections(DWORD base)
+{
+	IMAGE_DOS_HEADER* dosHeader = (IMAGE_DOS_HEADER*)base;
+	if (dosHeader->e_magic != IMAGE_DOS_SIGNATURE)
+		return 0;
 
-	for (DWORD i = 0; i < size - patternLength; i++)
+	IMAGE_NT_HEADERS* ntHeaders = (IMAGE_NT_HEADERS*)(base + dosHeader->e_lfanew);
+	if (ntHeaders->Signature != IMAGE_NT_SIGNATURE)
+		return 0;
+
+	//ranges of the hooks placed so far (SteamAPI_Init ones), sorted so they can be stepped over in order
+	std::vector<std::pair<DWORD, DWORD>> skipped;
+	for (const functionhook_t& hook : hooks)
+	{
+		if (hook.activated && hook.startAddress)
+			skipped.push_back(std::make_pair(hook.startAddress, hook.startAddress + hook.length));
+	}
+	std::sort(skipped.begin(), skipped.end());
+
+	uint64_t hash = FNV1A64_OFFSET;
+	IMAGE_SECTION_HEADER* section = IMAGE_FIRST_SECTION(ntHeaders);
+	for (int i = 0; i < ntHeaders->FileHeader.NumberOfSections; i++, section++)
 	{
-		bool found = true;
-		for (DWORD j = 0; j < patternLength; j++)
+		if (!(section->Characteristics & IMAGE_SCN_CNT_CODE))
+			continue;
+
+		DWORD cur = base + section->VirtualAddress;
+		DWORD end = cur + section->Misc.VirtualSize;
+		hash = fnv1a64_mix(hash, section->VirtualAddress);
+		hash = fnv1a64_mix(hash, section->Misc.VirtualSize);
+
+		size_t k = 0;
+		while (cur < end)
+		{
+			while (k < skipped.size() && skipped[k].second <= cur)
+				k++;
+
+			//hash up to the next hook, then jump over it
+			DWORD segmentEnd = end;
+			if (k < skipped.size() && skipped[k].first < end)
+				segmentEnd = max(skipped[k].first, cur);
+
+			hash = fnv1a64_words((void*)cur, segmentEnd - cur, hash);
+			cur = segmentEnd;
+
+			if (cur < end)
+				cur = min(skipped[k].second, end);
+		}
+	}
+	return hash;
+}
+
+uint64_t HookManager::HashPattern(const char* pattern, const char* mask)
+{
+	//the pattern can hold zeroes, its length is the mask's
+	size_t length = strlen(mask);
+	return fnv1a64(pattern, length, fnv1a64(mask, length));
+}
+
+bool HookManager::ResolveFromSignatureCache(uint64_t codeHash, DWORD base, DWORD size)
+{
+	if (!codeHash)
+		return false;
+
+	std::ifstream in(SIGNATURE_CACHE_PATH, std::ios::binary);
+	if (!in)
+		return false;
+
+	//header: magic, uint32 version, uint64 code hash, uint32 entry count
+	char magic[4];
+	uint32_t version = 0;
+	uint64_t cachedHash = 0;
+	uint32_t count = 0;
+	in.read(magic, 4);
+	in.read((char*)&version, sizeof(version));
+	in.read((char*)&cachedHash, sizeof(cachedHash));
+	in.read((char*)&count, sizeof(count));
+	if (!in || memcmp(magic, SIGNATURE_CACHE_MAGIC, 4) != 0 || version != SIGNATURE_CACHE_VERSION || cachedHash != codeHash)
+	{
+		LOG(2, "Signature cache missing or out of date\n");
+		return false;
+	}
+
+	//entries: uint8 label length, label, uint64 pattern hash, uint32 RVA (0 if the pattern wasn't in the exe)
+	std::unordered_map<std::string, std::pair<uint64_t, DWORD>> rvas;
+	for (uint32_t i = 0; i < count; i++)
+	{
+		uint8_t length = 0;
+		char label[256];
+		uint64_t patternHash = 0;
+		DWORD rva = 0;
+		in.read((char*)&length, 1);
+		in.read(label, length);
+		in.read((char*)&patternHash, sizeof(patternHash));
+		in.read((char*)&rva, sizeof(rva));
+		if (!in)
+			return false;
+		rvas[std::string(label, length)] = std::make_pair(patternHash, rva);
+	}
+
+	for (const collectedpattern_t& collected : collectedPatterns)
+	{
+		auto entry = rvas.find(collected.label);
+		if (entry == rvas.end() || entry->second.first != collected.patternHash)
+		{
+			//a changed pattern may match somewhere else, or no longer be missing
+			LOG(2, "Signature cache has no entry for the current pattern of %s\n", collected.label.c_str());
+			return false;
+		}
+		DWORD rva = entry->second.second;
+
+		//same code hash and pattern, a pattern that wasn't there last time still isn't
+		if (rva == 0)
 		{
-			//if we have a ? in our mask then we have true by default, 
-			//or if the bytes match then we keep searching until finding it or not
-			found &= mask[j] == '?' || pattern[j] == *(char*)(base + i + j);
+			patternScanner.SetNotFound(collected.patternId);
+			continue;
 		}
-		//found = true, our entire pattern was found
-		//return the memory addy so we can write to it
-		if (found)
+
+		if (!patternScanner.Verify(collected.patternId, (const unsigned char*)base, size, rva))
 		{
-			return base + i;
+			LOG(2, "Signature cache entry for %s doesn't match at 0x%x\n", collected.label.c_str(), rva);
+			return false;
 		}
 	}
-	return NULL;
+
+	return true;
+}
+
+bool HookManager::SaveSignatureCache(uint64_t codeHash, DWORD base)
+{
+	if (!codeHash)
+		return false;
+
+	std::ofstream out(SIGNATURE_CACHE_PATH, std::ios::binary | std::ios::trunc);
+	if (!out)
+		return false;
+
+	uint32_t version = SIGNATURE_CACHE_VERSION;
+	uint32_t count = collectedPatterns.size();
+	out.write(SIGNATURE_CACHE_MAGIC, 4);
+	out.write((char*)&version, sizeof(version));
+	out.write((char*)&codeHash, sizeof(codeHash));
+	out.write((char*)&count, sizeof(count));
+
+	for (const collectedpattern_t& collected : collectedPatterns)
+	{
+		const unsigned char* match = patternScanner.GetMatch(collected.patternId);
+		uint8_t length = (uint8_t)min(collected.label.size(), (size_t)255);
+		DWORD rva = match ? (DWORD)match - base : 0;
+		out.write((char*)&length, 1);
+		out.write(collected.label.c_str(), length);
+		out.write((char*)&collected.patternHash, sizeof(collected.patternHash));
+		out.write((char*)&rva, sizeof(rva));
+	}
+
+	return (bool)out;
 }
+
+int HookManager::GetCollectedPatternCount()
+{
+	return patternScanner.GetPatternCount();
+}
+
+double HookManager::GetLastScanMs()
+{
+	return lastScanMs;
+}
+
+bool HookManager::WasSignatureCacheUsed()
+{
+	return signatureCacheUsed;
+}
\ No newline at end of file
@@ -1,10 +1,19 @@
 #pragma once
+#include "PatternScanner.h"
+
+#include "Core/hash.h"
+
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <Windows.h>
 
 #define MAX_LENGTH 32
 
+#define SIGNATURE_CACHE_PATH "BBCF_IM\\SignatureCache.bin"
+#define SIGNATURE_CACHE_MAGIC "SIGC"
+#define SIGNATURE_CACHE_VERSION 2
+
 typedef DWORD JMPBACKADDR;
 
 struct functionhook_t
@@ -29,6 +38,11 @@ public:
 	static bool IsHookActivated(const char* label);
 	static bool ActivateHook(const char* label); //0 hook not found, 1 success
 	static bool DeactivateHook(const char* label); // 0 hook not found, 1 success
+	/* Batched versions, every page touched by the hooks is unprotected once for the whole set instead of twice per hook.
+	   Returns false if any of the hooks wasn't found or couldn't be written, the rest are still toggled */
+	static bool ActivateHooks(const std::vector<std::string>& labels);
+	static bool DeactivateHooks(const std::vector<std::string>& labels);
+	static long long GetLastBatchUs();
 	static JMPBACKADDR GetJmpBackAddr(const char* label); /* do not call this whenever you want to jump back
 														  searching through the array each time is bad for performance,
 														  use this func ONCE to store the address in a variable*/
@@ -40,11 +54,45 @@ public:
   static int OverWriteBytesAtRVA(const DWORD rva, const char* newBytes, const int byteLength);
 	static int OverWriteBytes(void* startAddress, void* endAddress, const char* pattern, const char* mask, const char* newBytes);
 	static void Cleanup(); //empty atm
+
+	/* Signature batching: between these two calls SetHook/RegisterHook only collect their patterns and hook nothing,
+	   ScanCollectedPatterns then resolves all of them in one pass over the module. Running the placeHooks functions
+	   again afterwards hooks as usual, with FindPattern answered from the scan's results.
+	   The results are saved to SIGNATURE_CACHE_PATH as label -> RVA under a hash of the exe's code sections, when the
+	   hash matches on a later launch the cached addresses are only checked against their patterns in place.
+	   Each entry also keeps a hash of its pattern and mask, an entry whose pattern changed since counts as missing */
+	static void BeginPatternCollection();
+	static int ScanCollectedPatterns(); //returns how many of the collected patterns were found
+	static int GetCollectedPatternCount();
+	static double GetLastScanMs();
+	static bool WasSignatureCacheUsed(); //false if the last ScanCollectedPatterns had to scan
 private:
 	static std::vector<functionhook_t> hooks; //stores hook structs
+	static HashSlots hookSlots; //hooks by label hash
+	static long long lastBatchUs;
+	static PatternScanner patternScanner;
+	static bool isCollectingPatterns;
+	static double lastScanMs;
+	static bool signatureCacheUsed;
+
+	struct collectedpattern_t
+	{
+		std::string label;
+		int patternId;
+		uint64_t patternHash; //of the mask and the pattern bytes it covers
+	};
+	static std::vector<collectedpattern_t> collectedPatterns;
 	static int GetHookStructIndex(const char* label); //returns the index of hook struct
+	static int AddHookStruct(const char* label); //appends a hook struct and indexes its label
+	static bool SetHooksActivated(const std::vector<std::string>& labels, bool activate);
+	static void WriteJump(void* toHook, void* ourFunc, int len); //page has to be writable already
 	static bool SaveOriginalBytes(int hookIndex, void* startAddress, int len);
 	static bool PlaceHook(void* toHook, void* ourFunc, int len);
 	static bool RestoreOriginalBytes(int functionhook_index);
 	static DWORD FindPattern(const char* pattern, const char* mask);
+	static uint64_t HashPattern(const char* pattern, const char* mask);
+	static bool GetModuleRange(DWORD& base, DWORD& size); //queried once, the exe doesn't move
+	static uint64_t HashCodeSections(DWORD base); //hooks already in place are left out, their bytes point into our dll
+	static bool ResolveFromSignatureCache(uint64_t codeHash, DWORD base, DWORD size);
+	static bool SaveSignatureCache(uint64_t codeHash, DWORD base);
 };
@@ -1,12 +1,15 @@
 #pragma once
+#include "BytePatch.h"
+
+#include <string>
+#include <vector>
 
 struct Patch
 {
   const char* name;
   const char* tooltip;
   bool* enabledSetting;
-  void (*enable)();
-  void (*disable)();
+  BytePatchGroup* group;
   std::string settingName;
   bool enabled = false;
 };
@@ -0,0 +1,254 @@
+#include "PatternScanner.h"
+
+#include <cstring>
+
+PatternScanner::PatternScanner()
+{
+	memset(m_anchorPairs, 0, sizeof(m_anchorPairs));
+}
+
+int PatternScanner::AddPattern(const char* pattern, const char* mask)
+{
+	size_t length = strlen(mask);
+	std::string key = MakeKey(pattern, mask, length);
+
+	auto it = m_ids.find(key);
+	if (it != m_ids.end())
+		return it->second;
+
+	Signature signature;
+	signature.bytes.assign(pattern, length);
+	signature.mask.assign(mask, length);
+	signature.anchorOffset = 0;
+	signature.anchorLength = 0;
+	signature.scanned = false;
+	signature.match = NULL;
+
+	// Anchor on the longest run of fixed bytes, the longer the run the less often the full compare gets tried
+	size_t bestStart = 0;
+	size_t bestLength = 0;
+	for (size_t i = 0; i < length;)
+	{
+		if (mask[i] == '?')
+		{
+			i++;
+			continue;
+		}
+
+		size_t start = i;
+		while (i < length && mask[i] != '?')
+			i++;
+
+		if (i - start > bestLength)
+		{
+			bestStart = start;
+			bestLength = i - start;
+		}
+	}
+	signature.anchorOffset = bestStart;
+	signature.anchorLength = bestLength < 2 ? bestLength : 2;
+
+	int id = (int)m_signatures.size();
+	m_signatures.push_back(signature);
+	m_ids[key] = id;
+	return id;
+}
+
+int PatternScanner::FindPatternId(const char* pattern, const char* mask) const
+{
+	auto it = m_ids.find(MakeKey(pattern, mask, strlen(mask)));
+	if (it == m_ids.end())
+		return -1;
+
+	return it->second;
+}
+
+void PatternScanner::Scan(const unsigned char* base, size_t size)
+{
+	int remaining = 0;
+	for (int id = 0; id < (int)m_signatures.size(); id++)
+	{
+		Signature& signature = m_signatures[id];
+		if (signature.scanned)
+			continue;
+
+		if (signature.anchorLength == 0)
+		{
+			// Nothing to look for, same as a plain scan it matches at the very start
+			signature.scanned = true;
+			signature.match = size >= signature.mask.size() ? base : NULL;
+			continue;
+		}
+
+		unsigned char first = (unsigned char)signature.bytes[signature.anchorOffset];
+		m_byAnchorByte[first].push_back(id);
+		if (signature.anchorLength > 1)
+		{
+			unsigned int pair = first | (unsigned char)signature.bytes[signature.anchorOffset + 1] << 8;
+			m_anchorPairs[pair >> 5] |= 1u << (pair & 31);
+		}
+		else
+		{
+			// Any second byte will do
+			for (unsigned int second = 0; second < 256; second++)
+			{
+				unsigned int pair = first | second << 8;
+				m_anchorPairs[pair >> 5] |= 1u << (pair & 31);
+			}
+		}
+		remaining++;
+	}
+
+	for (size_t i = 0; i < size && remaining > 0; i++)
+	{
+		unsigned int pair = base[i] | (i + 1 < size ? base[i + 1] : 0) << 8;
+		if (!(m_anchorPairs[pair >> 5] & (1u << (pair & 31))))
+			continue;
+
+		// Resolved patterns leave their pair bit set, that only costs a look at the bucket
+		std::vector<int>& candidates = m_byAnchorByte[base[i]];
+		if (candidates.empty())
+			continue;
+
+		for (size_t k = 0; k < candidates.size();)
+		{
+			Signature& signature = m_signatures[candidates[k]];
+			const size_t length = signature.mask.size();
+
+			bool possible = i >= signature.anchorOffset && i - signature.anchorOffset + length <= size;
+			if (possible && signature.anchorLength > 1)
+				possible = base[i + 1] == (unsigned char)signature.bytes[signature.anchorOffset + 1];
+
+			const unsigned char* start = base + i - signature.anchorOffset;
+			if (possible && MatchesAt(start, signature))
+			{
+				signature.scanned = true;
+				signature.match = start;
+				candidates[k] = candidates.back();
+				candidates.pop_back();
+				remaining--;
+				continue;
+			}
+
+			k++;
+		}
+	}
+
+	// Whatever is left wasn't in the image
+	for (int b = 0; b < 256; b++)
+	{
+		for (int id : m_byAnchorByte[b])
+		{
+			m_signatures[id].scanned = true;
+			m_signatures[id].match = NULL;
+		}
+		m_byAnchorByte[b].clear();
+	}
+	memset(m_anchorPairs, 0, sizeof(m_anchorPairs));
+}
+
+bool PatternScanner::Verify(int id, const unsigned char* base, size_t size, size_t offset)
+{
+	if (id < 0 || id >= (int)m_signatures.size())
+		return false;
+
+	Signature& signature = m_signatures[id];
+	if (offset > size || size - offset < signature.mask.size() || !MatchesAt(base + offset, signature))
+		return false;
+
+	signature.scanned = true;
+	signature.match = base + offset;
+	return true;
+}
+
+void PatternScanner::SetNotFound(int id)
+{
+	if (id < 0 || id >= (int)m_signatures.size())
+		return;
+
+	m_signatures[id].scanned = true;
+	m_signatures[id].match = NULL;
+}
+
+void PatternScanner::ResetMatches()
+{
+	for (Signature& signature : m_signatures)
+	{
+		signature.scanned = false;
+		signature.match = NULL;
+	}
+}
+
+bool PatternScanner::IsScanned(int id) const
+{
+	return id >= 0 && id < (int)m_signatures.size() && m_signatures[id].scanned;
+}
+
+const unsigned char* PatternScanner::GetMatch(int id) const
+{
+	if (!IsScanned(id))
+		return NULL;
+
+	return m_signatures[id].match;
+}
+
+int PatternScanner::GetPatternCount() const
+{
+	return (int)m_signatures.size();
+}
+
+int PatternScanner::GetMatchCount() const
+{
+	int count = 0;
+	for (const Signature& signature : m_signatures)
+	{
+		if (signature.match)
+			count++;
+	}
+	return count;
+}
+
+void PatternScanner::Clear()
+{
+	m_signatures.clear();
+	m_ids.clear();
+	for (int b = 0; b < 256; b++)
+		m_byAnchorByte[b].clear();
+	memset(m_anchorPairs, 0, sizeof(m_anchorPairs));
+}
+
+const unsigned char* PatternScanner::FindFirst(const unsigned char* base, size_t size, const char* pattern, const char* mask)
+{
+	size_t length = strlen(mask);
+	if (length > size)
+		return NULL;
+
+	for (size_t i = 0; i + length <= size; i++)
+	{
+		size_t j = 0;
+		while (j < length && (mask[j] == '?' || (unsigned char)pattern[j] == base[i + j]))
+			j++;
+
+		if (j == length)
+			return base + i;
+	}
+	return NULL;
+}
+
+std::string PatternScanner::MakeKey(const char* pattern, const char* mask, size_t length)
+{
+	std::string key(pattern, length);
+	key.append(mask, length);
+	return key;
+}
+
+bool PatternScanner::MatchesAt(const unsigned char* at, const Signature& signature)
+{
+	const size_t length = signature.mask.size();
+	for (size_t j = 0; j < length; j++)
+	{
+		if (signature.mask[j] != '?' && (unsigned char)signature.bytes[j] != at[j])
+			return false;
+	}
+	return true;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*
+	Resolves a batch of signatures (pattern + mask, '?' in the mask is a wildcard) in a single pass over an image.
+	Every pattern is anchored on two bytes of its longest non-wildcard run, the scan only looks at the patterns
+	whose anchor matches the current byte pair and compares the rest with an early exit. Patterns drop out
+	of the index once they are found and the scan stops when none are left, so the cost is closer to one pass over
+	the image than one pass per pattern. No Windows dependencies so it can be benchmarked offline, see tools/SigScanBench.
+*/
+class PatternScanner
+{
+public:
+	PatternScanner();
+
+	// Returns the pattern's id, adding the same pattern and mask again gives back the same id
+	int AddPattern(const char* pattern, const char* mask);
+	int FindPatternId(const char* pattern, const char* mask) const; // -1 if it was never added
+
+	// Finds the first match of every pattern, patterns already resolved by an earlier Scan are kept
+	void Scan(const unsigned char* base, size_t size);
+
+	// Takes a match from elsewhere (a cache) if the pattern's bytes are at offset, returns false and leaves it unscanned if not
+	bool Verify(int id, const unsigned char* base, size_t size, size_t offset);
+	void SetNotFound(int id);
+	void ResetMatches(); // back to unscanned, the patterns stay
+
+	bool IsScanned(int id) const;
+	const unsigned char* GetMatch(int id) const; // NULL if not found
+	int GetPatternCount() const;
+	int GetMatchCount() const;
+	void Clear();
+
+	// Plain scan for one pattern, bails out of each offset on the first mismatching byte
+	static const unsigned char* FindFirst(const unsigned char* base, size_t size, const char* pattern, const char* mask);
+
+private:
+	struct Signature
+	{
+		std::string bytes;
+		std::string mask;
+		size_t anchorOffset; // where the anchor starts inside the pattern
+		size_t anchorLength; // 0 for a pattern of wildcards only, 1 if the longest run is a single byte
+		bool scanned;
+		const unsigned char* match;
+	};
+
+	std::vector<Signature> m_signatures;
+	std::unordered_map<std::string, int> m_ids; // bytes + mask
+	std::vector<int> m_byAnchorByte[256]; // unresolved pattern ids, by the first byte of their anchor
+	uint32_t m_anchorPairs[65536 / 32]; // bit per (first, second) anchor byte pair still looked for, most offsets stop here
+
+	static std::string MakeKey(const char* pattern, const char* mask, size_t length);
+	static bool MatchesAt(const unsigned char* at, const Signature& signature);
+};
@@ -20,23 +20,76 @@ NetworkManager::~NetworkManager()
 
 bool NetworkManager::SendPacket(CSteamID* steamID, Packet* packet)
 {
-	LOG(2, "NetworkManager::SendPacket\n");
+	return SendPackets(steamID, &packet, 1);
+}
+
+bool NetworkManager::SendPackets(CSteamID* steamID, Packet** packets, int count)
+{
+	LOG(2, "NetworkManager::SendPackets (%d)\n", count);
+
+	m_sendStats.batches++;
+
+	const uint64_t ownSteamID = m_steamID.ConvertToUint64();
+	const EP2PSend sendType = k_EP2PSendUnreliable;
+	bool result = true;
+
+	for (int i = 0; i < count; i++)
+	{
+		Packet* packet = packets[i];
+		packet->steamID = ownSteamID;
+
+		// One line per packet, the old hex dumps of every header field cost more than the send itself
+		LOG(2, "\tSending packet: version: %u, packetType: %u, part: %u, packetSize: %u, roomPlayerIndex: %u, dataSize: %u\n",
+			packet->version, packet->packetType, packet->part, packet->packetSize, packet->roomMemberIndex, packet->dataSize);
+
+		if (m_pSteamNetworking->SendP2PPacket(*steamID, packet, packet->packetSize, sendType, 0))
+		{
+			m_sendStats.packets++;
+			m_sendStats.bytes += packet->packetSize;
+		}
+		else
+		{
+			m_sendStats.failed++;
+			result = false;
+		}
+	}
+
+	return result;
+}
+
+Packet* NetworkManager::AcquirePacket()
+{
+	if (m_packetPool.empty())
+	{
+		return new Packet();
+	}
 
-	packet->steamID = m_steamID.ConvertToUint64();
+	Packet* packet = m_packetPool.back().release();
+	m_packetPool.pop_back();
+	return packet;
+}
+
+void NetworkManager::ReleasePacket(Packet* packet)
+{
+	if (packet)
+	{
+		m_packetPool.emplace_back(packet);
+	}
+}
 
-	LOG(2, "\tSending packet:\n");
-	LOG(2, "\tversion: %s\n", RawMemoryArrayToString((unsigned char*)&packet->version, sizeof(packet->version)));
-	LOG(2, "\tpacketType: %s\n", RawMemoryArrayToString((unsigned char*)&packet->packetType, sizeof(packet->packetType)));
-	LOG(2, "\tpart: %s\n", RawMemoryArrayToString((unsigned char*)&packet->part, sizeof(packet->part)));
-	LOG(2, "\tpacketSize: %s\n", RawMemoryArrayToString((unsigned char*)&packet->packetSize, sizeof(packet->packetSize)));
-	LOG(2, "\troomPlayerIndex: %s\n", RawMemoryArrayToString((unsigned char*)&packet->roomMemberIndex, sizeof(packet->roomMemberIndex)));
-	LOG(2, "\tsteamID: %s\n", RawMemoryArrayToString((unsigned char*)&packet->steamID, sizeof(packet->steamID)));
-	LOG(2, "\tdataSize: %s\n", RawMemoryArrayToString((unsigned char*)&packet->dataSize, sizeof(packet->dataSize)));
-	//LOG(2, "\tdata: %s\n", RawMemoryArrayToString((unsigned char*)&packet->data, sizeof(packet->data)));
+int NetworkManager::GetPooledPacketCount() const
+{
+	return (int)m_packetPool.size();
+}
 
-	EP2PSend sendType = k_EP2PSendUnreliable;
+const NetworkSendStats& NetworkManager::GetSendStats() const
+{
+	return m_sendStats;
+}
 
-	return m_pSteamNetworking->SendP2PPacket(*steamID, packet, packet->packetSize, sendType, 0);
+void NetworkManager::ResetSendStats()
+{
+	m_sendStats = NetworkSendStats();
 }
 
 void NetworkManager::RecvPacket(Packet* packet)
@@ -107,4 +160,22 @@ void NetworkManager::RecvPacket(Packet* packet)
 bool NetworkManager::IsIMPacket(Packet* packet)
 {
 	return packet->version == IM_PACKET_VERSION;
+}
+
+LoopbackSteamNetworking::LoopbackSteamNetworking()
+	: SteamNetworkingWrapper()
+{
+}
+
+bool LoopbackSteamNetworking::SendP2PPacket(CSteamID steamIDRemote, const void *pubData, uint32 cubData, EP2PSend eP2PSendType, int nChannel)
+{
+	const Packet* packet = (const Packet*)pubData;
+	if (cubData > sizeof(Packet) || packet->packetSize != cubData || packet->__packetSize != cubData)
+	{
+		malformed++;
+	}
+
+	packets++;
+	bytes += cubData;
+	return true;
 }
\ No newline at end of file
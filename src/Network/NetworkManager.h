@@ -4,6 +4,16 @@
 #include "SteamApiWrapper/SteamNetworkingWrapper.h"
 
 #include <steam_api.h>
+#include <memory>
+#include <vector>
+
+struct NetworkSendStats
+{
+	uint32_t packets = 0;
+	uint32_t bytes = 0;
+	uint32_t batches = 0; // a SendPacket call is a batch of one
+	uint32_t failed = 0;
+};
 
 class NetworkManager
 {
@@ -11,11 +21,35 @@ public:
 	NetworkManager(SteamNetworkingWrapper* SteamNetworking, CSteamID steamID);
 	~NetworkManager();
 	bool SendPacket(CSteamID* steamID, Packet* packet);
+	// Sends every part of a multi-part payload to one player back to back, returns false if any of them failed
+	bool SendPackets(CSteamID* steamID, Packet** packets, int count);
 	void RecvPacket(Packet* packet);
 	bool IsIMPacket(Packet* packet);
 
+	// Packets from the pool, for payloads built once and sent to several players. Give them back with ReleasePacket
+	Packet* AcquirePacket();
+	void ReleasePacket(Packet* packet);
+	int GetPooledPacketCount() const;
+
+	const NetworkSendStats& GetSendStats() const;
+	void ResetSendStats();
+
 private:
 
 	SteamNetworkingWrapper* m_pSteamNetworking;
 	CSteamID m_steamID;
-};
\ No newline at end of file
+	std::vector<std::unique_ptr<Packet>> m_packetPool;
+	NetworkSendStats m_sendStats;
+};
+
+// Stands in for Steam when measuring what the packet path sends, nothing leaves the machine
+class LoopbackSteamNetworking : public SteamNetworkingWrapper
+{
+public:
+	LoopbackSteamNetworking();
+	bool SendP2PPacket(CSteamID steamIDRemote, const void *pubData, uint32 cubData, EP2PSend eP2PSendType, int nChannel = 0) override;
+
+	uint32_t packets = 0;
+	uint32_t bytes = 0;
+	uint32_t malformed = 0; // packets whose size fields don't match what was sent
+};
@@ -4,6 +4,9 @@
 
 #include "Core/logger.h"
 #include "Core/interfaces.h"
+
+#include <chrono>
+
 OnlinePaletteManager::OnlinePaletteManager(PaletteManager* pPaletteManager, CharPaletteHandle* pP1CharPalHandle,
 	CharPaletteHandle* pP2CharPalHandle, RoomManager* pRoomManager)
 	: m_pPaletteManager(pPaletteManager), m_pP1CharPalHandle(pP1CharPalHandle), 
@@ -21,8 +24,27 @@ void OnlinePaletteManager::SendPalettePackets()
 	uint16_t thisPlayerMatchPlayerIndex = m_pRoomManager->GetThisPlayerMatchPlayerIndex();
 	CharPaletteHandle& charPalHandle = GetPlayerCharPaletteHandle(thisPlayerMatchPlayerIndex);
 
-	SendPaletteInfoPacket(charPalHandle, thisPlayerMatchPlayerIndex);
-	SendPaletteDataPackets(charPalHandle, thisPlayerMatchPlayerIndex);
+	SendPalettePackets(m_pRoomManager, g_interfaces.pNetworkManager, charPalHandle, thisPlayerMatchPlayerIndex);
+}
+
+void OnlinePaletteManager::SendPalettePackets(RoomManager* pRoomManager, NetworkManager* pNetworkManager,
+	CharPaletteHandle& charPalHandle, uint16_t matchPlayerIndex)
+{
+	Packet* packets[PALETTE_PACKETS_COUNT];
+	for (int i = 0; i < PALETTE_PACKETS_COUNT; i++)
+	{
+		packets[i] = pNetworkManager->AcquirePacket();
+	}
+
+	// Same packets on the wire as before, just filled once and sent as one batch per player
+	FillPaletteInfoPacket(packets[0], charPalHandle, matchPlayerIndex);
+	FillPaletteDataPackets(packets + 1, charPalHandle, matchPlayerIndex);
+	pRoomManager->SendPacketsToSameMatchIMPlayers(packets, PALETTE_PACKETS_COUNT);
+
+	for (int i = 0; i < PALETTE_PACKETS_COUNT; i++)
+	{
+		pNetworkManager->ReleasePacket(packets[i]);
+	}
 }
 
 void OnlinePaletteManager::RecvPaletteDataPacket(Packet* packet)
@@ -86,41 +108,99 @@ void OnlinePaletteManager::OnMatchInit()
 {
 	LOG(2, "OnlinePaletteManager::OnMatchInit\n");
 
+	g_interfaces.pNetworkManager->ResetSendStats();
 	SendPalettePackets();
 	ProcessSavedPalettePackets();
 }
 
-void OnlinePaletteManager::SendPaletteInfoPacket(CharPaletteHandle& charPalHandle, uint16_t roomMemberIndex)
+PaletteSendBenchmark OnlinePaletteManager::RunLoopbackSendBenchmark(int recipients, int iterations)
 {
-	LOG(2, "OnlinePaletteManager::SendPaletteInfoPacket\n");
+	LOG(2, "OnlinePaletteManager::RunLoopbackSendBenchmark\n");
+
+	PaletteSendBenchmark result;
+	if (recipients <= 0 || iterations <= 0)
+		return result;
+
+	// The palettes sent are P1's current ones, there's nothing to send before a character got loaded
+	if (m_pP1CharPalHandle->IsNullPointerPalBasePtr() || !g_interfaces.pSteamFriendsWrapper)
+		return result;
+
+	if (recipients > MAX_PLAYERS_IN_ROOM - 1)
+		recipients = MAX_PLAYERS_IN_ROOM - 1;
+
+	// A room with this player as P1 and every recipient in the same match, the rest of them spectating
+	const uint64_t thisSteamID = 1;
+	Room room = {};
+	room.roomStatus = RoomStatus_Functional;
+	room.roomType = RoomType_Lobby;
+	room.memberCount = (uint8_t)(recipients + 1);
+	for (int i = 0; i <= recipients; i++)
+	{
+		RoomMemberEntry* pMember = &room.member1 + i;
+		pMember->memberIndex = (uint8_t)i;
+		pMember->steamId = thisSteamID + i;
+		pMember->matchId = 1;
+		pMember->matchPlayerIndex = (uint8_t)i;
+	}
 
-	Packet packet = Packet(
+	LoopbackSteamNetworking loopback;
+	NetworkManager networkManager(&loopback, CSteamID(thisSteamID));
+	RoomManager roomManager(&networkManager, g_interfaces.pSteamFriendsWrapper, CSteamID(thisSteamID));
+	roomManager.JoinRoom(&room);
+	for (int i = 1; i <= recipients; i++)
+	{
+		Packet ackPacket(NULL, 0, PacketType_IMID_Acknowledge, (uint16_t)i);
+		ackPacket.steamID = thisSteamID + i;
+		roomManager.AcceptAcknowledge(&ackPacket);
+	}
+
+	// Only count the palette packets, not the announces from joining
+	loopback.packets = 0;
+	loopback.bytes = 0;
+	loopback.malformed = 0;
+
+	auto start = std::chrono::steady_clock::now();
+	for (int iteration = 0; iteration < iterations; iteration++)
+	{
+		SendPalettePackets(&roomManager, &networkManager, *m_pP1CharPalHandle, 0);
+	}
+	double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+	// Totals are for a single match init
+	result.packets = loopback.packets / iterations;
+	result.bytes = loopback.bytes / iterations;
+	result.malformed = loopback.malformed;
+	result.usPerMatchInit = us / iterations;
+	return result;
+}
+
+void OnlinePaletteManager::FillPaletteInfoPacket(Packet* packet, CharPaletteHandle& charPalHandle, uint16_t roomMemberIndex)
+{
+	LOG(2, "OnlinePaletteManager::FillPaletteInfoPacket\n");
+
+	packet->Set(
 		(char*)&m_pPaletteManager->GetCurrentPalInfo(charPalHandle),
 		(uint16_t)sizeof(IMPL_info_t),
 		PacketType_PaletteInfo,
 		roomMemberIndex
 	);
-
-	m_pRoomManager->SendPacketToSameMatchIMPlayers(&packet);
 }
 
-void OnlinePaletteManager::SendPaletteDataPackets(CharPaletteHandle& charPalHandle, uint16_t roomMemberIndex)
+void OnlinePaletteManager::FillPaletteDataPackets(Packet** packets, CharPaletteHandle& charPalHandle, uint16_t roomMemberIndex)
 {
-	LOG(2, "OnlinePaletteManager::SendPaletteDataPackets\n");
+	LOG(2, "OnlinePaletteManager::FillPaletteDataPackets\n");
 
 	for (int palFileIndex = 0; palFileIndex < IMPL_PALETTE_FILES_COUNT; palFileIndex++)
 	{
 		const char* palAddr = m_pPaletteManager->GetCurPalFileAddr((PaletteFile)palFileIndex, charPalHandle);
 
-		Packet packet = Packet(
+		packets[palFileIndex]->Set(
 			(char*)palAddr,
 			(uint16_t)IMPL_PALETTE_DATALEN,
 			PacketType_PaletteData,
 			roomMemberIndex,
 			palFileIndex
 		);
-
-		m_pRoomManager->SendPacketToSameMatchIMPlayers(&packet);
 	}
 }
 
@@ -6,6 +6,14 @@
 
 #include <queue>
 
+struct PaletteSendBenchmark
+{
+	uint32_t packets = 0;
+	uint32_t bytes = 0;
+	uint32_t malformed = 0;
+	double usPerMatchInit = 0.0;
+};
+
 class OnlinePaletteManager
 {
 public:
@@ -17,10 +25,18 @@ public:
 	void ProcessSavedPalettePackets();
 	void ClearSavedPalettePacketQueues();
 	void OnMatchInit();
+	// Runs the match init send path for P1's palettes in a made up room with that many other IM players,
+	// through a loopback wrapper so nothing goes out to Steam. Sends nothing before a character got loaded
+	PaletteSendBenchmark RunLoopbackSendBenchmark(int recipients, int iterations);
 
 private:
-	void SendPaletteInfoPacket(CharPaletteHandle& charPalHandle, uint16_t roomMemberIndex);
-	void SendPaletteDataPackets(CharPaletteHandle& charPalHandle, uint16_t roomMemberIndex);
+	// Info packet followed by one data packet per palette file
+	static constexpr int PALETTE_PACKETS_COUNT = 1 + IMPL_PALETTE_FILES_COUNT;
+
+	void SendPalettePackets(RoomManager* pRoomManager, NetworkManager* pNetworkManager,
+		CharPaletteHandle& charPalHandle, uint16_t matchPlayerIndex);
+	void FillPaletteInfoPacket(Packet* packet, CharPaletteHandle& charPalHandle, uint16_t roomMemberIndex);
+	void FillPaletteDataPackets(Packet** packets, CharPaletteHandle& charPalHandle, uint16_t roomMemberIndex);
 	void ProcessSavedPaletteInfoPackets();
 	void ProcessSavedPaletteDataPackets();
 	CharPaletteHandle& GetPlayerCharPaletteHandle(uint16_t matchPlayerIndex);
@@ -32,9 +32,26 @@ struct Packet
 	uint32_t dataSize;
 	unsigned char data[MAX_DATA_SIZE];
 
+	Packet()
+		: __packetSize(0), packetSize(0), packetType(PacketType_IMID_Announce), steamID(0), part(0), roomMemberIndex(0), dataSize(0)
+	{
+	}
+
 	Packet(void* dataSrc, uint16_t dataSize, PacketType packetType, uint16_t roomMemberIndex, uint16_t part = 0)
-		: dataSize(dataSize), packetType(packetType), roomMemberIndex(roomMemberIndex), part(part)
 	{
+		Set(dataSrc, dataSize, packetType, roomMemberIndex, part);
+	}
+
+	// Refills a packet, used for the ones NetworkManager keeps pooled
+	void Set(void* dataSrc, uint16_t dataSize, PacketType packetType, uint16_t roomMemberIndex, uint16_t part = 0)
+	{
+		this->dataSize = dataSize;
+		this->packetType = packetType;
+		this->roomMemberIndex = roomMemberIndex;
+		this->part = part;
+		version = IM_PACKET_VERSION;
+		steamID = 0;
+
 		// HeaderSize + dataSize
 		packetSize = sizeof(Packet) - MAX_DATA_SIZE + dataSize;
 		__packetSize = packetSize;
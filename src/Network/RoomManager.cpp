@@ -74,9 +74,18 @@ bool RoomManager::IsRoomFunctional() const
 
 void RoomManager::SendPacketToSameMatchIMPlayers(Packet* packet)
 {
-	LOG(2, "RoomManager::SendPacketToSameMatchIMPlayers\n");
+	SendPacketsToSameMatchIMPlayers(&packet, 1);
+}
 
-	packet->roomMemberIndex = GetThisPlayerRoomMemberIndex();
+void RoomManager::SendPacketsToSameMatchIMPlayers(Packet** packets, int count)
+{
+	LOG(2, "RoomManager::SendPacketsToSameMatchIMPlayers\n");
+
+	const uint16_t thisPlayerRoomMemberIndex = GetThisPlayerRoomMemberIndex();
+	for (int i = 0; i < count; i++)
+	{
+		packets[i]->roomMemberIndex = thisPlayerRoomMemberIndex;
+	}
 
 	for (IMPlayer& imPlayer : GetIMPlayersInCurrentMatch())
 	{
@@ -90,7 +99,7 @@ void RoomManager::SendPacketToSameMatchIMPlayers(Packet* packet)
 		// Send to all other IM players
 		if (!IsThisPlayer(imPlayer.steamID.ConvertToUint64()))
 		{
-			m_pNetworkManager->SendPacket(&imPlayer.steamID, packet);
+			m_pNetworkManager->SendPackets(&imPlayer.steamID, packets, count);
 		}
 	}
 }
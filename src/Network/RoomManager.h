@@ -44,6 +44,8 @@ public:
 	void JoinRoom(Room* pRoom);
 	bool IsRoomFunctional() const;
 	void SendPacketToSameMatchIMPlayers(Packet* packet);
+	// Recipients are resolved once for the whole batch, each of them gets every packet in order
+	void SendPacketsToSameMatchIMPlayers(Packet** packets, int count);
 	void SendPacketToSameMatchIMPlayersNonSpectator(Packet* packet);
 	bool IsPacketFromSameRoom(Packet* packet) const;
 	bool IsPacketFromSameMatchNonSpectator(Packet* packet) const;
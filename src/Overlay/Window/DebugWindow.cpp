@@ -232,24 +232,17 @@ void DebugWindow::DrawGameValuesSection()
 			snap_apparatus_debug->load_snapshot(0);
 
 		}
-		//!!!!UNCOMMENT LATER WHEN STATIC EXISTS
-		//if (ImGui::Button("Save snapshot replay mine struct")) {
-		//	Snapshot* buf = &snapshot_replay_pre_allocated[snapshot_position_counter %SNAPSHOT_PREALLOC_SIZE];
-		//	snap_apparatus_debug->save_snapshot(&buf);
-		//	//snap_apparatus_debug->save_snapshot((Snapshot**)savedstate_mine);
-		//	snapshot_position_counter += 1;
-
-		//}
-		//if (ImGui::Button("Load snapshot replay mine struct 0 ")) {
-		//	auto pos = &snapshot_replay_pre_allocated[0];
-		//	snap_apparatus_debug->load_snapshot(&snapshot_replay_pre_allocated[0]);
-
-		//}
-		//if (ImGui::Button("Load snapshot replay mine struct")) {
-		//	auto pos2 = &snapshot_replay_pre_allocated[(snapshot_position_counter-1) % SNAPSHOT_PREALLOC_SIZE];
-		//	snap_apparatus_debug->load_snapshot(&snapshot_replay_pre_allocated[(snapshot_position_counter-1)% SNAPSHOT_PREALLOC_SIZE]);
-
-		//}
+		if (ImGui::Button("Save snapshot to store")) {
+			snap_apparatus_debug->save_snapshot_prealloc();
+		}
+		if (ImGui::Button("Load latest snapshot from store")) {
+			snap_apparatus_debug->load_snapshot_prealloc(snap_apparatus_debug->snapshot_store.size() - 1);
+		}
+		SnapshotStore& store = snap_apparatus_debug->snapshot_store;
+		ImGui::Text("Store: %d checkpoints, %d bytes encoded / %d bytes raw", store.size(),
+			(int)store.get_encoded_bytes(), (int)store.get_raw_bytes());
+		ImGui::Text("Last save: %lldus  Last encode: %lldus  Last decode: %lldus", snap_apparatus_debug->last_save_us,
+			store.last_encode_us.load(), store.last_decode_us.load());
 		if (ImGui::TreeNode("Netcode stuff")) {
 
 			char* base_addr = GetBbcfBaseAdress();
@@ -627,6 +620,40 @@ void DebugWindow::DrawRoomSection()
 	if (!ImGui::CollapsingHeader("Room"))
 		return;
 	ImGui::Text("g_modValsReplayUploadVeto: %d", g_modVals.uploadReplayDataVeto);
+
+	// Before the room check so the benchmark can run offline
+	if (ImGui::TreeNode("Packet stats"))
+	{
+		if (g_interfaces.pNetworkManager)
+		{
+			const NetworkSendStats& stats = g_interfaces.pNetworkManager->GetSendStats();
+			ImGui::Text("Since last match init: %u packets, %u bytes in %u batches, %u failed",
+				stats.packets, stats.bytes, stats.batches, stats.failed);
+			ImGui::Text("Pooled packets: %d", g_interfaces.pNetworkManager->GetPooledPacketCount());
+		}
+
+		static int recipients = 1;
+		static PaletteSendBenchmark benchmark;
+		static bool hasBenchmark = false;
+		ImGui::SliderInt("Recipients", &recipients, 1, 8);
+		if (g_interfaces.pOnlinePaletteManager && ImGui::Button("Loopback benchmark"))
+		{
+			benchmark = g_interfaces.pOnlinePaletteManager->RunLoopbackSendBenchmark(recipients, 1000);
+			hasBenchmark = true;
+		}
+		if (hasBenchmark && benchmark.packets == 0)
+		{
+			ImGui::TextUnformatted("Nothing sent, load a character first");
+		}
+		else if (hasBenchmark)
+		{
+			ImGui::Text("Per match init: %u packets, %u bytes, %.2fus (%u malformed)",
+				benchmark.packets, benchmark.bytes, benchmark.usPerMatchInit, benchmark.malformed);
+		}
+
+		ImGui::TreePop();
+	}
+
 	if (!g_gameVals.pRoom || g_gameVals.pRoom->roomStatus == RoomStatus_Unavailable)
 	{
 		ImGui::TextUnformatted("Room is not available!");
@@ -1,367 +1,467 @@
-#include "FrameHistory.h"
-#include "Overlay/Window/FrameAdvantage/PlayerExtendedData.h"
-#include <cstddef>
-#include "Core/logger.h"
-#include "Overlay/Logger/ImGuiLogger.h"
-#define MAX(a,b)            (((a) > (b)) ? (a) : (b))
-
-
-// thanks to PCVolt
-const std::vector<std::string> idleWords = {
-    // now classified under "Special"
-    // "CmnActFDash",
-
-    
-    "_NEUTRAL", "CmnActStand", "CmnActStandTurn", "CmnActStand2Crouch",
-    "CmnActCrouch", "CmnActCrouchTurn", "CmnActCrouch2Stand", "CmnActFWalk",
-    "CmnActBWalk", "CmnActFDashStop", "CmnActJumpUpper",
-    "CmnActJumpDown", "CmnActJumpUpperEnd", "CmnActJumpLanding",
-    "CmnActLandingStiffEnd",
-    "CmnActUkemiLandNLanding", // to fix, 12F too long!
-    // Proxi block is triggered when an attack is closing in without being
-    // actually blocked If the player.blockstun is = 0, then those animations
-    // are still considered idle
-    "CmnActCrouchGuardPre", "CmnActCrouchGuardLoop", "CmnActCrouchGuardEnd", // Crouch
-    "CmnActCrouchHeavyGuardPre", "CmnActCrouchHeavyGuardLoop", "CmnActCrouchHeavyGuardEnd", // Crouch Heavy
-    "CmnActMidGuardPre", "CmnActMidGuardLoop", "CmnActMidGuardEnd", // Mid
-    "CmnActMidHeavyGuardPre", "CmnActMidHeavyGuardLoop", "CmnActMidHeavyGuardEnd", // Mid Heavy
-    "CmnActHighGuardPre", "CmnActHighGuardLoop", "CmnActHighGuardEnd", // High
-    "CmnActHighHeavyGuardPre", "CmnActHighHeavyGuardLoop", "CmnActHighHeavyGuardEnd", // High Heavy
-    "CmnActAirGuardPre", "CmnActAirGuardLoop", "CmnActAirGuardEnd", // Air
-    // Character specifics
-    "com3_kamae" // Mai 5xB stance
-};
-
-// TODO: Make this use arbitrary bases vectors
-std::array<float, 3> attributetoColor(Attribute attr, std::array<Attribute, 3> rgb_attr) {
-    std::array<float, 3> res = {};
-    
-    res[0] = static_cast<int>(rgb_attr[0] & attr) > 0;
-    res[1] = static_cast<int>(rgb_attr[1] & attr) > 0;
-    res[2] = static_cast<int>(rgb_attr[2] & attr) > 0;
-    
-    return res;
-}
-
-std::array<float, 3> kindtoColor(FrameKind kind) {
-    std::array<float, 3> res;
-    // it's not so clear cut. Moves that don't let you be actionable in air may still be classified as idle,
-    // TODO: because we remove hardlanding from immediate classification. Needs more testing
-    FrameKind cleankind = kind & ~(static_cast<FrameKind>(0x40) | FrameKind::HardLanding);
-    switch (cleankind)
-    {
-    case FrameKind::Idle:
-        if (static_cast<int>(kind & FrameKind::HardLanding) != 0) {
-            res = BLUSH;
-        }
-        else {
-            res = BLACK;
-        }
-        break;
-    case FrameKind::Startup:
-        res = GREEN;
-        break;
-    case FrameKind::Recovery:
-        if (static_cast<int>(kind & FrameKind::HardLanding) != 0) {
-            res = BLUSH;
-        }
-        else {
-            res = BLUE;
-        }
-        break;
-    case FrameKind::Active:
-        res = RED;
-        break;
-    case FrameKind::Blockstun:
-        res = YELLOW;
-        break;
-    case FrameKind::Hitstun:
-        res = PURPLE;
-        break;
-    case FrameKind::Special:
-        res = AQUAMARINE;
-        break;
-    default:
-        if (static_cast<int>(cleankind & FrameKind::Active) != 0) {
-            res = RED;
-        }
-
-        else if (static_cast<int>(cleankind & FrameKind::Startup) != 0) {
-            res = GREEN;
-        }
-        else if (static_cast<int>(cleankind & FrameKind::Recovery) != 0) {
-            res = PURPLE;
-        }
-        else if (static_cast<int>(cleankind & FrameKind::Disarmed) != 0) {
-            res = BYZANTIUM;
-
-        }
-        else {
-            res = BURGUNDY;
-        }
-        break;
-    }
-    return res;
-}
-
-int first_det_active(std::vector<FrameActivity>& activity_status) {
-    for (size_t i = 0; i < activity_status.size(); i++) {
-        if (activity_status[i] == FrameActivity::Active) {
-            return i;
-        }
-    }
-    return -1;
-}
-
-
-Attribute parse_dyn_invul(uint32 invul_field, uint32 gp_bitfield) {
-    if ((invul_field & 0x02) == 0) {
-        return Attribute::N;
-    }
-
-    Attribute invul = Attribute::N;
-
-    if (gp_bitfield & 0x01)     invul = invul | Attribute::GP;
-    if (invul_field & 0x08)     invul = invul | Attribute::H;
-    if (invul_field & 0x10)     invul = invul | Attribute::B;
-    if (invul_field & 0x20)     invul = invul | Attribute::F;
-    if (invul_field & 0x80000)  invul = invul | Attribute::P;
-    if (invul_field & 0x40)     invul = invul | Attribute::T;
-
-
-
-    return invul;
-}
-
-PlayerFrameState::PlayerFrameState(scrState* state, unsigned int frame,
-    CharData* player, BackedUpCharData old_data) {
-
-    // set state variables
-    invul = parse_dyn_invul(player->invuln_bitfield, player->guard_point_bitfield);
-    is_new = frame == 0;
-    
-    
-    // Set kind
-    std::string currentAction = std::string(player->currentAction);
-    int fst_det_active;
-    Attribute det_invul = Attribute::N;
-    bool is_idle_state = std::find(std::begin(idleWords), std::end(idleWords), currentAction) != std::end(idleWords);
-    
-    if (state == nullptr) {
-        fst_det_active = -1;
-    }
-    else {
-        fst_det_active = first_det_active(state->frame_activity_status);
-    }
-    
-
-    if (is_new && currentAction == "CmnActUkemiLandNLanding") {
-        kind = FrameKind::Recovery;
-    }
-    else if (is_idle_state) {
-        kind = FrameKind::Idle;
-    }
-    else {
-        kind = FrameKind::Special;
-    }
-    if (player->hitboxCount > 0
-        && (player->bitflags_for_curr_state_properties_or_smth & (0x400 | 0x200)) == 0) {
-        kind = FrameKind::Active | kind;
-    }
-    if (player->blockstun > 0) {
-        kind = FrameKind::Blockstun | kind;
-    }
-    if (player->hitstun > 0) {
-        kind = FrameKind::Hitstun | kind;
-    }
-
-    // hardlanding is set even if the player is still airborn. We only want to flag the *landing* portion
-    if (/*player->hardLandingRecovery > 0 && player->position_y + old_data.position_y == 0 && */currentAction == "CmnActLandingStiffLoop") {
-        kind = FrameKind::HardLanding | kind;
-    }
-    // NOTE: Startup is only defined in a context with deterministic active frames
-    if (fst_det_active > -1
-        && (player->hitboxCount <= 0 || (player->bitflags_for_curr_state_properties_or_smth & (0x400 | 0x200)) == 0)
-        && !is_idle_state) {
-        
-        if (frame < fst_det_active) {
-            kind = FrameKind::Startup | kind;
-        }
-        else {
-            kind = FrameKind::Recovery | kind;
-        }
-    }
-
-    // Clear the "Special" specification, if the state is already well defined
-    if ((kind & FrameKind::Disarmed) != FrameKind::Idle) {
-        kind = FrameKind::NotSpecial & kind;
-    }
-
-
-    return;
-}
-PlayerFrameState::PlayerFrameState()
-{
-}
-
-bool FrameHistory::getPlayerFrameStates(CharData* player1,
-    CharData* player2, StatePair* res) {
-    // get the state
-    // we need the amount of frames spent on the current state, in order to index into the state frames.
-    // TODO: Might want to count frames since last update, and add those to the p1_frames. However, what if a state was changed in between updates, then we can't know.
-    // This is all the more reason to query states purely dynamically.
-    std::string currentAction = std::string(player1->currentAction);
-    // If the actionTime hasn't yet changed, don't register this frame.
-    bool condition1 = p1_frames == player1->actionTime - 1;
-    if (player1->stateChangedCount != p1_stateChangedCount) {
-        // if it is not, fetch the new states from the map
-        auto p1_new_state = p1_StateMap.find(currentAction);
-        if (p1_new_state != p1_StateMap.end()) {
-            p1_State = p1_StateMap.at(currentAction);
-        }
-        else {
-            p1_State = nullptr;
-        }
-        p1_frames = 0;
-    }
-    else {
-        // could instead use the difference between local and global framecounts, to
-        // increment this. If there is hitstop, do not add a frame.
-        p1_frames = player1->actionTime - 1;
-    }
-    currentAction = std::string(player2->currentAction);
-    bool condition2 = p2_frames == player2->actionTime - 1;
-    if (player2->stateChangedCount != p2_stateChangedCount) {
-        auto p2_new_state = p2_StateMap.find(currentAction);
-        if (p2_new_state != p2_StateMap.end()) {
-            p2_State = p2_StateMap.at(currentAction);
-        }
-        else {
-            p2_State = nullptr;
-        }
-        p2_frames = 0;
-    }
-    else {
-        p2_frames = player2->actionTime - 1;
-    }
-
-    // Note that frame calculation is first performed, because we don't want to
-    // miss a state switch because of hitstop
-
-    // Only skip writing to the grid, if both players are experiencing hitstop
-    // (might be redundant)
-    if (condition1 && condition2) {
-        return false;
-    }
-    else {
-        *res = { PlayerFrameState(p1_State, p1_frames, player1, p1_old_data),
-            PlayerFrameState(p2_State, p2_frames, player2, p2_old_data) };
-        return true;
-    }
-}
-
-/// update the history queue with the new player states. Only call after the
-/// game time has moved and by NO MORE than 1 frame
-void FrameHistory::updateHistory(bool resetting) {
-    CharData* p1 = g_interfaces.player1.GetData();
-    CharData* p2 = g_interfaces.player2.GetData();
-
-    if (p1->charIndex != p1_charIndex || p2->charIndex != p2_charIndex) {
-        loadCharData();
-    }
-
-    // update the player states, return their parsed versions
-    StatePair states = {   };
-
-    if (!getPlayerFrameStates(p1, p2, &states)) {
-        return;
-    }
-
-    // sync up everything
-    p1_frameCountMinus_1 = p1->frame_count_minus_1;
-    p2_frameCountMinus_1 = p2->frame_count_minus_1;
-    p1_stateChangedCount = p1->stateChangedCount;
-    p2_stateChangedCount = p2->stateChangedCount;
-
-
-    // TODO: If you add attack and guardp, add them to this condition
-    // Reset on completely idle frames
-    if (
-         (states[0].kind == FrameKind::Idle
-         && states[0].invul == Attribute::N)
-         &&
-         (states[1].kind == FrameKind::Idle
-         && states[1].invul == Attribute::N)
-       )
-    {
-        is_old = true;
-    }
-    else {
-        // if something is happening, push the info. But not before clearing out
-        if (is_old && resetting) {
-            queue.clear();
-        }
-
-        while (queue.size() >= HISTORY_DEPTH) {
-            queue.pop_front();
-        }
-        
-        queue.push_back(states);
-        is_old = false;
-    }
-    // after doing updates, store this information for later.
-    backupChars();
-}
-
-void FrameHistory::backupChars()
-{
-    CharData* p1 = g_interfaces.player1.GetData();
-    CharData* p2 = g_interfaces.player2.GetData();
-    p1_old_data = BackedUpCharData();
-    p2_old_data = BackedUpCharData();
-    p1_old_data.position_y = p1->position_y;
-    p2_old_data.position_y = p2->position_y;
-}
-
-StatePairQueue& FrameHistory::read() { return queue; }
-
-// TODO: Add safety checks
-void FrameHistory::loadCharData() {
-    CharData* p1 = g_interfaces.player1.GetData();
-    CharData* p2 = g_interfaces.player2.GetData();
-
-    p1_charIndex = p1->charIndex;
-    p2_charIndex = p2->charIndex;
-    p1_frameCountMinus_1 = p1->frame_count_minus_1;
-    p2_frameCountMinus_1 = p2->frame_count_minus_1;
-    p1_stateChangedCount = p1->stateChangedCount - 1;
-    p2_stateChangedCount = p2->stateChangedCount - 1;
-
-    char* bbcf_base_adress = GetBbcfBaseAdress();
-
-    std::vector<scrState*> states_p1 = parse_scr(bbcf_base_adress, 1);
-    std::vector<scrState*> states_p2;
-    if (p1_charIndex == p2_charIndex) {
-        states_p2 = parse_scr(bbcf_base_adress, 1);
-    } else {
-        states_p2 = parse_scr(bbcf_base_adress, 2);
-    }
-
-    for (size_t i1 = 0; i1 < states_p1.size(); i1++) {
-        p1_StateMap[states_p1[i1]->name] = states_p1[i1];
-    }
-
-    for (size_t i2 = 0; i2 < states_p2.size(); i2++) {
-        p2_StateMap[states_p2[i2]->name] = states_p2[i2];
-    }
-}
-
-void FrameHistory::clear() { queue.clear(); }
-
-FrameHistory::FrameHistory() {
-    queue = std::deque<StatePair>();
-    p1_old_data = BackedUpCharData();
-    p2_old_data = BackedUpCharData();
-}
-
-FrameHistory::~FrameHistory() {}
+#include "FrameHistory.h"
+#include "Overlay/Window/FrameAdvantage/PlayerExtendedData.h"
+#include <cstddef>
+#include <cstring>
+#include <chrono>
+#include "Core/logger.h"
+#include "Overlay/Logger/ImGuiLogger.h"
+#define MAX(a,b)            (((a) > (b)) ? (a) : (b))
+
+
+// thanks to PCVolt
+const char* const idleWords[] = {
+    // now classified under "Special"
+    // "CmnActFDash",
+
+    
+    "_NEUTRAL", "CmnActStand", "CmnActStandTurn", "CmnActStand2Crouch",
+    "CmnActCrouch", "CmnActCrouchTurn", "CmnActCrouch2Stand", "CmnActFWalk",
+    "CmnActBWalk", "CmnActFDashStop", "CmnActJumpUpper",
+    "CmnActJumpDown", "CmnActJumpUpperEnd", "CmnActJumpLanding",
+    "CmnActLandingStiffEnd",
+    "CmnActUkemiLandNLanding", // to fix, 12F too long!
+    // Proxi block is triggered when an attack is closing in without being
+    // actually blocked If the player.blockstun is = 0, then those animations
+    // are still considered idle
+    "CmnActCrouchGuardPre", "CmnActCrouchGuardLoop", "CmnActCrouchGuardEnd", // Crouch
+    "CmnActCrouchHeavyGuardPre", "CmnActCrouchHeavyGuardLoop", "CmnActCrouchHeavyGuardEnd", // Crouch Heavy
+    "CmnActMidGuardPre", "CmnActMidGuardLoop", "CmnActMidGuardEnd", // Mid
+    "CmnActMidHeavyGuardPre", "CmnActMidHeavyGuardLoop", "CmnActMidHeavyGuardEnd", // Mid Heavy
+    "CmnActHighGuardPre", "CmnActHighGuardLoop", "CmnActHighGuardEnd", // High
+    "CmnActHighHeavyGuardPre", "CmnActHighHeavyGuardLoop", "CmnActHighHeavyGuardEnd", // High Heavy
+    "CmnActAirGuardPre", "CmnActAirGuardLoop", "CmnActAirGuardEnd", // Air
+    // Character specifics
+    "com3_kamae" // Mai 5xB stance
+};
+
+// TODO: Make this use arbitrary bases vectors
+std::array<float, 3> attributetoColor(Attribute attr, std::array<Attribute, 3> rgb_attr) {
+    std::array<float, 3> res = {};
+    
+    res[0] = static_cast<int>(rgb_attr[0] & attr) > 0;
+    res[1] = static_cast<int>(rgb_attr[1] & attr) > 0;
+    res[2] = static_cast<int>(rgb_attr[2] & attr) > 0;
+    
+    return res;
+}
+
+std::array<float, 3> kindtoColor(FrameKind kind) {
+    std::array<float, 3> res;
+    // it's not so clear cut. Moves that don't let you be actionable in air may still be classified as idle,
+    // TODO: because we remove hardlanding from immediate classification. Needs more testing
+    FrameKind cleankind = kind & ~(static_cast<FrameKind>(0x40) | FrameKind::HardLanding);
+    switch (cleankind)
+    {
+    case FrameKind::Idle:
+        if (static_cast<int>(kind & FrameKind::HardLanding) != 0) {
+            res = BLUSH;
+        }
+        else {
+            res = BLACK;
+        }
+        break;
+    case FrameKind::Startup:
+        res = GREEN;
+        break;
+    case FrameKind::Recovery:
+        if (static_cast<int>(kind & FrameKind::HardLanding) != 0) {
+            res = BLUSH;
+        }
+        else {
+            res = BLUE;
+        }
+        break;
+    case FrameKind::Active:
+        res = RED;
+        break;
+    case FrameKind::Blockstun:
+        res = YELLOW;
+        break;
+    case FrameKind::Hitstun:
+        res = PURPLE;
+        break;
+    case FrameKind::Special:
+        res = AQUAMARINE;
+        break;
+    default:
+        if (static_cast<int>(cleankind & FrameKind::Active) != 0) {
+            res = RED;
+        }
+
+        else if (static_cast<int>(cleankind & FrameKind::Startup) != 0) {
+            res = GREEN;
+        }
+        else if (static_cast<int>(cleankind & FrameKind::Recovery) != 0) {
+            res = PURPLE;
+        }
+        else if (static_cast<int>(cleankind & FrameKind::Disarmed) != 0) {
+            res = BYZANTIUM;
+
+        }
+        else {
+            res = BURGUNDY;
+        }
+        break;
+    }
+    return res;
+}
+
+int first_det_active(const ScrFrameTrack<FrameActivity>& activity_status) {
+    for (size_t i = 0; i < activity_status.size(); i++) {
+        if (activity_status[i] == FrameActivity::Active) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+
+Attribute parse_dyn_invul(uint32 invul_field, uint32 gp_bitfield) {
+    if ((invul_field & 0x02) == 0) {
+        return Attribute::N;
+    }
+
+    Attribute invul = Attribute::N;
+
+    if (gp_bitfield & 0x01)     invul = invul | Attribute::GP;
+    if (invul_field & 0x08)     invul = invul | Attribute::H;
+    if (invul_field & 0x10)     invul = invul | Attribute::B;
+    if (invul_field & 0x20)     invul = invul | Attribute::F;
+    if (invul_field & 0x80000)  invul = invul | Attribute::P;
+    if (invul_field & 0x40)     invul = invul | Attribute::T;
+
+
+
+    return invul;
+}
+
+PlayerFrameState::PlayerFrameState(const StateClassification& classification, unsigned int frame,
+    CharData* player, BackedUpCharData old_data) {
+
+    // set state variables
+    invul = parse_dyn_invul(player->invuln_bitfield, player->guard_point_bitfield);
+    is_new = frame == 0;
+    
+    
+    // Set kind
+    uint8_t state_class = classification.state_class;
+    int fst_det_active = classification.first_active;
+    Attribute det_invul = Attribute::N;
+    bool is_idle_state = (state_class & StateClass_Idle) != 0;
+
+    if (is_new && (state_class & StateClass_UkemiLanding)) {
+        kind = FrameKind::Recovery;
+    }
+    else if (is_idle_state) {
+        kind = FrameKind::Idle;
+    }
+    else {
+        kind = FrameKind::Special;
+    }
+    if (player->hitboxCount > 0
+        && (player->bitflags_for_curr_state_properties_or_smth & (0x400 | 0x200)) == 0) {
+        kind = FrameKind::Active | kind;
+    }
+    if (player->blockstun > 0) {
+        kind = FrameKind::Blockstun | kind;
+    }
+    if (player->hitstun > 0) {
+        kind = FrameKind::Hitstun | kind;
+    }
+
+    // hardlanding is set even if the player is still airborn. We only want to flag the *landing* portion
+    if (/*player->hardLandingRecovery > 0 && player->position_y + old_data.position_y == 0 && */(state_class & StateClass_LandingStiffLoop)) {
+        kind = FrameKind::HardLanding | kind;
+    }
+    // NOTE: Startup is only defined in a context with deterministic active frames
+    if (fst_det_active > -1
+        && (player->hitboxCount <= 0 || (player->bitflags_for_curr_state_properties_or_smth & (0x400 | 0x200)) == 0)
+        && !is_idle_state) {
+        
+        if (frame < fst_det_active) {
+            kind = FrameKind::Startup | kind;
+        }
+        else {
+            kind = FrameKind::Recovery | kind;
+        }
+    }
+
+    // Clear the "Special" specification, if the state is already well defined
+    if ((kind & FrameKind::Disarmed) != FrameKind::Idle) {
+        kind = FrameKind::NotSpecial & kind;
+    }
+
+
+    return;
+}
+PlayerFrameState::PlayerFrameState()
+{
+}
+
+FrameRecord::FrameRecord(const PlayerFrameState& state) {
+    kind = static_cast<uint8_t>(state.kind);
+    invul = pack_attribute(state.invul);
+    guardp = pack_attribute(state.guardp);
+    attack = pack_attribute(state.attack);
+    flags = (state.is_new ? FRAME_RECORD_IS_NEW : 0) | (state.loggable ? FRAME_RECORD_LOGGABLE : 0);
+}
+
+uint8_t FrameRecord::pack_attribute(Attribute attr) {
+    uint32_t bits = static_cast<uint32_t>(attr);
+    return (uint8_t)((bits & 0x3F) | ((bits & static_cast<uint32_t>(Attribute::GP)) ? 0x40 : 0));
+}
+
+Attribute FrameRecord::unpack_attribute(uint8_t packed) {
+    Attribute attr = static_cast<Attribute>(packed & 0x3F);
+    if (packed & 0x40) {
+        attr = attr | Attribute::GP;
+    }
+    return attr;
+}
+
+void StatePairRing::set_capacity(size_t capacity) {
+    buffer.assign(capacity > 0 ? capacity : 1, StatePair());
+    clear();
+}
+
+void StatePairRing::push_back(const StatePair& pair) {
+    buffer[head] = pair;
+    head = (head + 1) % buffer.size();
+    if (count < buffer.size()) {
+        count++;
+    }
+}
+
+static size_t state_name_len(const char* name) {
+    size_t len = 0;
+    while (len < 32 && name[len] != 0) {
+        len++;
+    }
+    return len;
+}
+
+uint16_t StateIdTable::find(const char* name) const {
+    if (name == NULL) {
+        return 0;
+    }
+    size_t len = state_name_len(name);
+    int id = slots.Find(fnv1a32(name, len), [&](uint32_t i) {
+        return strncmp(names[i].data(), name, len) == 0 && (len == 32 || names[i][len] == 0);
+    });
+    return id > 0 ? (uint16_t)id : 0;
+}
+
+uint16_t StateIdTable::intern(const char* name, uint8_t state_class) {
+    uint16_t id = find(name);
+    if (id == 0) {
+        if (name == NULL || names.size() >= 0xFFFF) {
+            return 0;
+        }
+        size_t len = state_name_len(name);
+        std::array<char, 32> stored = {};
+        memcpy(stored.data(), name, len);
+        id = (uint16_t)names.size();
+        names.push_back(stored);
+        classes.push_back(0);
+        slots.Insert(fnv1a32(name, len), id);
+    }
+    classes[id] |= state_class;
+    return id;
+}
+
+void StateIdTable::clear() {
+    names.assign(1, std::array<char, 32>());
+    classes.assign(1, 0);
+    slots.Clear();
+}
+
+bool FrameHistory::getPlayerFrameStates(CharData* player1,
+    CharData* player2, StatePair* res) {
+    // get the state
+    // we need the amount of frames spent on the current state, in order to index into the state frames.
+    // TODO: Might want to count frames since last update, and add those to the p1_frames. However, what if a state was changed in between updates, then we can't know.
+    // This is all the more reason to query states purely dynamically.
+    // If the actionTime hasn't yet changed, don't register this frame.
+    bool condition1 = p1_frames == player1->actionTime - 1;
+    if (player1->stateChangedCount != p1_stateChangedCount) {
+        p1_frames = 0;
+    }
+    else {
+        // could instead use the difference between local and global framecounts, to
+        // increment this. If there is hitstop, do not add a frame.
+        p1_frames = player1->actionTime - 1;
+    }
+    bool condition2 = p2_frames == player2->actionTime - 1;
+    if (player2->stateChangedCount != p2_stateChangedCount) {
+        p2_frames = 0;
+    }
+    else {
+        p2_frames = player2->actionTime - 1;
+    }
+
+    // Note that frame calculation is first performed, because we don't want to
+    // miss a state switch because of hitstop
+
+    // Only skip writing to the grid, if both players are experiencing hitstop
+    // (might be redundant)
+    if (condition1 && condition2) {
+        return false;
+    }
+    else {
+        // only does anything on the first frame of a state, otherwise it's just comparing the counts
+        classify(player1, p1_states_by_id, p1_class);
+        classify(player2, p2_states_by_id, p2_class);
+        (*res)[0] = FrameRecord(PlayerFrameState(p1_class, p1_frames, player1, p1_old_data));
+        (*res)[1] = FrameRecord(PlayerFrameState(p2_class, p2_frames, player2, p2_old_data));
+        return true;
+    }
+}
+
+void FrameHistory::classify(CharData* player, const std::vector<scrState*>& states_by_id, StateClassification& classification) {
+    if (player->stateChangedCount == classification.state_changed_count) {
+        return;
+    }
+    // unknown names get id 0, which has no state and no class
+    uint16_t id = state_ids.find(player->currentAction);
+    classification.state = states_by_id[id];
+    classification.state_class = state_ids.get_class(id);
+    classification.first_active = classification.state != nullptr ? first_det_active(classification.state->frame_activity_status) : -1;
+    classification.state_changed_count = player->stateChangedCount;
+}
+
+/// update the history queue with the new player states. Only call after the
+/// game time has moved and by NO MORE than 1 frame
+void FrameHistory::updateHistory(bool resetting) {
+    auto start = std::chrono::steady_clock::now();
+    update(resetting);
+    last_update_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    // roughly the last couple of seconds
+    avg_update_us += (last_update_us - avg_update_us) * 0.05;
+}
+
+void FrameHistory::update(bool resetting) {
+    CharData* p1 = g_interfaces.player1.GetData();
+    CharData* p2 = g_interfaces.player2.GetData();
+
+    if (p1->charIndex != p1_charIndex || p2->charIndex != p2_charIndex) {
+        loadCharData();
+    }
+
+    // update the player states, return their parsed versions
+    StatePair states = {   };
+
+    if (!getPlayerFrameStates(p1, p2, &states)) {
+        return;
+    }
+
+    // sync up everything
+    p1_frameCountMinus_1 = p1->frame_count_minus_1;
+    p2_frameCountMinus_1 = p2->frame_count_minus_1;
+    p1_stateChangedCount = p1->stateChangedCount;
+    p2_stateChangedCount = p2->stateChangedCount;
+
+
+    // TODO: If you add attack and guardp, add them to this condition
+    // Reset on completely idle frames
+    if (
+         (states[0].get_kind() == FrameKind::Idle
+         && states[0].get_invul() == Attribute::N)
+         &&
+         (states[1].get_kind() == FrameKind::Idle
+         && states[1].get_invul() == Attribute::N)
+       )
+    {
+        is_old = true;
+    }
+    else {
+        // if something is happening, push the info. But not before clearing out
+        if (is_old && resetting) {
+            queue.clear();
+        }
+
+        queue.push_back(states);
+        is_old = false;
+    }
+    // after doing updates, store this information for later.
+    backupChars();
+}
+
+void FrameHistory::backupChars()
+{
+    CharData* p1 = g_interfaces.player1.GetData();
+    CharData* p2 = g_interfaces.player2.GetData();
+    p1_old_data = BackedUpCharData();
+    p2_old_data = BackedUpCharData();
+    p1_old_data.position_y = p1->position_y;
+    p2_old_data.position_y = p2->position_y;
+}
+
+const StatePairRing& FrameHistory::read() const { return queue; }
+
+void FrameHistory::set_depth(int depth) {
+    //clamped while still signed, a negative ini value would otherwise wrap to the maximum
+    if (depth < 1) {
+        depth = 1;
+    }
+    if (depth > (int)MAX_HISTORY_DEPTH) {
+        depth = (int)MAX_HISTORY_DEPTH;
+    }
+    if ((size_t)depth != queue.capacity()) {
+        queue.set_capacity((size_t)depth);
+    }
+}
+
+// TODO: Add safety checks
+void FrameHistory::loadCharData() {
+    CharData* p1 = g_interfaces.player1.GetData();
+    CharData* p2 = g_interfaces.player2.GetData();
+
+    p1_charIndex = p1->charIndex;
+    p2_charIndex = p2->charIndex;
+    p1_frameCountMinus_1 = p1->frame_count_minus_1;
+    p2_frameCountMinus_1 = p2->frame_count_minus_1;
+    p1_stateChangedCount = p1->stateChangedCount - 1;
+    p2_stateChangedCount = p2->stateChangedCount - 1;
+
+    char* bbcf_base_adress = GetBbcfBaseAdress();
+
+    p1_class = StateClassification();
+    p2_class = StateClassification();
+    state_ids.clear();
+    for (const char* word : idleWords) {
+        state_ids.intern(word, StateClass_Idle);
+    }
+    state_ids.intern("CmnActUkemiLandNLanding", StateClass_UkemiLanding);
+    state_ids.intern("CmnActLandingStiffLoop", StateClass_LandingStiffLoop);
+
+    // on a mirror match both come back as the same cached arena
+    p1_arena = parse_scr(bbcf_base_adress, 1);
+    p2_arena = parse_scr(bbcf_base_adress, 2);
+    for (scrState* state : p1_arena->states) {
+        state_ids.intern(state->name.c_str());
+    }
+    for (scrState* state : p2_arena->states) {
+        state_ids.intern(state->name.c_str());
+    }
+    // later states win on a repeated name, same as the old name maps
+    p1_states_by_id.assign(state_ids.size() + 1, nullptr);
+    p2_states_by_id.assign(state_ids.size() + 1, nullptr);
+    for (scrState* state : p1_arena->states) {
+        p1_states_by_id[state_ids.find(state->name.c_str())] = state;
+    }
+    for (scrState* state : p2_arena->states) {
+        p2_states_by_id[state_ids.find(state->name.c_str())] = state;
+    }
+}
+
+void FrameHistory::clear() { queue.clear(); }
+
+FrameHistory::FrameHistory() {
+    queue.set_capacity(DEFAULT_HISTORY_DEPTH);
+    p1_states_by_id.assign(1, nullptr);
+    p2_states_by_id.assign(1, nullptr);
+    p1_old_data = BackedUpCharData();
+    p2_old_data = BackedUpCharData();
+}
+
+FrameHistory::~FrameHistory() {}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Core/hash.h"
 #include "Core/interfaces.h"
 #include "Core/utils.h"
 #include "Game/CharData.h"
@@ -8,10 +9,11 @@
 #include "imgui.h"
 #include <array>
 #include <cstddef>
-#include <deque>
+#include <vector>
 
-// maximum number of frames to be kept track of in the history
-const size_t HISTORY_DEPTH = 100;
+// frames kept in the history unless FrameHistoryDepth in settings.ini says otherwise
+const size_t DEFAULT_HISTORY_DEPTH = 600;
+const size_t MAX_HISTORY_DEPTH = 60 * 60 * 10;
 
 /// An arbitrary, and abstract categorization of player state, several of these
 /// are difficult to determine, they are here as a reminder to future
@@ -85,6 +87,14 @@ struct BackedUpCharData {
     int32_t position_y;
 };
 
+// what the classifier needs to know about the state a player is in, resolved once when they enter it
+struct StateClassification {
+    scrState* state = nullptr;
+    uint8_t state_class = 0; // StateClass_
+    int first_active = -1; // first deterministic active frame of the state, -1 if there is none
+    int32_t state_changed_count = -1; // the player's stateChangedCount this was resolved for
+};
+
 // TODO: Represent invul, guardp, attack, and is_new
 class PlayerFrameState {
 public:
@@ -96,13 +106,78 @@ public:
     bool is_new = false;
     bool loggable = true;
 
-    PlayerFrameState(scrState* state, unsigned int frame, CharData* player, BackedUpCharData old_data);
+    PlayerFrameState(const StateClassification& classification, unsigned int frame, CharData* player, BackedUpCharData old_data);
     //PlayerFrameState(bool loggable);
     PlayerFrameState();
 };
 
-typedef std::array<PlayerFrameState, 2> StatePair;
-typedef std::deque<StatePair> StatePairQueue;
+// what the history keeps of a PlayerFrameState, one byte per field. Attribute only uses the low 6 bits plus GP, GP is moved down to 0x40
+struct FrameRecord {
+    uint8_t kind = 0;
+    uint8_t invul = 0;
+    uint8_t guardp = 0;
+    uint8_t attack = 0;
+    uint8_t flags = 0; // FRAME_RECORD_IS_NEW, FRAME_RECORD_LOGGABLE
+
+    FrameRecord() {}
+    FrameRecord(const PlayerFrameState& state);
+
+    FrameKind get_kind() const { return static_cast<FrameKind>(kind); }
+    Attribute get_invul() const { return unpack_attribute(invul); }
+    Attribute get_guardp() const { return unpack_attribute(guardp); }
+    Attribute get_attack() const { return unpack_attribute(attack); }
+    bool is_new() const { return (flags & FRAME_RECORD_IS_NEW) != 0; }
+    bool is_loggable() const { return (flags & FRAME_RECORD_LOGGABLE) != 0; }
+
+    static const uint8_t FRAME_RECORD_IS_NEW = 0x01;
+    static const uint8_t FRAME_RECORD_LOGGABLE = 0x02;
+    static uint8_t pack_attribute(Attribute attr);
+    static Attribute unpack_attribute(uint8_t packed);
+};
+
+typedef std::array<FrameRecord, 2> StatePair;
+
+// fixed capacity history of frames, once full the oldest gets overwritten. Nothing allocates after set_capacity
+class StatePairRing {
+public:
+    void set_capacity(size_t capacity); // drops the history
+    size_t capacity() const { return buffer.size(); }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    void clear() { head = 0; count = 0; }
+    void push_back(const StatePair& pair);
+    const StatePair& at_from_newest(size_t i) const { return buffer[(head + buffer.size() - 1 - i) % buffer.size()]; } // 0 is the latest frame
+    const StatePair& operator[](size_t i) const { return at_from_newest(count - 1 - i); } // 0 is the oldest frame kept
+
+private:
+    std::vector<StatePair> buffer;
+    size_t head = 0; // where the next frame goes
+    size_t count = 0;
+};
+
+// state classes for the names the frame history treats specially, looked up once per state change
+enum StateClass_ {
+    StateClass_Idle = 0x01,
+    StateClass_UkemiLanding = 0x02, // CmnActUkemiLandNLanding
+    StateClass_LandingStiffLoop = 0x04 // CmnActLandingStiffLoop
+};
+
+// interns the names of states (the game's char[32] currentAction) into small ids, only the first time a name is seen allocates
+class StateIdTable {
+public:
+    uint16_t intern(const char* name, uint8_t state_class = 0); // state_class is or'd into whatever the name had
+    uint16_t find(const char* name) const; // 0 if the name was never interned
+    uint8_t get_class(uint16_t id) const { return classes[id]; }
+    size_t size() const { return names.size() - 1; }
+    void clear();
+
+    StateIdTable() { clear(); }
+
+private:
+    std::vector<std::array<char, 32>> names; // by id, id 0 is "no state"
+    std::vector<uint8_t> classes;
+    HashSlots slots;
+};
 
 
 struct FrameHistory {
@@ -114,7 +189,12 @@ public:
     // Overwrites old history if both players have been previously idle
     void updateHistory(bool resetting);
 
-    StatePairQueue& read();
+    // cost of updateHistory, shown in the FrameHistory section
+    long long last_update_us = 0;
+    double avg_update_us = 0;
+
+    const StatePairRing& read() const;
+    void set_depth(int depth); // clamps to 1..MAX_HISTORY_DEPTH, drops the history
     // void updateJonBMaps();
 
     // I would like to use these two to track state frame time and the char index
@@ -124,7 +204,7 @@ public:
     void clear();
 
 private:
-    StatePairQueue queue;
+    StatePairRing queue;
     bool is_old = false;
 
     // to check if characters changed
@@ -140,16 +220,23 @@ private:
     unsigned int p1_frames = 0;
     unsigned int p2_frames = 0;
 
-    scrState* p1_State = NULL;
-    scrState* p2_State = NULL;
+    StateClassification p1_class;
+    StateClassification p2_class;
 
-    std::map<std::string, scrState*> p1_StateMap = {};
-    std::map<std::string, scrState*> p2_StateMap = {};
+    // keep the parsed scripts alive, the state pointers below point into them
+    std::shared_ptr<ScrStateArena> p1_arena;
+    std::shared_ptr<ScrStateArena> p2_arena;
+    // both players' states and the idle words share one table, the vectors are indexed by its ids
+    StateIdTable state_ids;
+    std::vector<scrState*> p1_states_by_id;
+    std::vector<scrState*> p2_states_by_id;
 
     BackedUpCharData p1_old_data;
     BackedUpCharData p2_old_data;
 
+    void update(bool resetting);
     bool getPlayerFrameStates(CharData* player1, CharData* player2, StatePair*);
+    void classify(CharData* player, const std::vector<scrState*>& states_by_id, StateClassification& classification);
     void loadCharData();
     void backupChars();
 };
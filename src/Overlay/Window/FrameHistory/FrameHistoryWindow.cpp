@@ -142,7 +142,7 @@ void FrameHistoryWindow::Draw() {
 		ImColor color_inv = ImColor(255, 255, 255);
 		ImColor color_gp = ImColor(122, 85, 61);
 		// borrow the history queue
-		StatePairQueue& queue = history.read();
+		const StatePairRing& queue = history.read();
 		int frame_idx = 0;
 
 		ImGui::Text("Player 1:");
@@ -159,9 +159,11 @@ void FrameHistoryWindow::Draw() {
 		// Reclaim space after player 1 rows so Player 2 appears below
 		ImGui::Dummy(ImVec2(0, (height + spacing) * ((rows >> 1) - 1) + height));
 		ImGui::Text("Player 2:");
-		for (StatePairQueue::reverse_iterator elem = queue.rbegin(); elem != queue.rend(); ++elem) {
-			PlayerFrameState p1state = elem->front();
-			PlayerFrameState p2state = elem->back();
+		// the history can hold far more frames than fit, stop drawing past the window's right edge
+		float right_edge = ImGui::GetWindowPos().x + ImGui::GetWindowWidth();
+		for (size_t elem = 0; elem < queue.size() && cursor_p.x < right_edge; ++elem) {
+			const FrameRecord& p1state = queue.at_from_newest(elem)[0];
+			const FrameRecord& p2state = queue.at_from_newest(elem)[1];
 
 			// determine colors
 			// Need to make it more rubust later, format of the colors:
@@ -170,21 +172,21 @@ void FrameHistoryWindow::Draw() {
 
 
 			std::array<float, 3> color;
-			color = kindtoColor(p1state.kind);
+			color = kindtoColor(p1state.get_kind());
 			std::copy(std::begin(color), std::end(color), std::begin(col_arr));
 
 
-			color = kindtoColor(p2state.kind);
+			color = kindtoColor(p2state.get_kind());
 			std::copy(std::begin(color), std::end(color), std::begin(col_arr) + 6 * 1);
 			
 			/*Setting invuln colors here until we get around to simplifying the way the colors for the non - invul row works,
 				too confusing as of now*/
 			ImColor color_curr_inv_p1 = color_inv;
 			ImColor color_curr_inv_p2 = color_inv;
-			if (bool(p1state.invul & Attribute::GP)) {
+			if (bool(p1state.get_invul() & Attribute::GP)) {
 				color_curr_inv_p1 = color_gp;
 			}
-			if (bool(p2state.invul & Attribute::GP)) {
+			if (bool(p2state.get_invul() & Attribute::GP)) {
 				color_curr_inv_p2 = color_gp;
 			}
 
@@ -215,27 +217,27 @@ void FrameHistoryWindow::Draw() {
 				
 				// TODO: Could do with a more concise implementation
 				auto cursor_tmp = cursor_p2;
-				if (bool(p1state.invul & Attribute::T)) {
+				if (bool(p1state.get_invul() & Attribute::T)) {
 					cursor_tmp.x = cursor_p2.x + width - width / 5;
 					MakeBox(color_curr_inv_p1, cursor_tmp, width / 5, height);
 				};
-				if (bool(p1state.invul & Attribute::P)) {
+				if (bool(p1state.get_invul() & Attribute::P)) {
 					cursor_tmp = cursor_p2;
 					cursor_tmp.x = cursor_p2.x;
 					MakeBox(color_curr_inv_p1, cursor_tmp, width / 5, height);
 				};
-				if (bool(p1state.invul & Attribute::H)) {
+				if (bool(p1state.get_invul() & Attribute::H)) {
 					// the lines have 1/8th of the element height
 					cursor_tmp = cursor_p2;
 					cursor_tmp.y = cursor_p2.y;
 					MakeBox(color_curr_inv_p1, cursor_tmp, width, height / 5);
 				};
-				if (bool(p1state.invul & Attribute::B)) {
+				if (bool(p1state.get_invul() & Attribute::B)) {
 					cursor_tmp = cursor_p2;
 					cursor_tmp.y = cursor_p2.y + height / 2 - ((height / 5) / 2);
 					MakeBox(color_curr_inv_p1, cursor_tmp, width, height / 5);
 				}
-				if (bool(p1state.invul & Attribute::F)) {
+				if (bool(p1state.get_invul() & Attribute::F)) {
 					cursor_tmp = cursor_p2;
 					cursor_tmp.y = cursor_p2.y + height - (height / 5);
 					MakeBox(color_curr_inv_p1, cursor_tmp, width, height / 5);
@@ -265,26 +267,26 @@ void FrameHistoryWindow::Draw() {
 				
 
 				auto cursor_tmp = cursor_p2;
-				if (bool(p2state.invul & Attribute::T)) {
+				if (bool(p2state.get_invul() & Attribute::T)) {
 					cursor_tmp.x = cursor_p2.x + width - width / 5;
 					MakeBox(color_curr_inv_p2, cursor_tmp, width / 5, height);
 				};
-				if (bool(p2state.invul & Attribute::P)) {
+				if (bool(p2state.get_invul() & Attribute::P)) {
 					cursor_tmp = cursor_p2;
 					cursor_tmp.x = cursor_p2.x;
 					MakeBox(color_curr_inv_p2, cursor_tmp, width / 5, height);
 				};
-				if (bool(p2state.invul & Attribute::H)) {
+				if (bool(p2state.get_invul() & Attribute::H)) {
 					cursor_tmp = cursor_p2;
 					cursor_tmp.y = cursor_p2.y;
 					MakeBox(color_curr_inv_p2, cursor_tmp, width, height / 5);
 				};
-				if (bool(p2state.invul & Attribute::B)) {
+				if (bool(p2state.get_invul() & Attribute::B)) {
 					cursor_tmp = cursor_p2;
 					cursor_tmp.y = cursor_p2.y + height / 2 - ((height / 5) / 2);
 					MakeBox(color_curr_inv_p2, cursor_tmp, width, height / 5);
 				}
-				if (bool(p2state.invul & Attribute::F)) {
+				if (bool(p2state.get_invul() & Attribute::F)) {
 					cursor_tmp = cursor_p2;
 					cursor_tmp.y = cursor_p2.y + height - (height / 5);
 					MakeBox(color_curr_inv_p2, cursor_tmp, width, height / 5);
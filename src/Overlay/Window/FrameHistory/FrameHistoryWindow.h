@@ -23,6 +23,7 @@ public:
 			width = g_modVals.frame_history_width;
 			height = g_modVals.frame_history_height;
 			spacing = g_modVals.frame_history_spacing;
+			history.set_depth(g_modVals.frame_history_depth);
 		}
 
 	void Update() override;
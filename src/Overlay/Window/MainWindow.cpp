@@ -216,6 +216,20 @@ void MainWindow::DrawFrameHistorySection() const
 	if (ImGui::SliderFloat("spacing", &frameHistWin->spacing, 1., 100.)) {
 		Settings::changeSetting("FrameHistorySpacing", std::to_string(frameHistWin->spacing));
 	};
+	ImGui::HorizontalSpacing();
+	static int history_depth = g_modVals.frame_history_depth;
+	ImGui::InputInt("History depth", &history_depth, 60, 600);
+	ImGui::SameLine();
+	if (ImGui::Button("Apply##framehistory_depth")) {
+		frameHistWin->history.set_depth(history_depth);
+		history_depth = (int)frameHistWin->history.read().capacity();
+		g_modVals.frame_history_depth = history_depth;
+		Settings::changeSetting("FrameHistoryDepth", std::to_string(history_depth));
+	}
+	ImGui::SameLine();
+	ImGui::ShowHelpMarker("How many frames are kept, changing it clears the history. Only as many as fit in the window are drawn.");
+	ImGui::HorizontalSpacing();
+	ImGui::Text("Update cost: %lldus (avg %.1fus)", frameHistWin->history.last_update_us, frameHistWin->history.avg_update_us);
 
 	
 }
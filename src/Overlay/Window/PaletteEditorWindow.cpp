@@ -225,6 +225,12 @@ void PaletteEditorWindow::ShowReloadAllPalettesButton()
 	{
 		g_interfaces.pPaletteManager->ReloadAllPalettes();
 	}
+
+	if (g_interfaces.pPaletteManager->IsLoadingPalettes())
+	{
+		ImGui::SameLine();
+		ImGui::TextDisabled("Loading...");
+	}
 }
 
 void PaletteEditorWindow::OnMatchInit()
@@ -646,6 +652,7 @@ void PaletteEditorWindow::ReloadSavedPalette(const char* palName)
 {
 	g_imGuiLogger->EnableLog(false);
 	g_interfaces.pPaletteManager->ReloadAllPalettes();
+	g_interfaces.pPaletteManager->WaitForPaletteLoad();
 	g_imGuiLogger->EnableLog(true);
 
 	//find the newly loaded custom pal
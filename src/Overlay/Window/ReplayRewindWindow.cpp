@@ -6,33 +6,7 @@
 #include "Overlay/imgui_utils.h"
 
 unsigned int ReplayRewindWindow::count_entities(bool unk_status2) {
-    if (!g_interfaces.player1.IsCharDataNullPtr() && !g_interfaces.player2.IsCharDataNullPtr()) {
-        std::vector<int*> entities{};
-        std::vector<CharData**> entities_char_data{};
-        for (int i = 0; i < 252; i++) {
-            entities.push_back((g_gameVals.pEntityList + i));
-            //entities_char_data.push_back((CharData*)(g_gameVals.pEntityList + i));
-        }
-        for (auto entity_ptr : entities) {
-            entities_char_data.push_back((CharData**)entity_ptr);
-        }
-        auto tst = entities_char_data[0];
-        auto r = 0;
-        for (auto entity : entities_char_data) {
-            if ((*entity)->unknownStatus1 != NULL) {
-                if (unk_status2) {
-                    if ((*entity)->unknown_status2 != NULL && (*entity)->unknown_status2 == 2) {
-                        r++;
-                    }
-                }
-                else {
-                    r++;
-                }
-            }
-        }
-        return r;
-    }
-    return 0;
+    return g_interfaces.pReplayRewindManager->count_entities(unk_status2);
 }
 std::vector<int> ReplayRewindWindow::find_nearest_checkpoint(std::vector<unsigned int> frameCount) {
     //returns a vector with the fist being the nearest pos in the checkpoints for a backwards and the second for the fwd, -1 if not available
@@ -109,13 +83,9 @@ void ReplayRewindWindow::Draw()
 
                     }
                     ImGui::SameLine();
-                    ImGui::ShowHelpMarker("Replay rewind can currently hold up to 10 \"checkpoints\" at a time to rewind to. These checkpoints are saved as the replay progresses at defined intervals(1s,3s or 9s). With replay interval set to 9s for example you will save checkpoints at second 0,9,18...,90.\n\
-\n\
-You can also change them during the replay itself to refine the rewind, say for example you found something interesting at second 16 while having rewind interval as 9s:\n\
+                    ImGui::ShowHelpMarker("Replay rewind saves \"checkpoints\" as the replay progresses and goes back by the selected rewind interval(1s,3s or 9s) to the nearest checkpoint before that.\n\
 \n\
-\t - Rewind until you reach the checkpoint at second 9\n\
-\t - Change the rewind interval to 1s or 3s\n\
-\t - Now as it reaches the desired position it will have recorded the previous checkpoints in smaller intervals, allowing you to wait less to reach the desired part / analyze the lead up to it.\n\
+Checkpoints are saved every half second, once the memory budget (ReplayRewindMemoryBudgetMB in settings.ini) is reached the older ones get thinned out, so rewinding a short distance lands almost exactly where you asked while going far back lands a bit earlier than the target.\n\
 \n\
 You can see the frames of all saved checkpoints and more advanced info on the \"Saved Checkpoints Advanced Info\" section above.");
                 }
@@ -126,12 +96,45 @@ You can see the frames of all saved checkpoints and more advanced info on the \"
             ImGui::BeginGroup();
             {
                 
-                ImGui::Text("Rewind Interval"); ImGui::SameLine(); ImGui::ShowHelpMarker("Defines the interval to save the rewind \"checkpoint\". For more info see the help bar on \"Rewind\" button");
+                ImGui::Text("Rewind Interval"); ImGui::SameLine(); ImGui::ShowHelpMarker("Defines how far back each press of \"Rewind\" goes. For more info see the help bar on \"Rewind\" button");
                 ImGui::RadioButton("1s", &g_interfaces.pReplayRewindManager->FRAME_STEP, 60); ImGui::SameLine();
                 ImGui::RadioButton("3s", &g_interfaces.pReplayRewindManager->FRAME_STEP, 180); ImGui::SameLine();
                 ImGui::RadioButton("9s", &g_interfaces.pReplayRewindManager->FRAME_STEP, 540);
             }
             ImGui::EndGroup();
+
+            ReplayRewind* rewind_manager = g_interfaces.pReplayRewindManager;
+            if (rewind_manager->checkpoint_scheduler.size() > 0) {
+                static int seek_target_frame = 0;
+                int seek_min = (int)rewind_manager->checkpoint_scheduler.get_checkpoints().begin()->first;
+                int seek_max = (int)rewind_manager->checkpoint_scheduler.get_checkpoints().rbegin()->first;
+                if ((int)*g_gameVals.pFrameCount > seek_max) {
+                    seek_max = (int)*g_gameVals.pFrameCount;
+                }
+                if (seek_target_frame < seek_min || seek_target_frame > seek_max) {
+                    seek_target_frame = (int)*g_gameVals.pFrameCount;
+                }
+                ImGui::SliderInt("##seek_frame", &seek_target_frame, seek_min, seek_max, "Frame %.0f");
+                ImGui::SameLine();
+                if (ImGui::Button("Seek")) {
+                    rewind_manager->seek_to_frame((unsigned int)seek_target_frame);
+                }
+                ImGui::SameLine();
+                ImGui::ShowHelpMarker("Jumps to the exact frame selected: loads the nearest checkpoint before it and simulates the frames in between without drawing them. The replay stays on whatever speed it was on.");
+                if (rewind_manager->snap_apparatus_replay_rewind != nullptr) {
+                    ImGui::Text("Last checkpoint cost on game thread: %lldus (staging copy %lldus)",
+                        rewind_manager->snap_apparatus_replay_rewind->last_save_us, rewind_manager->snap_apparatus_replay_rewind->snapshot_store.last_stage_us.load());
+                    if (rewind_manager->last_thin_dropped > 0) {
+                        ImGui::Text("Last thinning cost on game thread: %lldus (%d dropped, fold on worker %lldus)",
+                            rewind_manager->last_thin_us, rewind_manager->last_thin_dropped,
+                            rewind_manager->snap_apparatus_replay_rewind->snapshot_store.last_remove_us.load());
+                    }
+                }
+                if (rewind_manager->last_seek_us > 0) {
+                    ImGui::Text("Last seek: %.2f ms (checkpoint at frame %u, %d frames simulated)",
+                        rewind_manager->last_seek_us / 1000.0, rewind_manager->last_seek_checkpoint_frame, rewind_manager->last_seek_frames_simulated);
+                }
+            }
 #ifdef _DEBUG
 
             ImGui::Separator();
@@ -140,8 +143,17 @@ You can see the frames of all saved checkpoints and more advanced info on the \"
                 ImGui::Text("Rewind pos: +%d", g_interfaces.pReplayRewindManager->rewind_pos);
                 //auto nearest_pos = ReplayRewindWindow::find_nearest_checkpoint(frame_checkpoints_clipped);
                 //ImGui::Text("Rewind checkpoint: %d    FF checkpoint(nearest): %d", nearest_pos[0], nearest_pos[1]);
-                ImGui::Text("snap_apparatus snapshot_count: %d", snap_apparatus_replay_rewind->snapshot_count);
                 if (snap_apparatus_replay_rewind != nullptr) {
+                    ImGui::Text("snap_apparatus snapshot_count: %d", snap_apparatus_replay_rewind->snapshot_count);
+                    SnapshotStore& store = snap_apparatus_replay_rewind->snapshot_store;
+                    ImGui::Text("Snapshot store: %d checkpoints, %.2f MB (raw %.2f MB)", store.size(),
+                        store.get_encoded_bytes() / (1024.0 * 1024.0), store.get_raw_bytes() / (1024.0 * 1024.0));
+                    ImGui::Text("Last encode: %lldus    Last decode: %lldus", store.last_encode_us.load(), store.last_decode_us.load());
+                    CheckpointScheduler& scheduler = g_interfaces.pReplayRewindManager->checkpoint_scheduler;
+                    ImGui::Text("Scheduled checkpoints: %d (budget %.0f MB)", scheduler.size(), scheduler.memory_budget / (1024.0 * 1024.0));
+                    for (auto& checkpoint : scheduler.get_checkpoints()) {
+                        ImGui::Text("Frame %u -> store index %d", checkpoint.first, checkpoint.second);
+                    }
                     static_DAT_of_PTR_on_load_4* DAT_on_load_4_addr = (static_DAT_of_PTR_on_load_4*)(bbcf_base_adress + 0x612718);
                     SnapshotManager* snap_manager = 0;
                     snap_manager = DAT_on_load_4_addr->ptr_snapshot_manager_mine;
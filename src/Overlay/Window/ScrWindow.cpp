@@ -8,6 +8,11 @@
 #include "Game/ReplayFiles/ReplayFile.h"
 #include "Game/ReplayFiles/ReplayList.h"
 #include "Game/ReplayFiles/ReplayFileManager.h"
+#include "Game/ReplayFiles/ReplayArchiveIndex.h"
+#include "Game/ReplayFiles/ReplayArchiveStats.h"
+#include "Game/ReplayFiles/ReplayArchiveJob.h"
+#include "Game/Scr/ScrScriptCache.h"
+#include "Game/Playbacks/PlaybackLibrary.h"
 #include "Game/Menus/TrainingSetupMenu.h"
 #include "Game/ScenesManager/ScenesManager.h"
 #include "Overlay/NotificationBar/NotificationBar.h"
@@ -251,6 +256,26 @@ bool find_substring_in_vector(std::vector<std::string> string_vector, std::strin
     };
     return false;
 }
+void ScrWindow::reset_state_registers() {
+    gap_register = {};
+    gap_register_delays = {};
+    wakeup_register = {};
+    wakeup_register_delays = {};
+    onhit_register = {};
+    onhit_register_delays = {};
+    throwtech_register = {};
+    throwtech_register_delays = {};
+    burst_action = nullptr;
+    air_burst_action = nullptr;
+    for (auto state : g_interfaces.player2.states) {
+        if (state->name == "CmnActBurstBegin") {
+            burst_action = state;
+        }
+        if (state->name == "CmnActAirBurstBegin") {
+            air_burst_action = state;
+        }
+    }
+}
 void ScrWindow::DrawStatesSection()
 {
     if (*g_gameVals.pGameMode == GameMode_Training) {
@@ -282,35 +307,25 @@ void ScrWindow::DrawStatesSection()
     //Code for auto loading script upon character switch, prob move it to OnMatchInit() or smth
    if (p2_old_char_data == NULL || p2_old_char_data != (void*)g_interfaces.player2.GetData()){
         char* bbcf_base_adress = GetBbcfBaseAdress();
-        std::vector<scrState*> states = parse_scr(bbcf_base_adress, 2);
-        g_interfaces.player2.SetScrStates(states);
-        g_interfaces.player2.states = states;
+        g_interfaces.player2.SetScrStates(parse_scr(bbcf_base_adress, 2));
         p2_old_char_data = (void*)g_interfaces.player2.GetData();
-        for (auto& state : states) {
-            if (state->name == "CmnActBurstBegin") {
-                burst_action = state;
-            }
-            if (state->name == "CmnActAirBurstBegin") {
-                air_burst_action = state;
-            }
-        }
         frame_to_burst_onhit = 0;
-        gap_register = {};
-        wakeup_register = {};
-        onhit_register = {};
+        reset_state_registers();
         selected = 0;
     }
 
 
     if (ImGui::Button("Force Load P2 Script")) {
         char* bbcf_base_adress = GetBbcfBaseAdress();
-        std::vector<scrState*> states = parse_scr(bbcf_base_adress, 2);
-        g_interfaces.player2.SetScrStates(states);
-        g_interfaces.player2.states = states;
-        gap_register = {};
-        wakeup_register = {};
+        g_interfaces.player2.SetScrStates(g_scr_script_cache.get(bbcf_base_adress, 2, true));
+        reset_state_registers();
         selected = 0;
     }
+#ifdef _DEBUG
+    ImGui::Text("Script cache: %d scripts, %d memory hits, %d disk hits, %d parses, last load %lldus",
+        g_scr_script_cache.get_size(), g_scr_script_cache.memory_hits, g_scr_script_cache.disk_hits,
+        g_scr_script_cache.parses, g_scr_script_cache.last_get_us);
+#endif
     auto states = g_interfaces.player2.states;
     {
         ImGui::BeginChild("left pane", ImVec2(200, 0), true);
@@ -366,7 +381,7 @@ void ScrWindow::DrawStatesSection()
                 float window_visible_x2 = ImGui::GetWindowPos().x + ImGui::GetWindowContentRegionMax().x;
                 ImGuiStyle& style = ImGui::GetStyle();
                 int after_non_deterministic = 0;
-                for (auto& frame_activity : selected_state->frame_activity_status) {
+                for (auto frame_activity : selected_state->frame_activity_status) {
                     if (iter_scr_frames > 500) {//needed to limit the amount of drawn frames to keep it from crashing on way too long states(rp based probably/too many branches prob)
                         ImGui::Text("+ Too long to show all"); 
                         break; }
@@ -426,7 +441,7 @@ void ScrWindow::DrawStatesSection()
                     }
                     iter_scr_frames = 1;
                     auto frames_before_ptr = &ea_state_pair.first;
-                    std::vector<FrameActivity>* frame_activity_status_ptr = &ea_state_pair.second.frame_activity_status;
+                    const ScrFrameTrack<FrameActivity>* frame_activity_status_ptr = &ea_state_pair.second->frame_activity_status;
                     //std::string fstring = "A";
                     if (!std::any_of(frame_activity_status_ptr->begin(), 
                         frame_activity_status_ptr->end(), 
@@ -438,7 +453,7 @@ void ScrWindow::DrawStatesSection()
                     //if (std::find(frame_activity_status_ptr->begin(), frame_activity_status_ptr->end(), fstring) != frame_activity_status_ptr->end()) {
                    //     continue;
                    // }
-                    ImGui::Text("%s", ea_state_pair.second.name.c_str());
+                    ImGui::Text("%s", ea_state_pair.second->name.c_str());
                     //will not draw unless there are active frames on the EA state
                     
                     std::vector<FrameActivity> temp_vect = {};
@@ -534,7 +549,7 @@ void ScrWindow::DrawStatesSection()
 
                 }
             }
-            if (*g_gameVals.pFrameCount == frame_to_burst_onhit) {
+            if (*g_gameVals.pFrameCount == frame_to_burst_onhit && burst_action && air_burst_action) {
                 if (g_interfaces.player2.GetData()->position_y > 0) {
                     /*memcpy(&(g_interfaces.player2.GetData()->nextScriptLineLocationInMemory), &(air_burst_action->addr), 4);
                     g_interfaces.player2.GetData()->frameCounterCurrentSprite = g_interfaces.player2.GetData()->frameLengthCurrentSprite2;
@@ -987,21 +1002,28 @@ void ScrWindow::draw_playback_slot_section(int slot) {
 
 
 
-    std::vector<char> slot_recording_frames = selected_slot.get_slot_buffer();
+    static const char* playback_file_status[4] = { "", "", "", "" };
     if (ImGui::Button("Save")) {
-        playback_manager.save_to_file(slot_recording_frames, facing_direction, fpath);
+        //the dummy is the one playing the slot back
+        int char_index = g_interfaces.player2.IsCharDataNullPtr() ? -1 : g_interfaces.player2.GetData()->charIndex;
+        bool saved = playback_manager.save_to_file(selected_slot.get_slot_inputs(), facing_direction, char_index, fpath);
+        playback_file_status[slot - 1] = saved ? "Saved" : "Couldn't save the file";
     }
     ImGui::SameLine();
     if (ImGui::Button("Load")) {
-        playback_manager.load_from_file_into_slot(fpath,slot);
-
+        bool loaded = playback_manager.load_from_file_into_slot(fpath,slot);
+        playback_file_status[slot - 1] = loaded ? "Loaded" : "Couldn't load the file, is it a .playback?";
     }
     ImGui::SameLine();
     if (ImGui::Button("Trim Playback")) {
-        slot_recording_frames = playback_manager.trim_playback(slot_recording_frames);
-        playback_manager.load_into_slot(slot_recording_frames, slot);
+        std::vector<uint16_t> slot_inputs = playback_manager.trim_playback(selected_slot.get_slot_inputs());
+        selected_slot.load_inputs_into_slot(slot_inputs.data(), slot_inputs.size());
         //load_trimmed_playback(slot_recording_frames, selected_slot.frame_len_slot_p, start_of_slot_inputs);
     }
+    if (playback_file_status[slot - 1][0] != 0) {
+        ImGui::SameLine();
+        ImGui::TextDisabled("%s", playback_file_status[slot - 1]);
+    }
 
     ImGui::InputText("File Path", fpath, 1200);// IM_ARRAYSIZE(fpath));
     ImGui::TextWrapped("All input files expect the .playback extension now, please add the extension to your old playback files. You can still load the files with .playback extension without writing the extension in the field.");
@@ -1035,6 +1057,7 @@ void ScrWindow::draw_playback_slot_section(int slot) {
     ImGui::InputInt("Buffer frames", &slot_buffer[slot-1]);
     ImGui::TextWrapped("Buffer frames only works currently with wakeup actions");
     ImGui::Separator();
+    std::vector<char> slot_recording_frames = selected_slot.get_slot_buffer();
     auto old_val = 0; auto frame_counter = 0;
     for (auto el : slot_recording_frames) {
         frame_counter++;
@@ -1046,6 +1069,73 @@ void ScrWindow::draw_playback_slot_section(int slot) {
     }
     ImGui::PopID();
 };
+void ScrWindow::draw_playback_library_section() {
+    g_playback_library.poll();
+    static int library_character = -1;
+    static int library_tag = -1; // index into the tags, -1 for any
+    static int target_slot = 1;
+    char* fpaths[4] = { fpath_s1, fpath_s2, fpath_s3, fpath_s4 };
+
+    ImGui::Text("%d playbacks in ./slots, %d preloaded (last scan %lldus)", g_playback_library.size(), g_playback_library.get_preloaded_count(), g_playback_library.last_scan_us);
+    ImGui::SameLine();
+    if (ImGui::Button("Rescan##playback_library")) {
+        g_playback_library.scan();
+    }
+    ImGui::SameLine();
+    ImGui::ShowHelpMarker("Every .playback under the slots folder, subfolders show up as tags. The list updates on its own when files are added or changed. Clicking one loads it into the target slot, once a playback was loaded it stays in memory so switching back to it is instant.\nFiles saved before the character was stored in them show up for every character.");
+
+    if (ImGui::BeginCombo("Character##playback_library", library_character == -1 ? "<any>" : getCharacterNameByIndexA(library_character).c_str())) {
+        if (ImGui::Selectable("<any>", library_character == -1)) library_character = -1;
+        for (int i = 0; i < getCharactersCount(); i++) {
+            if (ImGui::Selectable(getCharacterNameByIndexA(i).c_str(), library_character == i))
+                library_character = i;
+        }
+        ImGui::EndCombo();
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Dummy's##playback_library") && !g_interfaces.player2.IsCharDataNullPtr()) {
+        library_character = g_interfaces.player2.GetData()->charIndex;
+    }
+    std::vector<std::string> tags = g_playback_library.get_tags();
+    if (library_tag >= (int)tags.size()) {
+        library_tag = -1;
+    }
+    if (ImGui::BeginCombo("Tag##playback_library", library_tag == -1 ? "<any>" : (tags[library_tag].empty() ? "<none>" : tags[library_tag].c_str()))) {
+        if (ImGui::Selectable("<any>", library_tag == -1)) library_tag = -1;
+        for (int i = 0; i < (int)tags.size(); i++) {
+            if (ImGui::Selectable(tags[i].empty() ? "<none>" : tags[i].c_str(), library_tag == i))
+                library_tag = i;
+        }
+        ImGui::EndCombo();
+    }
+    ImGui::Text("Load into:");
+    for (int slot = 1; slot <= 4; slot++) {
+        ImGui::SameLine();
+        ImGui::RadioButton((std::string("Slot ") + std::to_string(slot) + "##playback_library").c_str(), &target_slot, slot);
+    }
+
+    std::vector<const PlaybackLibraryEntry*> listed = g_playback_library.query(library_character, library_tag == -1 ? NULL : &tags[library_tag]);
+    if (ImGui::Button("Preload listed##playback_library")) {
+        for (auto entry : listed) {
+            g_playback_library.preload(entry->name);
+        }
+    }
+    ImGui::BeginChild("##playback_library_list", ImVec2(0, 200), true);
+    for (auto entry : listed) {
+        bool in_slot = strcmp(fpaths[target_slot - 1], entry->name.c_str()) == 0;
+        std::string label = entry->name + "  (" + std::to_string(entry->frame_count) + "f" + (entry->loaded != NULL ? ", in memory" : "") + ")";
+        if (ImGui::Selectable(label.c_str(), in_slot)) {
+            std::shared_ptr<PlaybackFile> playback = g_playback_library.preload(entry->name);
+            if (playback != NULL) {
+                playback_manager.load_playback_into_slot(*playback, target_slot);
+                // so Save/Load in the slot's own section point at the same file
+                strncpy(fpaths[target_slot - 1], entry->name.c_str(), 1199);
+                fpaths[target_slot - 1][1199] = 0;
+            }
+        }
+    }
+    ImGui::EndChild();
+}
 void ScrWindow::DrawPlaybackEditor() {
     if (ImGui::Button("Open Playback Editor")) {
         ScrWindow::m_pWindowContainer->GetWindow(WindowType_PlaybackEditor)->ToggleOpen();
@@ -1077,6 +1167,10 @@ void ScrWindow::DrawPlaybackSection() {
         if (ImGui::CollapsingHeader("SLOT_4")) {
             draw_playback_slot_section(4);
         }
+
+        if (ImGui::CollapsingHeader("Playback library")) {
+            draw_playback_library_section();
+        }
         
 
         //setup for randomized slots
@@ -1572,22 +1666,7 @@ void ScrWindow::DrawReplayTheaterSection() {
             ImGui::RadioButton("Replay db", &view_type, 2);
 
 
-            if (view_type == 1) { // archive controls
-                ImGui::TextUnformatted("page");
-
-                ImGui::SameLine();
-
-                if (ImGui::InputInt("##replay_list_page", &page))
-                    view_changed = true;
-
-                // TODO: search?
-
-                if (view_changed)
-                    g_rep_manager.load_replay_list_from_archive(page);
-            }
-
-
-            if (view_type == 2) { // db controls
+            if (view_type == 1 || view_type == 2) { // archive/db filters
                 if (ImGui::BeginCombo("character1##replay_db_character", character1 == -1 ? "<any>" : getCharacterNameByIndexA(character1).c_str())) {
 
                     if (ImGui::Selectable("<any>", character1 == -1)) character1 = -1;
@@ -1625,8 +1704,106 @@ void ScrWindow::DrawReplayTheaterSection() {
 
                 ImGui::SameLine();
 
-                ImGui::InputInt("##replay_list_page", &page);
+                if (ImGui::InputInt("##replay_list_page", &page) && view_type == 1)
+                    view_changed = true;
+            }
+
+            if (view_type == 1) { // archive controls
+                // filtering only queries the archive index, the replay files are just opened to copy the visible page
+                static int prev_character1 = -1;
+                static int prev_character2 = -1;
+                static std::string prev_player1 = "";
+                static std::string prev_player2 = "";
+                if (character1 != prev_character1 || character2 != prev_character2 || prev_player1 != player1 || prev_player2 != player2) {
+                    prev_character1 = character1;
+                    prev_character2 = character2;
+                    prev_player1 = player1;
+                    prev_player2 = player2;
+                    view_changed = true;
+                }
 
+                static int archive_matches = 0;
+                static ReplayArchiveJob archive_job;
+                static ReplayArchiveStatsResult archive_stats = {};
+                static bool archive_stats_loaded = false;
+                static std::vector<double> scaling;
+                switch (archive_job.poll()) {
+                case ReplayArchiveJob_RebuildIndex:
+                    view_changed = true;
+                    break;
+                case ReplayArchiveJob_BuildStats:
+                    if (archive_job.succeeded()) {
+                        archive_stats = archive_job.get_stats();
+                    }
+                    break;
+                case ReplayArchiveJob_MeasureScaling:
+                    scaling = archive_job.get_scaling();
+                    break;
+                default:
+                    break;
+                }
+                if (ImGui::Button("Rebuild index##replay_archive")) {
+                    archive_job.start_rebuild_index();
+                }
+                if (view_changed) {
+                    g_rep_manager.load_replay_list_from_archive(page, character1, player1, character2, player2);
+                    archive_matches = g_replay_archive_index.count_matches(character1, player1, character2, player2);
+                }
+
+                ImGui::SameLine();
+                ImGui::Text("%d matching archived replays (page built in %.2f ms)", archive_matches, g_rep_manager.last_page_build_us / 1000.0);
+                ImGui::SameLine();
+                ImGui::ShowHelpMarker("The archive is listed from Save/Replay/archive_index.dat, it gets rebuilt on its own when files are added to the archive folder by hand.");
+
+                if (archive_job.is_running()) {
+                    const ReplayArchiveProgress& progress = archive_job.get_progress();
+                    const char* label = archive_job.get_kind() == ReplayArchiveJob_RebuildIndex ? "Rebuilding the index"
+                        : archive_job.get_kind() == ReplayArchiveJob_BuildStats ? "Building matchup stats" : "Measuring thread scaling";
+                    if (progress.total > 0) {
+                        ImGui::Text("%s... %d/%d", label, progress.done.load(), progress.total.load());
+                    }
+                    else {
+                        ImGui::Text("%s...", label);
+                    }
+                }
+
+                if (ImGui::TreeNode("Archive matchup stats##replay_archive")) {
+                    if (!archive_stats_loaded) {
+                        ReplayArchiveStats::load(archive_stats);
+                        archive_stats_loaded = true;
+                    }
+                    if (ImGui::Button("Build##replay_archive_stats")) {
+                        archive_job.start_build_stats(ReplayArchiveStats::get_default_thread_count());
+                    }
+                    ImGui::SameLine();
+                    if (ImGui::Button("Measure thread scaling##replay_archive_stats")) {
+                        archive_job.start_measure_scaling(ReplayArchiveStats::get_default_thread_count());
+                    }
+                    ImGui::SameLine();
+                    ImGui::ShowHelpMarker("Goes through every archived replay on several threads and saves win rates, round counts and input density per matchup to Save/Replay/archive_stats.dat. Runs in the background, one job at a time.");
+                    if (archive_stats.threads > 0) {
+                        ImGui::Text("%d replays (%d invalid) in %.2fs on %d threads", archive_stats.replays, archive_stats.invalid, archive_stats.seconds, archive_stats.threads);
+                    }
+                    for (int i = 0; i < (int)scaling.size(); i++) {
+                        ImGui::Text("%d threads: %.3fs (x%.2f)", i + 1, scaling[i], scaling[i] > 0 ? scaling[0] / scaling[i] : 0);
+                    }
+                    ImGui::Separator();
+                    for (int p1 = 0; p1 < REPLAY_ARCHIVE_STATS_TOONS; p1++) {
+                        for (int p2 = 0; p2 < REPLAY_ARCHIVE_STATS_TOONS; p2++) {
+                            const MatchupStats& m = archive_stats.matchups[p1][p2];
+                            if (m.games == 0) {
+                                continue;
+                            }
+                            ImGui::Text("%s vs %s: %u games, P1 %.0f%% / P2 %.0f%%, %.1f rounds/game, %.1f inputs/s",
+                                getCharacterNameByIndexA(p1).c_str(), getCharacterNameByIndexA(p2).c_str(), m.games,
+                                100.0 * m.p1_wins / m.games, 100.0 * m.p2_wins / m.games, (double)m.rounds / m.games, m.get_input_density());
+                        }
+                    }
+                    ImGui::TreePop();
+                }
+            }
+
+            if (view_type == 2) { // db controls
                 if (ImGui::Button("Load##replay_db"))
                     g_rep_manager.load_replay_list_from_db(page, character1, player1, character2, player2);
                 // TODO: instead of Load button, we could use view_changed and debounce
@@ -1792,32 +1969,10 @@ void ScrWindow::DrawReplayTheaterSection() {
 
 
 unsigned int count_entities(bool unk_status2) {
+    static EntityTracker entity_tracker;
     if (!g_interfaces.player1.IsCharDataNullPtr() && !g_interfaces.player2.IsCharDataNullPtr()) {
-        std::vector<int*> entities{};
-        std::vector<CharData**> entities_char_data{};
-        for (int i = 0; i < 252; i++) {
-            entities.push_back((g_gameVals.pEntityList + i));
-            //entities_char_data.push_back((CharData*)(g_gameVals.pEntityList + i));
-        }
-        for (auto entity_ptr : entities) {
-            entities_char_data.push_back((CharData**)entity_ptr);
-        }
-        auto tst = entities_char_data[0];
-        auto r = 0;
-        for (auto entity : entities_char_data) {
-            if ((*entity)->unknownStatus1 != NULL) {
-                if (unk_status2) {
-                    if ((*entity)->unknown_status2 != NULL && (*entity)->unknown_status2 == 2) {
-                        r++;
-                    }
-                }
-                else {
-                    r++;
-                }
-            }
-        }
-        return r;
-        //auto tst = &entities_char_data[0]->frame_count_minus_1;
+        entity_tracker.refresh_active();
+        return unk_status2 ? entity_tracker.get_status2_count() : entity_tracker.get_active_count();
     }
     return 0;
 }
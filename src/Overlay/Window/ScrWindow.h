@@ -25,6 +25,7 @@ private:
 	void DrawGenericOptionsSection();
 	void DrawStatesSection();
 	void draw_playback_slot_section(int slot);
+	void draw_playback_library_section();
 	void DrawPlaybackSection();
 	void DrawReplayTheaterSection();
 	void DrawReplayRewind();
@@ -36,6 +37,7 @@ private:
 	void DrawInputBufferButton();
 	void DrawPlaybackEditor();
 	void DrawComboDataButton();
+	void reset_state_registers(); // the registers point into player2's script arena, has to run whenever it gets replaced
 	PlaybackManager playback_manager;
 	bool m_showDemoWindow = false;
 	void* p2_old_char_data = NULL;
@@ -47,8 +49,8 @@ private:
 	std::vector<int> onhit_register_delays{};
 	std::vector<scrState*> throwtech_register{};
 	std::vector<int> throwtech_register_delays{};
-	scrState* burst_action;
-	scrState* air_burst_action;
+	scrState* burst_action = nullptr;
+	scrState* air_burst_action = nullptr;
 
 
 
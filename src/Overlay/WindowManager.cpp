@@ -225,6 +225,9 @@ void WindowManager::Render()
 		return;
 	}
 
+	// Before the early outs, palettes finish loading even while nothing is drawn
+	g_interfaces.pPaletteManager->PublishLoadedPalettes();
+
 	if (g_interfaces.pSteamApiHelper->IsSteamOverlayActive())
 	{
 		return;
@@ -0,0 +1,147 @@
+#include "PaletteIndex.h"
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+	template <typename T>
+	bool ReadValue(const std::string& buffer, size_t& pos, T& value)
+	{
+		if (buffer.size() - pos < sizeof(T))
+			return false;
+
+		memcpy(&value, buffer.data() + pos, sizeof(T));
+		pos += sizeof(T);
+		return true;
+	}
+
+	bool ReadString(const std::string& buffer, size_t& pos, size_t length, std::string& value)
+	{
+		if (buffer.size() - pos < length)
+			return false;
+
+		value.assign(buffer.data() + pos, length);
+		pos += length;
+		return true;
+	}
+
+	template <typename T>
+	void WriteValue(std::string& buffer, T value)
+	{
+		buffer.append((const char*)&value, sizeof(T));
+	}
+}
+
+bool PaletteIndex::Load(const char* path)
+{
+	Clear();
+
+	std::ifstream file(path, std::ios::binary);
+	if (!file.is_open())
+		return false;
+
+	std::stringstream ss;
+	ss << file.rdbuf();
+	const std::string buffer = ss.str();
+
+	size_t pos = 0;
+	std::string magic;
+	uint32_t version = 0;
+	uint32_t count = 0;
+	if (!ReadString(buffer, pos, 4, magic) || magic != PALETTE_INDEX_MAGIC ||
+		!ReadValue(buffer, pos, version) || version != PALETTE_INDEX_VERSION ||
+		!ReadValue(buffer, pos, count))
+	{
+		return false;
+	}
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		PaletteIndexEntry entry;
+		uint16_t pathLength = 0;
+		uint16_t headerLength = 0;
+
+		if (!ReadValue(buffer, pos, pathLength) || !ReadString(buffer, pos, pathLength, entry.path) ||
+			!ReadValue(buffer, pos, entry.mtime) || !ReadValue(buffer, pos, entry.size) ||
+			!ReadValue(buffer, pos, entry.headerHash) ||
+			!ReadValue(buffer, pos, headerLength) || !ReadString(buffer, pos, headerLength, entry.header))
+		{
+			// Truncated, keep what was read before it
+			return false;
+		}
+
+		if (fnv1a64(entry.header.data(), entry.header.size()) != entry.headerHash)
+			continue;
+
+		Add(entry);
+	}
+
+	return true;
+}
+
+bool PaletteIndex::Save(const char* path) const
+{
+	std::string buffer(PALETTE_INDEX_MAGIC);
+	WriteValue<uint32_t>(buffer, PALETTE_INDEX_VERSION);
+	WriteValue<uint32_t>(buffer, (uint32_t)m_entries.size());
+
+	for (const PaletteIndexEntry& entry : m_entries)
+	{
+		WriteValue<uint16_t>(buffer, (uint16_t)entry.path.size());
+		buffer += entry.path;
+		WriteValue<uint64_t>(buffer, entry.mtime);
+		WriteValue<uint64_t>(buffer, entry.size);
+		WriteValue<uint64_t>(buffer, entry.headerHash);
+		WriteValue<uint16_t>(buffer, (uint16_t)entry.header.size());
+		buffer += entry.header;
+	}
+
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+		return false;
+
+	file.write(buffer.data(), buffer.size());
+	return file.good();
+}
+
+const PaletteIndexEntry* PaletteIndex::Find(const std::string& path, uint64_t mtime, uint64_t size) const
+{
+	auto it = m_byPath.find(path);
+	if (it == m_byPath.end())
+		return NULL;
+
+	const PaletteIndexEntry& entry = m_entries[it->second];
+	if (entry.mtime != mtime || entry.size != size)
+		return NULL;
+
+	return &entry;
+}
+
+void PaletteIndex::Add(const PaletteIndexEntry& entry)
+{
+	if (entry.path.size() > 0xFFFF || entry.header.size() > 0xFFFF)
+		return;
+
+	auto it = m_byPath.find(entry.path);
+	if (it != m_byPath.end())
+	{
+		m_entries[it->second] = entry;
+		return;
+	}
+
+	m_byPath[entry.path] = (int)m_entries.size();
+	m_entries.push_back(entry);
+}
+
+int PaletteIndex::GetEntryCount() const
+{
+	return (int)m_entries.size();
+}
+
+void PaletteIndex::Clear()
+{
+	m_entries.clear();
+	m_byPath.clear();
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include "Core/hash.h"
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#define PALETTE_INDEX_PATH "BBCF_IM\\PaletteIndex.bin"
+#define PALETTE_INDEX_MAGIC "PIDX"
+#define PALETTE_INDEX_VERSION 2
+
+struct PaletteIndexEntry
+{
+	std::string path;
+	uint64_t mtime = 0;
+	uint64_t size = 0;
+	std::string header; // the start of the file, up to where the colour data begins
+	uint64_t headerHash = 0;
+};
+
+/*
+	On-disk cache of the palette files, keyed by path and checked against the file's modification time and size.
+	A file that hasn't changed since the last load is served from here instead of being opened again, which is
+	most of the startup cost with a few thousand palettes. Only the header the palette list is built from is kept,
+	the colour data is read from the palette file itself once the palette gets used. The headers are hashed so a
+	damaged index only costs a reread of the entries that don't check out.
+*/
+class PaletteIndex
+{
+public:
+	// Entries that fail their hash are dropped, a missing or unreadable file leaves the index empty
+	bool Load(const char* path);
+	bool Save(const char* path) const;
+
+	// NULL if the path isn't indexed or the file changed since
+	const PaletteIndexEntry* Find(const std::string& path, uint64_t mtime, uint64_t size) const;
+	void Add(const PaletteIndexEntry& entry);
+	int GetEntryCount() const;
+	void Clear();
+
+private:
+	std::vector<PaletteIndexEntry> m_entries;
+	std::unordered_map<std::string, int> m_byPath;
+};
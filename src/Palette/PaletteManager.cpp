@@ -9,10 +9,14 @@
 #include "impl_templates.cpp"
 
 #include <atlstr.h>
+#include <condition_variable>
+#include <fstream>
 #include <sstream>
 #include <random>
 
 #define MAX_NUM_OF_PAL_SLOTS 24
+// Everything in a .cfpl before its colour data, all the palette list needs from the file
+#define IMPL_FILE_COLOR_DATA_OFFSET offsetof(IMPL_t, palData.file0)
 const char* implTemplates[]
 {
 	/*00 Ragna*/		{ "\x49\x4D\x50\x4C\x43\x46\x00\x00\x14\x00\x00\x00\x80\x20\x00\x00\x00\x00\x00\x00\x64\x65\x66\x61\x75\x6C\x74\x00\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\x00\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\x00\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\xFE\x00\x00\xFF\x00\xFF\xB9\xE4\xFF\xFF\x84\xA5\xCD\xFF\x28\x63\x9C\xFF\x1F\x44\x6B\xFF\xF5\xF2\xEE\xFF\xBD\x9C\x96\xFF\x6D\x48\x3E\xFF\x00\x00\xC3\xFF\x00\x0D\x67\xFF\x00\x08\x41\xFF\x00\x00\x17\xFF\xEC\xEA\xE8\xFF\x90\x8E\x8C\xFF\x33\x31\x30\xFF\x48\xC3\xE7\xFF\x00\x79\xB9\xFF\x04\x35\x59\xFF\x1C\x1E\x23\xFF\x0E\x10\x14\xFF\x07\x08\x0A\xFF\x04\x05\x07\xFF\x28\x28\x2E\xFF\x0D\x11\x1A\xFF\x00\x00\x0A\xFF\x32\x37\x41\xFF\x0A\x14\x1E\xFF\x05\x0A\x0F\xFF\xB9\xB1\xA8\xFF\x88\x73\x56\xFF\x46\x17\x2B\xFF\x1E\x00\x0A\xFF\xF0\xF0\xF0\xFF\x9A\x91\x91\xFF\x24\x24\xB9\xFF\x0D\x0A\x71\xFF\x05\x02\x2E\xFF\x42\x92\x1A\xFF\x2E\x65\x00\xFF\x0D\x38\x00\xFF\x38\x45\xD2\xFF\x38\x76\xFF\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\x32\x38\x3C\xFF\x14\x14\x1A\xFF\x07\x08\x09\xFF\xFF\x00\x00\xFF\xFF\xFF\xFB\xFF\x7B\x65\x44\xFF\x25\x21\x17\xFF\xFF\x00\x00\xFF\x6D\xFF\xFF\xFF\x31\x88\xFF\xFF\x00\x3C\xBD\xFF\xFF\x00\x00\xFF\x3C\x32\xC7\xFF\x0D\x00\x49\xFF\x01\x00\x17\xFF\x80\x00\x00\xFF\xFF\xFF\xFF\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x83\xFF\x00\x03\x86\xFF\x00\x06\x89\xFF\x00\x0A\x8C\xFF\x00\x0D\x8F\xFF\x00\x11\x92\xFF\x00\x14\x95\xFF\x00\x17\x99\xFF\x00\x1B\x9C\xFF\x00\x1E\x9F\xFF\x00\x22\xA2\xFF\x00\x25\xA5\xFF\x00\x29\xA8\xFF\x00\x2C\xAC\xFF\x00\x2F\xAF\xFF\x00\x33\xB2\xFF\x00\x36\xB5\xFF\x00\x3A\xB8\xFF\x00\x3D\xBB\xFF\x00\x40\xBF\xFF\x00\x44\xC2\xFF\x00\x47\xC5\xFF\x00\x4B\xC8\xFF\x00\x4E\xCB\xFF\x00\x52\xCE\xFF\x00\x55\xD2\xFF\x00\x58\xD5\xFF\x00\x5C\xD8\xFF\x00\x5F\xDB\xFF\x00\x63\xDE\xFF\x00\x66\xE1\xFF\x00\x6A\xE5\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\xF5\xFA\xFF\xFF\x00\xCC\xFE\xFF\x00\x60\xFD\xFF\xEE\xB0\xD1\xFF\x07\x07\x07\xFF\x18\x18\x18\xFF\x29\x29\x29\xFF\x3A\x3A\x3A\xFF\x4B\x4B\x4B\xFF\x5C\x5C\x5C\xFF\x6D\x6D\x6D\xFF\x7E\x7E\x7E\xFF\x8E\x8E\x8E\xFF\x9E\x9E\x9E\xFF\xAE\xAE\xAE\xFF\xBF\xBF\xBF\xFF\xCF\xCF\xCF\xFF\xDF\xDF\xDF\xFF\xF0\xF0\xF0\xFF\xA6\x77\x9C\xFF\x0A\x0A\x0A\xFF\x00\x00\x28\xFF\x00\x00\x3C\xFF\x00\x00\x4B\xFF\x00\x00\x5A\xFF\x00\x00\x6E\xFF\x00\x00\x7D\xFF\x00\x00\x91\xFF\x00\x00\xA0\xFF\x00\x00\xB4\xFF\x00\x00\xC8\xFF\x00\x00\xDA\xFF\x00\x00\xFF\xFF\x1A\x46\xFF\xFF\x42\x67\xFF\xFF\xC0\x00\xC0\xFF\x0A\x00\x08\xFF\x20\x05\x12\xFF\x37\x0A\x1D\xFF\x4E\x0F\x28\xFF\x64\x14\x33\xFF\x7B\x19\x3E\xFF\x8B\x2B\x50\xFF\x9C\x3D\x63\xFF\xAD\x4F\x76\xFF\xBA\x68\x8D\xFF\xC8\x81\xA4\xFF\xD6\x9A\xBA\xFF\xE3\xB3\xD1\xFF\xF1\xCC\xE8\xFF\xFF\xE5\xFF\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\xFF\x00\xFF\x0A\x0A\x0A\xFF\x09\x09\x0C\xFF\x08\x08\x0E\xFF\x08\x08\x10\xFF\x07\x07\x12\xFF\x06\x06\x14\xFF\x06\x06\x16\xFF\x05\x05\x18\xFF\x04\x04\x1A\xFF\x04\x04\x1C\xFF\x03\x03\x1E\xFF\x02\x02\x20\xFF\x02\x02\x22\xFF\x01\x01\x24\xFF\x00\x00\x26\xFF\x00\x00\x28\xFF\x00\x00\x2A\xFF\x00\x00\x2D\xFF\x00\x00\x2F\xFF\x00\x00\x32\xFF\x00\x00\x34\xFF\x00\x00\x37\xFF\x00\x00\x39\xFF\x00\x00\x3C\xFF\x00\x00\x3D\xFF\x00\x00\x3F\xFF\x00\x00\x41\xFF\x00\x00\x43\xFF\x00\x00\x45\xFF\x00\x00\x47\xFF\x00\x00\x49\xFF\x00\x00\x4B\xFF\x00\x00\x4C\xFF\x00\x00\x4E\xFF\x00\x00\x50\xFF\x00\x00\x52\xFF\x00\x00\x54\xFF\x00\x00\x56\xFF\x00\x00\x58\xFF\x00\x00\x5A\xFF\x00\x00\x5C\xFF\x00\x00\x5F\xFF\x00\x00\x61\xFF\x00\x00\x64\xFF\x00\x00\x66\xFF\x00\x00\x69\xFF\x00\x00\x6B\xFF\x00\x00\x6E\xFF\x00\x00\x6F\xFF\x00\x00\x71\xFF\x00\x00\x73\xFF\x00\x00\x75\xFF\x00\x00\x77\xFF\x00\x00\x79\xFF\x00\x00\x7B\xFF\x00\x00\x7D\xFF\x00\x00\x7F\xFF\x00\x00\x82\xFF\x00\x00\x84\xFF\x00\x00\x87\xFF\x00\x00\x89\xFF\x00\x00\x8C\xFF\x00\x00\x8E\xFF\x00\x00\x91\xFF\x00\x00\x92\xFF\x00\x00\x94\xFF\x00\x00\x96\xFF\x00\x00\x98\xFF\x00\x00\x9A\xFF\x00\x00\x9C\xFF\x00\x00\x9E\xFF\x00\x00\xA0\xFF\x00\x00\xA2\xFF\x00\x00\xA5\xFF\x00\x00\xA7\xFF\x00\x00\xAA\xFF\x00\x00\xAC\xFF\x00\x00\xAF\xFF\x00\x00\xB1\xFF\x00\x00\xB4\xFF\x00\x00\xB6\xFF\x00\x00\xB9\xFF\x00\x00\xBB\xFF\x00\x00\xBE\xFF\x00\x00\xC0\xFF\x00\x00\xC3\xFF\x00\x00\xC5\xFF\x00\x00\xC8\xFF\x03\x02\xCA\xFF\x07\x05\xCC\xFF\x0B\x07\xCE\xFF\x0F\x0A\xD1\xFF\x12\x0D\xD3\xFF\x16\x0F\xD5\xFF\x1A\x12\xD7\xFF\x1E\x15\xDA\xFF\x21\x17\xDC\xFF\x25\x1A\xDE\xFF\x29\x1C\xE0\xFF\x2D\x1F\xE3\xFF\x31\x22\xE5\xFF\x35\x24\xE7\xFF\x39\x27\xE9\xFF\x3D\x2A\xEC\xFF\x40\x2C\xEE\xFF\x44\x2F\xF0\xFF\x48\x32\xF3\xFF\x4C\x35\xF5\xFF\x50\x37\xF7\xFF\x54\x3A\xFA\xFF\x58\x3D\xFC\xFF\x5C\x40\xFF\xFF\x66\x4C\xFE\xFF\x71\x59\xFE\xFF\x7C\x66\xFE\xFF\x87\x72\xFE\xFF\x92\x7F\xFE\xFF\x9D\x8C\xFD\xFF\xA8\x99\xFD\xFF\xB2\xA5\xFD\xFF\xBD\xB2\xFD\xFF\xC8\xBF\xFD\xFF\xD3\xCC\xFC\xFF\xDE\xD8\xFC\xFF\xE9\xE5\xFC\xFF\xF4\xF2\xFC\xFF\xFF\xFF\xFC\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\xFF\x00\x00\xFF\x20\xC3\x0F\xFF\xF1\xF1\xF1\xFF\xA6\xB7\xCF\xFF\x7C\x91\xA2\xFF\x3F\x5B\x81\xFF\xF1\xF1\xF1\xFF\xD8\xC7\xC2\xFF\xA5\x7F\x6A\xFF\x73\x56\x3C\xFF\xF1\xF1\xF1\xFF\xE2\xB3\xAA\xFF\xB7\x5E\x4D\xFF\x79\x42\x3C\xFF\xF1\xE9\xC2\xFF\xF1\xAA\x8F\xFF\xAA\x68\x5B\xFF\x38\x21\x25\xFF\xF1\x46\x40\xFF\x90\x2F\x2B\xFF\x2C\x19\x16\xFF\xF1\x93\x39\xFF\xBD\x57\x26\xFF\x64\x1B\x13\xFF\xEF\x9F\xA3\xFF\xBC\x71\x6C\xFF\xA4\x42\x47\xFF\xF1\xE2\xC8\xFF\xB1\x95\x7B\xFF\x71\x5B\x43\xFF\x43\x31\x23\xFF\x41\x40\x35\xFF\x2F\x18\x19\xFF\x23\x1D\xE5\xFF\x24\x1D\x7C\xFF\x1E\x16\x28\xFF\x20\xF1\x8C\xFF\x28\x1E\x15\xFF\xF1\xF1\xF1\xFF\xB5\xA5\x9B\xFF\x90\x7F\xF1\xFF\x1A\x0D\xF1\xFF\x2A\x1A\xB3\xFF\x5B\x8C\xF1\xFF\x5B\x5B\xDB\xFF\x9B\x18\xF1\xFF\x91\x16\xE8\xFF\x89\x16\xC5\xFF\x7E\x16\xA4\xFF\xF1\xF1\xF1\xFF\xE6\xBE\xA8\xFF\xB3\x75\x52\xFF\x75\x4F\x39\xFF\xEB\xC4\x92\xFF\x9C\x7B\x52\xFF\x7F\x4F\x35\xFF\x46\x28\x1B\xFF\xEE\x7D\x32\xFF\x9F\x5F\x2E\xFF\x56\x40\x1B\xFF\x45\x20\x13\xFF\x20\xDA\x0F\xFF\x20\xB6\x0F\xFF\x1E\x90\x0D\xFF\x1D\x68\x0D\xFF\x1F\x77\x2B\xFF\x1F\xDB\x8A\xFF\xC9\xF1\xDE\xFF\x1F\xDB\x8A\xFF\x1F\x77\x2B\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x1D\x15\x0D\xFF\x00\xFF\x00\xFF\x04\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\xFF\x00\xFF\x04\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\xFF\x00\xFF\x04\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\xFF\x00\xFF\x04\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x03\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x02\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x01\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\xFF\x00\xFF\xE4\xD0\xCB\xFF\xAD\x95\x92\xFF\x76\x5B\x59\xFF\x3F\x21\x21\xFF\xFF\xFF\xFF\xFF\xC0\xBC\xB0\xFF\x8C\x5D\x53\xFF\x56\x3E\x2B\xFF\x4E\x3F\x35\xFF\x3E\x30\x27\xFF\x2E\x20\x1A\xFF\x1A\x14\x14\xFF\x97\x83\xFF\xFF\x05\x00\xBC\xFF\x11\x0F\x3F\xFF\xC8\xEF\xFF\xFF\x50\x98\xFF\xFF\x36\x57\x7F\xFF\x14\x2F\x52\xFF\x2B\x27\x27\xFF\x19\x18\x17\xFF\x06\x08\x06\xFF\x63\x00\xFF\xFF\x59\x00\xF0\xFF\x4E\x00\xE0\xFF\x43\x00\xD0\xFF\x38\x00\xC0\xFF\x2E\x00\xB1\xFF\x23\x00\xA1\xFF\x18\x00\x91\xFF\x0D\x00\x81\xFF\x59\x59\x59\xFF\x41\x41\x41\xFF\x28\x28\x28\xFF\x0B\x0B\x0E\xFF\x29\x2F\xCA\xFF\x24\x18\x74\xFF\x1F\x00\x3C\xFF\x00\x07\x1A\xFF\xAF\xEC\xFC\xFF\x2E\xAC\xF1\xFF\x26\x44\x6A\xFF\x11\x28\x39\xFF\xB8\x74\x57\xFF\x68\x42\x31\xFF\x48\x33\x29\xFF\xF2\xF1\xF0\xFF\xDD\xD7\xD5\xFF\x72\x57\x4E\xFF\x56\x3C\x35\xFF\x19\x17\x0B\xFF\x81\x00\xB0\xFF\x8C\x0F\xA0\xFF\x97\x1E\x90\xFF\xA3\x2D\x80\xFF\xAE\x3C\x70\xFF\xBA\x4B\x60\xFF\xC5\x5B\x50\xFF\xD1\x6A\x40\xFF\xDC\x79\x30\xFF\xE8\x88\x20\xFF\xF3\x97\x10\xFF\xFF\xA7\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\xDD\xD7\xD5\xFF\x56\x3C\x35\xFF\x00\x00\x00\xFF\xFF\xFF\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF\x00\x00\x00\xFF" },
@@ -63,6 +67,7 @@ PaletteManager::PaletteManager()
 
 PaletteManager::~PaletteManager()
 {
+	CancelPaletteLoad();
 }
 
 void PaletteManager::CreatePaletteFolders()
@@ -85,6 +90,8 @@ void PaletteManager::InitCustomPaletteVector()
 
 	m_customPalettes.clear();
 	m_customPalettes.resize(getCharactersCount());
+	m_palDataSources.clear();
+	m_palDataSources.resize(getCharactersCount());
 
 	for (int i = 0; i < getCharactersCount(); i++)
 	{
@@ -94,24 +101,218 @@ void PaletteManager::InitCustomPaletteVector()
 	}
 }
 
-void PaletteManager::LoadPalettesFromFolder()
+static bool NeedsHeader(const std::string& fileName)
 {
-	InitCustomPaletteVector();
+	// .hpl files are only looked at by name until their palette gets used
+	return fileName.find(IMPL_FILE_EXTENSION) != std::string::npos;
+}
 
+void PaletteManager::LoadPalettesFromFolder()
+{
+	// Runs on m_loadThread, nothing in here may touch m_customPalettes or the ImGui logger
 	LOG(2, "LoadPaletteFiles\n");
-	g_imGuiLogger->Log("[system] Loading local custom palettes...\n");
 
-	for (int i = 0; i < getCharactersCount(); i++)
+	const int charCount = getCharactersCount();
+	std::vector<PaletteFileJob> jobs;
+	std::vector<int> charJobStart(charCount + 1, 0);
+
+	for (int i = 0; i < charCount; i++)
 	{
+		if (m_cancelLoad)
+			return;
+
+		charJobStart[i] = jobs.size();
 		std::wstring wPath = std::wstring(L"BBCF_IM\\Palettes\\") + getCharacterNameByIndexW(i) + L"\\*";
-		LoadPalettesIntoVector((CharIndex)i, wPath);
+		CollectPaletteFiles((CharIndex)i, wPath, jobs);
+	}
+	charJobStart[charCount] = jobs.size();
+
+	PaletteIndex oldIndex;
+	oldIndex.Load(PALETTE_INDEX_PATH);
+
+	// Unchanged files come out of the index, the rest get read by the pool
+	std::vector<int> toRead;
+	std::vector<int> charReadsLeft(charCount, 0);
+	int cachedCount = 0;
+
+	for (int i = 0; i < (int)jobs.size(); i++)
+	{
+		if (!NeedsHeader(jobs[i].fileName))
+			continue;
+
+		jobs[i].cached = oldIndex.Find(jobs[i].fullPath, jobs[i].mtime, jobs[i].size);
+		if (jobs[i].cached)
+		{
+			cachedCount++;
+			continue;
+		}
+
+		toRead.push_back(i);
+		charReadsLeft[jobs[i].charIndex]++;
+	}
+
+	std::mutex doneMutex;
+	std::condition_variable doneCondition;
+	std::atomic<size_t> cursor(0);
+	auto work = [&]()
+	{
+		for (;;)
+		{
+			size_t i = cursor.fetch_add(1);
+			if (i >= toRead.size() || m_cancelLoad)
+				break;
+
+			PaletteFileJob& job = jobs[toRead[i]];
+			ReadPaletteFile(job);
+			{
+				std::lock_guard<std::mutex> lock(doneMutex);
+				charReadsLeft[job.charIndex]--;
+			}
+			doneCondition.notify_all();
+		}
+
+		// Taking the lock makes sure the assembly loop is waiting before it gets woken up on a cancel
+		{
+			std::lock_guard<std::mutex> lock(doneMutex);
+		}
+		doneCondition.notify_all();
+	};
+
+	int threadCount = (int)std::thread::hardware_concurrency();
+	threadCount = max(1, min(threadCount, PALETTE_LOADER_MAX_THREADS));
+	threadCount = min(threadCount, (int)toRead.size());
+
+	std::vector<std::thread> pool;
+	for (int t = 0; t < threadCount; t++)
+	{
+		pool.push_back(std::thread(work));
+	}
+
+	// Characters are read in order, each one gets assembled and handed over as soon as its files are in
+	for (int c = 0; c < charCount; c++)
+	{
+		{
+			std::unique_lock<std::mutex> lock(doneMutex);
+			doneCondition.wait(lock, [&]() { return charReadsLeft[c] == 0 || m_cancelLoad; });
+		}
+
+		if (m_cancelLoad)
+			break;
+
+		std::unique_ptr<LoadedCharPalettes> loaded(new LoadedCharPalettes());
+		AssembleCharPalettes((CharIndex)c, jobs.data() + charJobStart[c], charJobStart[c + 1] - charJobStart[c], *loaded);
+
+		std::lock_guard<std::mutex> lock(m_loadMutex);
+		m_loadedChars[c] = std::move(loaded);
+	}
+
+	for (auto& thread : pool)
+	{
+		thread.join();
+	}
+
+	if (m_cancelLoad)
+		return;
+
+	// Rebuilt from what is on disk now, so deleted files drop out of it
+	PaletteIndex newIndex;
+	bool indexChanged = false;
+	for (const PaletteFileJob& job : jobs)
+	{
+		if (job.cached)
+		{
+			newIndex.Add(*job.cached);
+		}
+		else if (NeedsHeader(job.fileName) && !job.readFailed)
+		{
+			newIndex.Add(job.entry);
+			indexChanged = true;
+		}
+	}
+
+	if (indexChanged || newIndex.GetEntryCount() != oldIndex.GetEntryCount())
+	{
+		if (!newIndex.Save(PALETTE_INDEX_PATH))
+			LOG(2, "ERROR, couldn't write %s\n", PALETTE_INDEX_PATH);
+	}
+
+	m_loadFilesFound = jobs.size();
+	m_loadFilesCached = cachedCount;
+	m_loadFinished = true;
+}
+
+void PaletteManager::CancelPaletteLoad()
+{
+	if (!m_loadThread.joinable())
+		return;
+
+	m_cancelLoad = true;
+	m_loadThread.join();
+	m_cancelLoad = false;
+
+	std::lock_guard<std::mutex> lock(m_loadMutex);
+	m_loadedChars.clear();
+}
+
+void PaletteManager::PublishLoadedPalettes()
+{
+	if (!m_loadThread.joinable())
+		return;
+
+	// Checked before swapping, the thread hands over its last character before it says it's done
+	bool finished = m_loadFinished;
+	if (finished)
+		m_loadThread.join();
+
+	SwapInLoadedPalettes(finished);
+}
+
+void PaletteManager::WaitForPaletteLoad()
+{
+	if (!m_loadThread.joinable())
+		return;
+
+	m_loadThread.join();
+	SwapInLoadedPalettes(true);
+}
+
+void PaletteManager::SwapInLoadedPalettes(bool finished)
+{
+	std::lock_guard<std::mutex> lock(m_loadMutex);
+
+	for (int i = 0; i < (int)m_loadedChars.size(); i++)
+	{
+		if (!m_loadedChars[i])
+			continue;
+
+		// Readers are all on this thread, so a swap is all it takes for a character to change over at once
+		m_customPalettes[i].swap(m_loadedChars[i]->palettes);
+		m_palDataSources[i].swap(m_loadedChars[i]->sources);
+		m_onlinePalsStartIndex[i] = m_customPalettes[i].size();
+
+		for (const std::string& message : m_loadedChars[i]->messages)
+		{
+			g_imGuiLogger->Log("%s", message.c_str());
+		}
+
+		m_loadedChars[i].reset();
 	}
 
-	InitOnlinePalsIndexVector();
+	if (!finished)
+		return;
 
+	m_loadedChars.clear();
+
+	long long ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_loadStart).count();
+	LOG(2, "Loaded %d palette files in %lldms, %d from the index\n", m_loadFilesFound.load(), ms, m_loadFilesCached.load());
 	g_imGuiLogger->Log("[system] Finished loading local custom palettes\n");
 }
 
+bool PaletteManager::IsLoadingPalettes() const
+{
+	return m_loadThread.joinable();
+}
+
 void PaletteManager::InitOnlinePalsIndexVector()
 {
 	m_onlinePalsStartIndex.clear();
@@ -201,10 +402,10 @@ void PaletteManager::ApplyDefaultCustomPalette(CharIndex charIndex, CharPaletteH
 	SwitchPalette(charIndex, charPalHandle, foundCustomPalIndex);
 }
 
-void PaletteManager::LoadPalettesIntoVector(CharIndex charIndex, std::wstring& wFolderPath)
+void PaletteManager::CollectPaletteFiles(CharIndex charIndex, std::wstring& wFolderPath, std::vector<PaletteFileJob>& jobs)
 {
 	std::string folderPath(wFolderPath.begin(), wFolderPath.end());
-	LOG(2, "LoadPalettesIntoContainer %s\n", folderPath.c_str());
+	LOG(2, "CollectPaletteFiles %s\n", folderPath.c_str());
 
 	HANDLE hFind;
 	WIN32_FIND_DATA data;
@@ -226,67 +427,128 @@ void PaletteManager::LoadPalettesIntoVector(CharIndex charIndex, std::wstring& w
 			wSubfolderPath.pop_back(); // Delete "*" at the end
 			wSubfolderPath += data.cFileName;
 			wSubfolderPath += L"\\*";
-			LoadPalettesIntoVector(charIndex, wSubfolderPath);
+			CollectPaletteFiles(charIndex, wSubfolderPath, jobs);
 			continue;
 		}
 
 		std::wstring wFileName(data.cFileName);
-		std::string fileName(wFileName.begin(), wFileName.end());
-		std::string fullPath(folderPath);
-		fullPath.pop_back(); // Delete "*" at the end
-		fullPath += fileName;
+		PaletteFileJob job;
+		job.charIndex = charIndex;
+		job.fileName = std::string(wFileName.begin(), wFileName.end());
+		job.fullPath = folderPath;
+		job.fullPath.pop_back(); // Delete "*" at the end
+		job.fullPath += job.fileName;
+		// The find data already has what the index is checked against, no need to open the file for it
+		job.mtime = (uint64_t)data.ftLastWriteTime.dwHighDateTime << 32 | data.ftLastWriteTime.dwLowDateTime;
+		job.size = (uint64_t)data.nFileSizeHigh << 32 | data.nFileSizeLow;
+		job.cached = NULL;
+		job.readFailed = false;
+		job.readErrno = 0;
+
+		jobs.push_back(job);
+
+	} while (FindNextFile(hFind, &data));
+	FindClose(hFind);
+}
+
+void PaletteManager::ReadPaletteFile(PaletteFileJob& job)
+{
+	// The colour data is read by LoadPalData once the palette gets used
+	size_t readSize = job.size < IMPL_FILE_COLOR_DATA_OFFSET ? (size_t)job.size : IMPL_FILE_COLOR_DATA_OFFSET;
+
+	std::ifstream file(job.fullPath, std::ios::binary);
+	if (!file.is_open())
+	{
+		job.readFailed = true;
+		job.readErrno = errno;
+		return;
+	}
+
+	PaletteIndexEntry& entry = job.entry;
+	entry.header.resize(readSize);
+	file.read(&entry.header[0], readSize);
+	entry.header.resize((size_t)file.gcount());
+
+	entry.path = job.fullPath;
+	entry.mtime = job.mtime;
+	entry.size = job.size;
+	entry.headerHash = fnv1a64(entry.header.data(), entry.header.size());
+}
 
-		LOG(2, "\tFILE: %s", fileName.c_str());
-		LOG(2, "\t\tFull path: %s\n", fullPath.c_str());
+void PaletteManager::AssembleCharPalettes(CharIndex charIndex, const PaletteFileJob* jobs, int jobCount, LoadedCharPalettes& loaded)
+{
+	// Make the character palette array's 0th element an empty one, that will be used to set back to the default palette
+	IMPL_data_t customPal { "Default" };
+	loaded.palettes.push_back(customPal);
+	loaded.sources.emplace_back();
 
-		if (fileName.find(IMPL_FILE_EXTENSION) != std::string::npos)
+	// Same order as the folders were walked in, effect and bloom files need their palette to come first
+	for (int i = 0; i < jobCount; i++)
+	{
+		const PaletteFileJob& job = jobs[i];
+
+		LOG(2, "\tFILE: %s", job.fileName.c_str());
+		LOG(2, "\t\tFull path: %s\n", job.fullPath.c_str());
+
+		if (job.fileName.find(IMPL_FILE_EXTENSION) != std::string::npos)
 		{
-			LoadImplFile(fullPath, fileName, charIndex);
+			LoadImplFile(job, loaded);
 		}
-		else if (fileName.find(LEGACY_HPL_FILE_EXTENSION) != std::string::npos)
+		else if (job.fileName.find(LEGACY_HPL_FILE_EXTENSION) != std::string::npos)
 		{
-			LoadHplFile(fullPath, fileName, charIndex);
+			LoadHplFile(job, loaded);
 		}
 		else
 		{
-			LOG(2, "Unrecognized file format for '%s'\n", fileName.c_str());
-			g_imGuiLogger->Log("[error] Unable to open '%s' : not an %s file\n", fileName.c_str(), IMPL_FILE_EXTENSION);
+			LOG(2, "Unrecognized file format for '%s'\n", job.fileName.c_str());
+			loaded.messages.push_back(FormatText("[error] Unable to open '%s' : not an %s file\n", job.fileName.c_str(), IMPL_FILE_EXTENSION));
 		}
-
-	} while (FindNextFile(hFind, &data));
-	FindClose(hFind);
+	}
 }
 
-void PaletteManager::LoadImplFile(const std::string& fullPath, const std::string& fileName, CharIndex charIndex)
+void PaletteManager::LoadImplFile(const PaletteFileJob& job, LoadedCharPalettes& loaded)
 {
-	IMPL_t fileContents;
+	const std::string& fileName = job.fileName;
+	const CharIndex charIndex = job.charIndex;
 
-	if (!utils_ReadFile(fullPath.c_str(), &fileContents, sizeof(fileContents), true))
+	if (job.readFailed)
 	{
-		LOG(2, "\tCouldn't open %s!\n", strerror(errno));
-		g_imGuiLogger->Log("[error] Unable to open '%s' : %s\n", fileName.c_str(), strerror(errno));
+		LOG(2, "\tCouldn't open %s!\n", strerror(job.readErrno));
+		loaded.messages.push_back(FormatText("[error] Unable to open '%s' : %s\n", fileName.c_str(), strerror(job.readErrno)));
 		return;
 	}
 
+	const std::string& header = job.cached ? job.cached->header : job.entry.header;
+
 	// Check for errors
+	if (header.size() < IMPL_FILE_COLOR_DATA_OFFSET)
+	{
+		LOG(2, "ERROR, file is truncated!\n");
+		loaded.messages.push_back(FormatText("[error] '%s' is truncated!\n", fileName.c_str()));
+		return;
+	}
+
+	IMPL_t fileContents {};
+	memcpy(&fileContents, header.data(), IMPL_FILE_COLOR_DATA_OFFSET);
+
 	if (strncmp(fileContents.header.fileSig, IMPL_FILESIG, sizeof(fileContents.header.fileSig)) != 0)
 	{
 		LOG(2, "ERROR, unrecognized file format!\n");
-		g_imGuiLogger->Log("[error] '%s' unrecognized file format!\n", fileName.c_str());
+		loaded.messages.push_back(FormatText("[error] '%s' unrecognized file format!\n", fileName.c_str()));
 		return;
 	}
 
 	if (fileContents.header.dataLen != sizeof(IMPL_data_t))
 	{
 		LOG(2, "ERROR, data size mismatch!\n");
-		g_imGuiLogger->Log("[error] '%s' data size mismatch!\n", fileName.c_str());
+		loaded.messages.push_back(FormatText("[error] '%s' data size mismatch!\n", fileName.c_str()));
 		return;
 	}
 
 	if (isCharacterIndexOutOfBound(fileContents.header.charIndex))
 	{
 		LOG(2, "ERROR, '%s' has invalid character index in the header\n", fileName.c_str());
-		g_imGuiLogger->Log("[error] '%s' has invalid character index in the header\n", fileName.c_str());
+		loaded.messages.push_back(FormatText("[error] '%s' has invalid character index in the header\n", fileName.c_str()));
 	}
 	else if (charIndex != fileContents.header.charIndex)
 	{
@@ -294,65 +556,62 @@ void PaletteManager::LoadImplFile(const std::string& fullPath, const std::string
 			fileName.c_str(), getCharacterNameByIndexA(fileContents.header.charIndex).c_str(),
 			getCharacterNameByIndexA(charIndex).c_str());
 
-		g_imGuiLogger->Log("[error] '%s' belongs to character '%s', but is placed in folder '%s'\n",
+		loaded.messages.push_back(FormatText("[error] '%s' belongs to character '%s', but is placed in folder '%s'\n",
 			fileName.c_str(), getCharacterNameByIndexA(fileContents.header.charIndex).c_str(),
-			getCharacterNameByIndexA(charIndex).c_str());
+			getCharacterNameByIndexA(charIndex).c_str()));
 	}
 	else
 	{
+		PaletteFileSource source { job.fullPath, IMPL_FILE_COLOR_DATA_OFFSET,
+			IMPL_PALETTE_FILES_COUNT * IMPL_PALETTE_DATALEN, offsetof(IMPL_data_t, file0) };
+
 		OverwriteIMPLDataPalName(fileName, fileContents.palData);
-		PushImplFileIntoVector(charIndex, fileContents.palData);
+		PushPaletteIntoVector(charIndex, fileContents.palData, source, loaded);
 	}
 }
 
-void PaletteManager::LoadHplFile(const std::string& fullPath, const std::string& fileName, CharIndex charIndex)
+void PaletteManager::LoadHplFile(const PaletteFileJob& job, LoadedCharPalettes& loaded)
 {
+	const std::string& fileName = job.fileName;
+	const CharIndex charIndex = job.charIndex;
+
 	if (fileName.find("_effectbloom") != std::string::npos)
 	{
 		std::string palName = fileName.substr(0, fileName.rfind("_effectbloom"));
 
-		int palIndex = FindCustomPalIndex(charIndex, palName.c_str());
+		int palIndex = FindPalIndexInVector(loaded.palettes, palName.c_str());
 
 		if (palIndex < 0)
 		{
 			LOG(2, "ERROR, '%s' has no custom character palette to match with!\n", fileName.c_str());
-			g_imGuiLogger->Log("[error] '%s' has no custom character palette to match with! Create a character palette named '%s' to load this bloom file on!\n",
-				fileName.c_str(), (palName + ".hpl").c_str());
+			loaded.messages.push_back(FormatText("[error] '%s' has no custom character palette to match with! Create a character palette named '%s' to load this bloom file on!\n",
+				fileName.c_str(), (palName + ".hpl").c_str()));
 			return;
 		}
 
-		m_customPalettes[charIndex][palIndex].palInfo.hasBloom = true;
+		loaded.palettes[palIndex].palInfo.hasBloom = true;
 
-		g_imGuiLogger->Log(
+		loaded.messages.push_back(FormatText(
 			"[system] %s: Loaded '%s'\n",
 			getCharacterNameByIndexA(charIndex).c_str(),
 			fileName.c_str()
-		);
+		));
 
 		return;
 	}
 
-	char fileContents[LEGACY_HPL_HEADER_LEN + LEGACY_HPL_DATALEN];
-
-	if (!utils_ReadFile(fullPath.c_str(), &fileContents, sizeof(fileContents), true))
-	{
-		LOG(2, "\tCouldn't open %s!\n", strerror(errno));
-		g_imGuiLogger->Log("[error] Unable to open '%s' : %s\n", fileName.c_str(), strerror(errno));
-		return;
-	}
-
 	// Effect file:
 	if (fileName.find("_effect0") != std::string::npos)
 	{
 		std::string palName = fileName.substr(0, fileName.rfind("_effect0"));
 
-		int palIndex = FindCustomPalIndex(charIndex, palName.c_str());
+		int palIndex = FindPalIndexInVector(loaded.palettes, palName.c_str());
 
 		if (palIndex < 0)
 		{
 			LOG(2, "ERROR, '%s' has no custom character palette to match with!\n", fileName.c_str());
-			g_imGuiLogger->Log("[error] '%s' has no custom character palette to match with! Create a character palette named '%s' to load this effect file on!\n",
-				fileName.c_str(), (palName + ".hpl").c_str());
+			loaded.messages.push_back(FormatText("[error] '%s' has no custom character palette to match with! Create a character palette named '%s' to load this effect file on!\n",
+				fileName.c_str(), (palName + ".hpl").c_str()));
 
 			return;
 		}
@@ -365,20 +624,20 @@ void PaletteManager::LoadHplFile(const std::string& fullPath, const std::string&
 		if (fileIndex <= 0 || fileIndex > 7)
 		{
 			LOG(2, "ERROR, '%s'has wrong index of effect file!\n", fileName.c_str());
-			g_imGuiLogger->Log("[error] '%s' has wrong index!\n", fileName.c_str());
+			loaded.messages.push_back(FormatText("[error] '%s' has wrong index!\n", fileName.c_str()));
 			return;
 		}
 
-		IMPL_data_t& implData = m_customPalettes[charIndex][palIndex];
-		char* pImplEffectFile = (char*)&implData.file0 + fileIndex * IMPL_PALETTE_DATALEN;
-
-		memcpy_s(pImplEffectFile, IMPL_PALETTE_DATALEN, (char*)&fileContents + LEGACY_HPL_HEADER_LEN, LEGACY_HPL_DATALEN);
+		// After the palette's own source, so it lands on top of what that one fills in
+		PaletteFileSource source { job.fullPath, LEGACY_HPL_HEADER_LEN, LEGACY_HPL_DATALEN,
+			(uint32_t)(offsetof(IMPL_data_t, file0) + fileIndex * IMPL_PALETTE_DATALEN) };
+		loaded.sources[palIndex].push_back(source);
 
-		g_imGuiLogger->Log(
+		loaded.messages.push_back(FormatText(
 			"[system] %s: Loaded '%s'\n",
 			getCharacterNameByIndexA(charIndex).c_str(),
 			fileName.c_str()
-		);
+		));
 	}
 	else // Palette file
 	{
@@ -387,11 +646,11 @@ void PaletteManager::LoadHplFile(const std::string& fullPath, const std::string&
 		// Make a copy of template
 		memcpy_s(&implTemplate, sizeof(IMPL_t), implTemplates[charIndex], sizeof(IMPL_t));
 
-		// Copy .hpl data into cfpl template
-		memcpy_s(&implTemplate.palData.file0, IMPL_PALETTE_DATALEN, (char*)&fileContents + LEGACY_HPL_HEADER_LEN, LEGACY_HPL_DATALEN);
+		// The .hpl data goes over the template's file0
+		PaletteFileSource source { job.fullPath, LEGACY_HPL_HEADER_LEN, LEGACY_HPL_DATALEN, offsetof(IMPL_data_t, file0) };
 
 		OverwriteIMPLDataPalName(fileName, implTemplate.palData);
-		PushImplFileIntoVector(charIndex, implTemplate.palData);
+		PushPaletteIntoVector(charIndex, implTemplate.palData, source, loaded);
 	}
 }
 
@@ -498,6 +757,32 @@ bool PaletteManager::PushImplFileIntoVector(CharIndex charIndex, IMPL_data_t & f
 	return true;
 }
 
+bool PaletteManager::PushPaletteIntoVector(CharIndex charIndex, IMPL_data_t& filledPalData, const PaletteFileSource& source, LoadedCharPalettes& loaded)
+{
+	// Same as PushImplFileIntoVector, for the loader's vector of the character
+	if (FindPalIndexInVector(loaded.palettes, filledPalData.palInfo.palName) > 0)
+	{
+		loaded.messages.push_back(FormatText(
+			"[error] Custom palette couldn't be loaded: a palette with name '%s' is already loaded.\n",
+			filledPalData.palInfo.palName
+		));
+		LOG(2, "ERROR, A custom palette with name '%s' is already loaded.\n", filledPalData.palInfo.palName);
+		return false;
+	}
+
+	loaded.palettes.push_back(filledPalData);
+	loaded.sources.push_back(std::vector<PaletteFileSource>(1, source));
+
+	loaded.messages.push_back(FormatText(
+		"[system] %s: Loaded '%s%s'\n",
+		getCharacterNameByIndexA(charIndex).c_str(),
+		filledPalData.palInfo.palName,
+		IMPL_FILE_EXTENSION
+	));
+
+	return true;
+}
+
 bool PaletteManager::WritePaletteToFile(CharIndex charIndex, IMPL_data_t *filledPalData)
 {
 	LOG(2, "WritePaletteToFile\n");
@@ -525,7 +810,26 @@ void PaletteManager::LoadAllPalettes()
 {
 	LOG(2, "LoadAllPalettes\n");
 
-	LoadPalettesFromFolder();
+	CancelPaletteLoad();
+
+	// Palettes loaded before stay up until their character gets swapped out
+	if (m_customPalettes.size() != getCharactersCount())
+	{
+		InitCustomPaletteVector();
+		InitOnlinePalsIndexVector();
+	}
+
+	g_imGuiLogger->Log("[system] Loading local custom palettes...\n");
+
+	{
+		std::lock_guard<std::mutex> lock(m_loadMutex);
+		m_loadedChars.clear();
+		m_loadedChars.resize(getCharactersCount());
+	}
+	m_loadFinished = false;
+	m_loadStart = std::chrono::steady_clock::now();
+	m_loadThread = std::thread(&PaletteManager::LoadPalettesFromFolder, this);
+
 	LoadPaletteSettingsFile();
 
 	//if(m_loadOnlinePalettes)
@@ -568,6 +872,34 @@ void PaletteManager::OverwriteIMPLDataPalName(std::string fileName, IMPL_data_t
 // ret == -1, index not found
 // ret == -2, charindex out of bound
 // ret == -3, default palette or no name given
+void PaletteManager::LoadPalData(CharIndex charIndex, int palIndex)
+{
+	if (palIndex >= (int)m_palDataSources[charIndex].size() || m_palDataSources[charIndex][palIndex].empty())
+		return;
+
+	char* palData = (char*)&m_customPalettes[charIndex][palIndex];
+
+	for (const PaletteFileSource& source : m_palDataSources[charIndex][palIndex])
+	{
+		// Whatever the file is short of stays zeroed
+		char* pDst = palData + source.destOffset;
+		memset(pDst, 0, source.length);
+
+		std::ifstream file(source.path, std::ios::binary);
+		if (!file.is_open())
+		{
+			LOG(2, "\tCouldn't open %s!\n", strerror(errno));
+			g_imGuiLogger->Log("[error] Unable to open '%s' : %s\n", source.path.c_str(), strerror(errno));
+			continue;
+		}
+
+		file.seekg(source.fileOffset);
+		file.read(pDst, source.length);
+	}
+
+	m_palDataSources[charIndex][palIndex].clear();
+}
+
 int PaletteManager::FindCustomPalIndex(CharIndex charIndex, const char * palNameToFind)
 {
 	LOG(2, "FindCustomPalIndex\n");
@@ -575,13 +907,18 @@ int PaletteManager::FindCustomPalIndex(CharIndex charIndex, const char * palName
 	if (charIndex > getCharactersCount())
 		return -2;
 
+	return FindPalIndexInVector(m_customPalettes[charIndex], palNameToFind);
+}
+
+int PaletteManager::FindPalIndexInVector(const std::vector<IMPL_data_t>& palettes, const char * palNameToFind)
+{
 	if (strncmp(palNameToFind, "", IMPL_PALNAME_LENGTH) == 0 ||
 		strncmp(palNameToFind, "Default", IMPL_PALNAME_LENGTH) == 0)
 		return -3;
 
-	for (int i = 0; i < m_customPalettes[charIndex].size(); i++)
+	for (int i = 0; i < palettes.size(); i++)
 	{
-		if (strncmp(palNameToFind, m_customPalettes[charIndex][i].palInfo.palName, IMPL_PALNAME_LENGTH) == 0)
+		if (strncmp(palNameToFind, palettes[i].palInfo.palName, IMPL_PALNAME_LENGTH) == 0)
 		{
 			return i;
 		}
@@ -602,6 +939,7 @@ bool PaletteManager::SwitchPalette(CharIndex charIndex, CharPaletteHandle& palHa
 	if (newCustomPalIndex >= totalCharPals)
 		return false;
 
+	LoadPalData(charIndex, newCustomPalIndex);
 	palHandle.SetSelectedCustomPalIndex(newCustomPalIndex);
 	palHandle.ReplacePalData(&m_customPalettes[charIndex][newCustomPalIndex]);
 
@@ -639,6 +977,7 @@ const char * PaletteManager::GetCustomPalFile(CharIndex charIndex, int palIndex,
 	}
 	else
 	{
+		LoadPalData(charIndex, palIndex);
 		ptr = m_customPalettes[charIndex][palIndex].file0;
 		ptr += palFile * IMPL_PALETTE_DATALEN;
 	}
@@ -677,6 +1016,9 @@ void PaletteManager::OnMatchInit(Player& playerOne, Player& playerTwo)
 	playerOne.GetPalHandle().OnMatchInit();
 	playerTwo.GetPalHandle().OnMatchInit();
 
+	// The default palettes have to be loaded to be found
+	WaitForPaletteLoad();
+
 	ApplyDefaultCustomPalette((CharIndex)playerOne.GetData()->charIndex, playerOne.GetPalHandle());
 	ApplyDefaultCustomPalette((CharIndex)playerTwo.GetData()->charIndex, playerTwo.GetPalHandle());
 }
@@ -2,12 +2,20 @@
 #include "impl_format.h"
 
 #include "CharPaletteHandle.h"
+#include "PaletteIndex.h"
 
 #include "Game/characters.h"
 #include "Game/Player.h"
 
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
+#define PALETTE_LOADER_MAX_THREADS 8
+
 class PaletteManager
 {
 public:
@@ -19,8 +27,15 @@ public:
 	bool PushImplFileIntoVector(CharIndex charIndex, IMPL_data_t &filledPalData);
 	bool WritePaletteToFile(CharIndex charIndex, IMPL_data_t *filledPalData);
 
+	// Both return right away, the palettes are read on a background thread and
+	// show up per character as PublishLoadedPalettes picks them up
 	void LoadAllPalettes();
 	void ReloadAllPalettes();
+	// Call it ONCE per frame, swaps in the characters the loader has finished
+	void PublishLoadedPalettes();
+	// Blocks until the running load is done and everything it loaded is published
+	void WaitForPaletteLoad();
+	bool IsLoadingPalettes() const;
 
 	int GetOnlinePalsStartIndex(CharIndex charIndex);
 	void OverwriteIMPLDataPalName(std::string fileName, IMPL_data_t& palData);
@@ -53,18 +68,67 @@ public:
 	void OnMatchEnd(CharPaletteHandle& playerOne, CharPaletteHandle& playerTwo);
 
 private:
+	// Where a range of a palette's colour data comes from, read the first time the palette is used
+	struct PaletteFileSource
+	{
+		std::string path;
+		uint32_t fileOffset;
+		uint32_t length;
+		uint32_t destOffset; // into IMPL_data_t
+	};
+
+	// A file found in the palette folders, the loader's unit of work
+	struct PaletteFileJob
+	{
+		CharIndex charIndex;
+		std::string fullPath;
+		std::string fileName;
+		uint64_t mtime;
+		uint64_t size;
+		const PaletteIndexEntry* cached; // into the index loaded at the start, NULL if the file has to be read
+		PaletteIndexEntry entry; // the header that got read, if it was
+		bool readFailed;
+		int readErrno;
+	};
+
+	// One character's palettes, ready to be swapped in
+	struct LoadedCharPalettes
+	{
+		std::vector<IMPL_data_t> palettes;
+		std::vector<std::vector<PaletteFileSource>> sources; // one list per palette
+		std::vector<std::string> messages; // the logger isn't thread safe, these get logged on publish
+	};
+
 	std::vector<std::vector<IMPL_data_t>> m_customPalettes;
+	// Per palette of m_customPalettes, emptied once the colour data is read. Palettes pushed after the load have none
+	std::vector<std::vector<std::vector<PaletteFileSource>>> m_palDataSources;
 	std::vector<std::vector<std::string>> m_paletteSlots;
 	std::vector<int> m_onlinePalsStartIndex;
 	bool m_loadOnlinePalettes = false;
 	bool m_PaletteArchiveDownloaded = false;
 
+	std::thread m_loadThread;
+	std::atomic<bool> m_cancelLoad { false };
+	std::atomic<bool> m_loadFinished { false };
+	std::mutex m_loadMutex; // guards m_loadedChars
+	std::vector<std::unique_ptr<LoadedCharPalettes>> m_loadedChars;
+	std::chrono::steady_clock::time_point m_loadStart;
+	std::atomic<int> m_loadFilesFound { 0 };
+	std::atomic<int> m_loadFilesCached { 0 };
+
 	void CreatePaletteFolders();
 	void InitCustomPaletteVector();
-	void LoadPalettesIntoVector(CharIndex charIndex, std::wstring& wFolderPath);
+	void CollectPaletteFiles(CharIndex charIndex, std::wstring& wFolderPath, std::vector<PaletteFileJob>& jobs);
 	void LoadPalettesFromFolder();
-	void LoadImplFile(const std::string& fullPath, const std::string& fileName, CharIndex charIndex);
-	void LoadHplFile(const std::string& fullPath, const std::string& fileName, CharIndex charIndex);
+	void CancelPaletteLoad();
+	void SwapInLoadedPalettes(bool finished);
+	static void ReadPaletteFile(PaletteFileJob& job);
+	void AssembleCharPalettes(CharIndex charIndex, const PaletteFileJob* jobs, int jobCount, LoadedCharPalettes& loaded);
+	void LoadImplFile(const PaletteFileJob& job, LoadedCharPalettes& loaded);
+	void LoadHplFile(const PaletteFileJob& job, LoadedCharPalettes& loaded);
+	bool PushPaletteIntoVector(CharIndex charIndex, IMPL_data_t& filledPalData, const PaletteFileSource& source, LoadedCharPalettes& loaded);
+	void LoadPalData(CharIndex charIndex, int palIndex);
+	static int FindPalIndexInVector(const std::vector<IMPL_data_t>& palettes, const char* palNameToFind);
 	void InitPaletteSlotsVector();
 	void InitOnlinePalsIndexVector();
 	void ApplyDefaultCustomPalette(CharIndex charIndex, CharPaletteHandle& charPalHandle);
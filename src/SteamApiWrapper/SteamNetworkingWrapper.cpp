@@ -18,6 +18,11 @@ SteamNetworkingWrapper::SteamNetworkingWrapper(ISteamNetworking** pSteamNetworki
 	LOG(2, "\t- after: *pSteamNetworking: 0x%p, m_SteamNetworking: 0x%p\n", *pSteamNetworking, m_SteamNetworking);
 }
 
+SteamNetworkingWrapper::SteamNetworkingWrapper()
+	: m_SteamNetworking(NULL)
+{
+}
+
 SteamNetworkingWrapper::~SteamNetworkingWrapper()
 {
 }
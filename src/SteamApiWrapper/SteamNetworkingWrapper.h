@@ -34,4 +34,8 @@ public:
 	bool GetListenSocketInfo(SNetListenSocket_t hListenSocket, uint32 *pnIP, uint16 *pnPort);
 	ESNetSocketConnectionType GetSocketConnectionType(SNetSocket_t hSocket);
 	int GetMaxPacketSize(SNetSocket_t hSocket);
+
+protected:
+	// For stand-ins that don't hijack the game's interface, m_SteamNetworking stays NULL
+	SteamNetworkingWrapper();
 };
\ No newline at end of file
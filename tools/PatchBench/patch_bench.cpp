@@ -0,0 +1,339 @@
+/*
+	Offline checks and timings for the byte patch engine (src/Hooks/BytePatch.cpp). The patch groups are read from the
+	BytePatchGroup tables in src/Hooks/Patches.cpp, planted into an in-memory image and applied/reverted through a
+	protector that only counts its calls. See docs/patch_bench.md.
+
+	Build (Linux, from the repo root):
+	g++ -std=c++14 -O2 -Isrc tools/PatchBench/patch_bench.cpp src/Hooks/BytePatch.cpp -o patch_bench
+
+	Usage: patch_bench [Patches.cpp] [-i iterations]
+*/
+#include "Hooks/BytePatch.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct ParsedSite {
+	uint32_t rva;
+	std::string original;
+	std::string patched;
+	int length;
+};
+
+struct ParsedGroup {
+	std::string name;
+	std::vector<ParsedSite> sites;
+	std::vector<BytePatchSite> views; //point into sites, filled once sites stops growing
+	std::unique_ptr<BytePatchGroup> group;
+};
+
+//counts calls and can be told to fail the nth Unprotect
+class CountingProtector : public PageProtector {
+public:
+	int unprotects = 0;
+	int restores = 0;
+	int fail_at = -1;
+
+	bool Unprotect(void*, size_t, uint32_t& oldProtection) override {
+		if (unprotects++ == fail_at) {
+			return false;
+		}
+		oldProtection = 0x20;
+		return true;
+	}
+
+	bool Restore(void*, size_t, uint32_t) override {
+		restores++;
+		return true;
+	}
+
+	void reset() {
+		unprotects = restores = 0;
+		fail_at = -1;
+	}
+};
+
+static uint32_t rng_state = 0x9E3779B9;
+
+static uint32_t next_random() {
+	rng_state ^= rng_state << 13;
+	rng_state ^= rng_state >> 17;
+	rng_state ^= rng_state << 5;
+	return rng_state;
+}
+
+static void skip_space(const std::string& text, size_t& pos) {
+	while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\r' || text[pos] == '\n')) {
+		pos++;
+	}
+}
+
+//reads a C string literal starting at pos (on the opening quote), only \x escapes and plain characters
+static bool read_literal(const std::string& text, size_t& pos, std::string& out) {
+	skip_space(text, pos);
+	if (pos >= text.size() || text[pos] != '"') {
+		return false;
+	}
+	out.clear();
+	for (pos++; pos < text.size() && text[pos] != '"'; pos++) {
+		if (text[pos] != '\\') {
+			out += text[pos];
+			continue;
+		}
+		pos++;
+		if (pos < text.size() && text[pos] == 'x') {
+			int value = 0;
+			int digits = 0;
+			while (digits < 2 && pos + 1 < text.size() && isxdigit((unsigned char)text[pos + 1])) {
+				char c = (char)tolower(text[++pos]);
+				value = value * 16 + (c <= '9' ? c - '0' : c - 'a' + 10);
+				digits++;
+			}
+			out += (char)value;
+		}
+		else if (pos < text.size()) {
+			out += text[pos] == '0' ? '\0' : text[pos];
+		}
+	}
+	if (pos >= text.size()) {
+		return false;
+	}
+	pos++;
+	skip_space(text, pos);
+	return pos < text.size() && text[pos] == ',' && ++pos;
+}
+
+//every "static BytePatchGroup name {" block, one "{ rva, original, patched, length }," per line
+static bool parse_groups(const std::string& path, std::vector<std::unique_ptr<ParsedGroup>>& groups) {
+	std::ifstream in(path, std::ios::binary);
+	if (!in) {
+		return false;
+	}
+	std::stringstream ss;
+	ss << in.rdbuf();
+	const std::string text = ss.str();
+
+	const char* declaration = "static BytePatchGroup ";
+	for (size_t found = text.find(declaration); found != std::string::npos; found = text.find(declaration, found + 1)) {
+		size_t pos = found + strlen(declaration);
+		size_t brace = text.find('{', pos);
+		size_t end = text.find("};", pos);
+		if (brace == std::string::npos || end == std::string::npos) {
+			break;
+		}
+		std::unique_ptr<ParsedGroup> group(new ParsedGroup());
+		group->name = text.substr(pos, text.find_first_of(" {", pos) - pos);
+
+		for (pos = text.find('{', brace + 1); pos < end; pos = text.find('{', pos)) {
+			ParsedSite site;
+			char* after = NULL;
+			site.rva = (uint32_t)strtoul(text.c_str() + pos + 1, &after, 0);
+			pos = after - text.c_str();
+			skip_space(text, pos);
+			if (text[pos] != ',') {
+				return false;
+			}
+			pos++;
+			if (!read_literal(text, pos, site.original) || !read_literal(text, pos, site.patched)) {
+				return false;
+			}
+			site.length = (int)strtol(text.c_str() + pos, NULL, 0);
+			if (site.length <= 0 || (int)site.original.size() != site.length || (int)site.patched.size() != site.length) {
+				fprintf(stderr, "%s: site 0x%X has literals that don't match its length\n", group->name.c_str(), site.rva);
+				return false;
+			}
+			group->sites.push_back(site);
+		}
+
+		for (const ParsedSite& site : group->sites) {
+			group->views.push_back({ site.rva, site.original.data(), site.patched.data(), site.length });
+		}
+		group->group.reset(new BytePatchGroup(group->views));
+		groups.push_back(std::move(group));
+	}
+	return !groups.empty();
+}
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& group, const char* what) {
+	if (!condition) {
+		fprintf(stderr, "FAIL %s: %s\n", group.c_str(), what);
+		failures++;
+	}
+}
+
+static bool sites_hold(const std::vector<unsigned char>& image, const ParsedGroup& group, bool patched) {
+	for (const ParsedSite& site : group.sites) {
+		const std::string& bytes = patched ? site.patched : site.original;
+		if (memcmp(image.data() + site.rva, bytes.data(), site.length) != 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+int main(int argc, char** argv) {
+	std::string patches_path = "src/Hooks/Patches.cpp";
+	int iterations = 200000;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-i") == 0 && i + 1 < argc) {
+			iterations = atoi(argv[++i]);
+		}
+		else {
+			patches_path = argv[i];
+		}
+	}
+	if (iterations <= 0) {
+		fprintf(stderr, "iterations have to be positive\n");
+		return 1;
+	}
+
+	std::vector<std::unique_ptr<ParsedGroup>> groups;
+	if (!parse_groups(patches_path, groups)) {
+		fprintf(stderr, "no patch groups read from %s\n", patches_path.c_str());
+		return 1;
+	}
+
+	//big enough for every site's whole pages, random bytes with the originals planted
+	uint32_t image_size = 0;
+	for (const auto& group : groups) {
+		for (const ParsedSite& site : group->sites) {
+			uint32_t last = (site.rva + site.length - 1) | (BYTE_PATCH_PAGE_SIZE - 1);
+			image_size = last + 1 > image_size ? last + 1 : image_size;
+		}
+	}
+	std::vector<unsigned char> image(image_size);
+	for (size_t i = 0; i < image.size(); i++) {
+		image[i] = (unsigned char)next_random();
+	}
+	for (const auto& group : groups) {
+		for (const ParsedSite& site : group->sites) {
+			memcpy(image.data() + site.rva, site.original.data(), site.length);
+		}
+	}
+	const std::vector<unsigned char> pristine = image;
+	unsigned char* base = image.data();
+	CountingProtector protector;
+
+	printf("%zu patch groups from %s\n", groups.size(), patches_path.c_str());
+	printf("%-24s %6s %6s %10s\n", "group", "sites", "bytes", "page runs");
+
+	for (const auto& parsed : groups) {
+		BytePatchGroup& group = *parsed->group;
+		const std::string& name = parsed->name;
+		printf("%-24s %6d %6d %10d\n", name.c_str(), group.GetSiteCount(), group.GetByteCount(), group.GetPageRunCount());
+
+		protector.reset();
+		check(group.Apply(base, protector), name, "apply failed on pristine bytes");
+		check(group.IsApplied(), name, "not marked applied");
+		check(sites_hold(image, *parsed, true), name, "patched bytes not written");
+		check(protector.unprotects == group.GetPageRunCount() && protector.restores == group.GetPageRunCount(), name, "one unprotect/restore per page run on apply");
+
+		protector.reset();
+		check(group.Apply(base, protector), name, "second apply failed");
+		check(protector.unprotects == 0, name, "second apply touched protection");
+
+		protector.reset();
+		check(group.Revert(base, protector), name, "revert failed");
+		check(image == pristine, name, "revert didn't restore every byte");
+		check(protector.unprotects == group.GetPageRunCount(), name, "one unprotect per page run on revert");
+
+		protector.reset();
+		check(group.Revert(base, protector), name, "second revert failed");
+		check(protector.unprotects == 0, name, "second revert touched protection");
+
+		//one wrong original byte in the last site, nothing may be written
+		const ParsedSite& last = parsed->sites.back();
+		image[last.rva + last.length - 1] ^= 0xFF;
+		const std::vector<unsigned char> tampered = image;
+		protector.reset();
+		check(!group.Apply(base, protector), name, "apply went through over a wrong original byte");
+		check(image == tampered, name, "failed apply wrote bytes");
+		check(protector.unprotects == 0, name, "failed apply touched protection");
+		check(!group.IsApplied(), name, "failed apply marked applied");
+		image = pristine;
+
+		//protection failing on the last run, nothing may be written and every unprotected run gets restored
+		protector.reset();
+		protector.fail_at = group.GetPageRunCount() - 1;
+		check(!group.Apply(base, protector), name, "apply went through a failed unprotect");
+		check(image == pristine, name, "apply with a failed unprotect wrote bytes");
+		check(protector.restores == group.GetPageRunCount() - 1, name, "unprotected runs not restored");
+		check(!group.IsApplied(), name, "apply with a failed unprotect marked applied");
+
+		//bytes changed under an applied patch, revert has to leave them alone
+		protector.reset();
+		group.Apply(base, protector);
+		image[parsed->sites[0].rva] ^= 0xFF;
+		const std::vector<unsigned char> overwritten = image;
+		check(!group.Revert(base, protector), name, "revert went through over changed bytes");
+		check(image == overwritten, name, "failed revert wrote bytes");
+		check(group.IsApplied(), name, "failed revert marked not applied");
+		image[parsed->sites[0].rva] ^= 0xFF;
+		check(group.Revert(base, protector) && image == pristine, name, "revert after the bytes came back");
+	}
+
+	//groups sharing bytes (the two OD distortion filters) can't both go in, the second one has to fail cleanly
+	int conflicts = 0;
+	for (size_t a = 0; a < groups.size(); a++) {
+		for (size_t b = 0; b < groups.size(); b++) {
+			if (a == b) {
+				continue;
+			}
+			bool overlap = false;
+			for (const ParsedSite& x : groups[a]->sites) {
+				for (const ParsedSite& y : groups[b]->sites) {
+					overlap |= x.rva < y.rva + y.length && y.rva < x.rva + x.length;
+				}
+			}
+			if (!overlap) {
+				continue;
+			}
+			const std::string name = groups[a]->name + " + " + groups[b]->name;
+			check(groups[a]->group->Apply(base, protector), name, "first apply failed");
+			const std::vector<unsigned char> applied = image;
+			bool second = groups[b]->group->Apply(base, protector);
+			if (second) {
+				//only fine if the patched bytes happen to be what the other expects
+				groups[b]->group->Revert(base, protector);
+			}
+			else {
+				check(image == applied, name, "conflicting apply wrote bytes");
+				conflicts++;
+			}
+			check(groups[a]->group->Revert(base, protector), name, "revert after conflict failed");
+			check(image == pristine, name, "image not pristine after conflict");
+		}
+	}
+	printf("overlapping pairs refused: %d\n", conflicts);
+
+	//every group on and off in turn, like ticking each patch in the UI and back
+	int sites = 0;
+	for (const auto& group : groups) {
+		sites += group->group->GetSiteCount();
+	}
+	protector.reset();
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < iterations; i++) {
+		for (const auto& group : groups) {
+			group->group->Apply(base, protector);
+			group->group->Revert(base, protector);
+		}
+	}
+	double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	check(image == pristine, "cycle", "image not pristine after apply/revert cycles");
+	printf("%d apply+revert cycles of every group: %.2f ms, %.0f ns per group toggle\n",
+		iterations, ms, ms * 1e6 / ((double)iterations * groups.size() * 2));
+	printf("unprotect+restore pairs per cycle: %d (%d with a VirtualProtect pair per site)\n",
+		protector.unprotects / iterations, sites * 2);
+
+	printf("%s (%d failures)\n", failures == 0 ? "ok" : "FAILED", failures);
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,125 @@
+/*
+	Bulk decode of replay inputs outside the game, runs the mod's own codec (src/Game/ReplayFiles/ReplayInputCodec.cpp)
+	over a folder of replay files, checks that encoding the decoded inputs gives back the same bytes and times the decoder.
+	See docs/replay_codec.md.
+
+	Build (Linux, from the repo root):
+	g++ -std=c++14 -O2 -Isrc tools/ReplayCodec/replay_codec.cpp src/Game/ReplayFiles/ReplayInputCodec.cpp -lstdc++fs -o replay_codec
+
+	Usage: replay_codec <replay folder> [-i iterations]
+	Every regular file in the folder is read as a replay, iterations > 1 decodes each one that many times to get a
+	steadier throughput number.
+*/
+#include "Game/ReplayFiles/ReplayInputCodec.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <experimental/filesystem>
+
+namespace fs = std::experimental::filesystem;
+
+#define MAX_REPORTED_MISMATCHES 10
+
+static bool read_file(const std::string& path, std::vector<uint8_t>& out) {
+	std::ifstream f(path, std::ios::binary);
+	if (!f.is_open()) {
+		return false;
+	}
+	f.seekg(0, std::ios::end);
+	out.resize((size_t)f.tellg());
+	f.seekg(0, std::ios::beg);
+	f.read((char*)out.data(), out.size());
+	return f.good();
+}
+
+int main(int argc, char** argv) {
+	if (argc < 2) {
+		fprintf(stderr, "usage: replay_codec <replay folder> [-i iterations]\n");
+		return 1;
+	}
+	std::string folder = argv[1];
+	int iterations = 1;
+	for (int i = 2; i < argc; i++) {
+		if (strcmp(argv[i], "-i") == 0 && i + 1 < argc) {
+			iterations = atoi(argv[++i]);
+		}
+	}
+	if (iterations < 1) {
+		iterations = 1;
+	}
+
+	std::error_code ec;
+	if (!fs::is_directory(folder, ec)) {
+		fprintf(stderr, "%s is not a folder\n", folder.c_str());
+		return 1;
+	}
+
+	int replays = 0;
+	int failed = 0;
+	int mismatched = 0;
+	long long frames = 0;
+	long long rounds = 0;
+	double decode_seconds = 0;
+	std::vector<uint8_t> file;
+	std::vector<uint8_t> encoded(REPLAY_INPUT_STREAM_SIZE);
+	ReplayInputs inputs;
+
+	for (const auto& entry : fs::directory_iterator(folder)) {
+		if (!fs::is_regular_file(entry.status())) {
+			continue;
+		}
+		std::string name = entry.path().filename().string();
+		if (!read_file(entry.path().string(), file) || file.size() < REPLAY_INPUT_STREAM_OFFSET + REPLAY_INPUT_STREAM_SIZE) {
+			fprintf(stderr, "%s: too small to be a replay\n", name.c_str());
+			failed++;
+			continue;
+		}
+
+		bool decoded = true;
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < iterations && decoded; i++) {
+			decoded = ReplayInputCodec::decode_file(file.data(), file.size(), inputs);
+		}
+		decode_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		if (!decoded) {
+			fprintf(stderr, "%s: malformed input stream\n", name.c_str());
+			failed++;
+			continue;
+		}
+		replays++;
+		rounds += inputs.get_round_count();
+		for (const auto& chunk : inputs.chunks) {
+			frames += chunk.frames.size();
+		}
+
+		const uint8_t* stream = file.data() + REPLAY_INPUT_STREAM_OFFSET;
+		if (!ReplayInputCodec::encode(inputs, encoded.data(), encoded.size())) {
+			fprintf(stderr, "%s: decoded inputs don't fit back in the stream\n", name.c_str());
+			mismatched++;
+			continue;
+		}
+		if (memcmp(stream, encoded.data(), REPLAY_INPUT_STREAM_SIZE) != 0) {
+			if (mismatched < MAX_REPORTED_MISMATCHES) {
+				size_t at = 0;
+				while (stream[at] == encoded[at]) {
+					at++;
+				}
+				fprintf(stderr, "%s: round trip differs at file offset 0x%zx (%02x, re-encoded %02x)\n",
+					name.c_str(), REPLAY_INPUT_STREAM_OFFSET + at, stream[at], encoded[at]);
+			}
+			mismatched++;
+		}
+	}
+
+	printf("%d replays decoded (%d failed), %lld rounds, %lld frames\n", replays, failed, rounds, frames);
+	if (replays > 0) {
+		double per_replay_us = decode_seconds * 1e6 / ((double)replays * iterations);
+		printf("decode: %.2f us per replay, %.0f replays/s\n", per_replay_us, per_replay_us > 0 ? 1e6 / per_replay_us : 0);
+	}
+	printf("round trip: %d of %d replays re-encode byte for byte\n", replays - mismatched, replays);
+	return failed == 0 && mismatched == 0 ? 0 : 1;
+}
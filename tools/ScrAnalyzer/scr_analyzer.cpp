@@ -0,0 +1,409 @@
+/*
+	Offline frame data dump, runs the mod's own script parser (src/Game/Scr/ScrScriptParser.cpp) over extracted
+	character files instead of game memory. See docs/scr_analyzer.md.
+
+	Build (Linux, from the repo root):
+	g++ -std=c++14 -O2 -pthread -Isrc -Isrc/Game/Scr tools/ScrAnalyzer/scr_analyzer.cpp src/Game/Scr/ScrScriptParser.cpp
+		src/Game/Scr/ScrStateArena.cpp src/Game/Jonb/JonbDBReader.cpp src/Game/Jonb/JonbDB.cpp -lstdc++fs -o scr_analyzer
+
+	Usage: scr_analyzer <dump folder> [-o frame_data.json] [-j threads] [-i iterations]
+	For every scr_XX.bin in the folder it expects scr_XXea.bin next to it, char_XX_col.pac is optional
+	(without it nothing is marked active). Characters are parsed in parallel, iterations > 1 reparses each
+	script that many times to get a steadier throughput number.
+	It also checks the command size table in CmdList.h against searching the lists, and times both.
+*/
+#include "Game/Scr/ScrScriptParser.h"
+#include "Game/Scr/CmdList.h"
+#include "Game/Jonb/JonbDBReader.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <experimental/filesystem>
+
+namespace fs = std::experimental::filesystem;
+
+#define LOOKUP_SAMPLE_WORDS 16384 // words per script the lookup comparison runs on, searching the lists is too slow for whole scripts
+
+struct CharacterDump {
+	std::string prefix; // "ar" for scr_ar.bin
+	std::string folder;
+
+	// filled by the worker
+	bool ok = false;
+	int states = 0;
+	double parse_seconds = 0; // all iterations
+	ScrParseReport report;
+	std::vector<uint32_t> sample_words; // evenly spread words of scr_XX.bin, what the lookups are timed on
+	std::string json;
+};
+
+static bool read_padded(const std::string& path, std::vector<char>& data) {
+	std::ifstream in(path, std::ios::binary | std::ios::ate);
+	if (!in.is_open()) {
+		return false;
+	}
+	size_t size = (size_t)in.tellg();
+	data.assign(size + SCR_PARSE_PADDING, 0);
+	in.seekg(0);
+	in.read(data.data(), size);
+	return (bool)in;
+}
+
+static std::string json_string(const std::string& str) {
+	std::string out = "\"";
+	for (char c : str) {
+		if (c == '"' || c == '\\') {
+			out += '\\';
+			out += c;
+		}
+		else if ((unsigned char)c < 0x20) {
+			char buf[8];
+			snprintf(buf, sizeof(buf), "\\u%04x", (unsigned char)c);
+			out += buf;
+		}
+		else {
+			out += c;
+		}
+	}
+	return out + "\"";
+}
+
+static std::string invuln_flags(FrameInvuln invuln) {
+	std::string flags;
+	uint16_t mask = (uint16_t)invuln;
+	if (mask & (uint16_t)FrameInvuln::Head) flags += 'H';
+	if (mask & (uint16_t)FrameInvuln::Body) flags += 'B';
+	if (mask & (uint16_t)FrameInvuln::Foot) flags += 'F';
+	if (mask & (uint16_t)FrameInvuln::Throw) flags += 'T';
+	return flags;
+}
+
+static bool is_active(FrameActivity activity) {
+	return activity == FrameActivity::Active || activity == FrameActivity::NonDeterministicAcive;
+}
+
+static void write_names(std::ostringstream& out, const char* key, const std::vector<ScrName>& names) {
+	out << ",\"" << key << "\":[";
+	for (size_t i = 0; i < names.size(); i++) {
+		out << (i ? "," : "") << json_string(names[i].get());
+	}
+	out << "]";
+}
+
+static void write_state(std::ostringstream& out, const scrState& state) {
+	//startup is the first active frame, active spans first to last active frame, recovery is what's left after it
+	int first_active = -1;
+	int last_active = -1;
+	bool non_deterministic = false;
+	int frame = 0;
+	for (auto activity : state.frame_activity_status) {
+		if (is_active(activity)) {
+			if (first_active < 0) {
+				first_active = frame;
+			}
+			last_active = frame;
+		}
+		non_deterministic |= ((uint16_t)activity & 0x10) != 0;
+		frame++;
+	}
+	int total = (int)state.frame_activity_status.size();
+
+	out << "{\"name\":" << json_string(state.name.get())
+		<< ",\"frames\":" << total
+		<< ",\"startup\":" << first_active + 1
+		<< ",\"active\":" << (first_active >= 0 ? last_active - first_active + 1 : 0)
+		<< ",\"recovery\":" << (first_active >= 0 ? total - last_active - 1 : 0)
+		<< ",\"non_deterministic\":" << (non_deterministic ? "true" : "false")
+		<< ",\"damage\":" << state.damage
+		<< ",\"atk_level\":" << state.atk_level
+		<< ",\"hitstun\":" << state.hitstun
+		<< ",\"blockstun\":" << state.blockstun
+		<< ",\"hitstop\":" << state.hitstop
+		<< ",\"starter_rating\":" << state.starter_rating
+		<< ",\"attack_p1\":" << state.attack_p1
+		<< ",\"attack_p2\":" << state.attack_p2
+		<< ",\"overhead\":" << state.hit_overhead
+		<< ",\"low\":" << state.hit_low
+		<< ",\"air_unblockable\":" << state.hit_air_unblockable
+		<< ",\"fatal_counter\":" << state.fatal_counter;
+
+	out << ",\"invuln\":[";
+	bool first_window = true;
+	size_t invuln_frames = state.frame_invuln_status.size();
+	for (size_t i = 0; i < invuln_frames;) {
+		FrameInvuln invuln = state.frame_invuln_status[i];
+		size_t end = i;
+		while (end + 1 < invuln_frames && state.frame_invuln_status[end + 1] == invuln) {
+			end++;
+		}
+		if (invuln != FrameInvuln::None) {
+			out << (first_window ? "" : ",") << "{\"start\":" << i + 1 << ",\"end\":" << end + 1 << ",\"flags\":\"" << invuln_flags(invuln) << "\"}";
+			first_window = false;
+		}
+		i = end + 1;
+	}
+	out << "]";
+
+	write_names(out, "whiff_cancel", state.whiff_cancel);
+	write_names(out, "hit_or_block_cancel", state.hit_or_block_cancel);
+	out << ",\"spawns\":[";
+	for (size_t i = 0; i < state.frame_EA_effect_pairs.size(); i++) {
+		auto& pair = state.frame_EA_effect_pairs[i];
+		out << (i ? "," : "") << "{\"frame\":" << pair.first + 1 << ",\"state\":" << json_string(pair.second->name.get()) << "}";
+	}
+	out << "]}";
+}
+
+static void analyze_character(CharacterDump& dump, int iterations) {
+	std::string base = dump.folder + "/";
+	std::vector<char> scr, ea_scr, col;
+	if (!read_padded(base + "scr_" + dump.prefix + ".bin", scr) || !read_padded(base + "scr_" + dump.prefix + "ea.bin", ea_scr)) {
+		return;
+	}
+	JonbDB jonb_db;
+	if (read_padded(base + "char_" + dump.prefix + "_col.pac", col)) {
+		//jubei's index entries are spaced differently, same as in JonbDBReader::parse_all_jonbins
+		jonb_db = JonbDBReader::parse_fpac(col.data(), col.data() + col.size() - SCR_PARSE_PADDING, dump.prefix == "jb");
+	}
+	ScrScriptLocation location;
+	if (!locate_scr_blob(scr.data(), scr.size() - SCR_PARSE_PADDING, ea_scr.data(), ea_scr.size() - SCR_PARSE_PADDING, location)) {
+		return;
+	}
+
+	std::shared_ptr<ScrStateArena> arena;
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < iterations; i++) {
+		ScrParseReport report;
+		arena = parse_scr_script(location, &jonb_db, &report);
+		if (i == 0) {
+			dump.report = report;
+		}
+	}
+	dump.parse_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	dump.states = (int)arena->states.size();
+
+	size_t words = (scr.size() - SCR_PARSE_PADDING) / 4;
+	size_t stride = words > LOOKUP_SAMPLE_WORDS ? words / LOOKUP_SAMPLE_WORDS : 1;
+	for (size_t i = 0; i < words; i += stride) {
+		uint32_t word;
+		memcpy(&word, scr.data() + i * 4, 4);
+		dump.sample_words.push_back(word);
+	}
+
+	std::ostringstream out;
+	out << "{\"character\":" << json_string(dump.prefix)
+		<< ",\"states\":" << dump.states
+		<< ",\"ea_states\":" << arena->ea_states.size()
+		<< ",\"jonbins\":" << jonb_db.size()
+		<< ",\"boxes\":" << jonb_db.get_box_count()
+		<< ",\"parse_us\":" << (long long)(dump.parse_seconds * 1000000 / iterations)
+		<< ",\"truncated_states\":" << dump.report.truncated_states
+		<< ",\"unknown_opcode_stops\":[";
+	for (size_t i = 0; i < dump.report.unknown_opcodes.size(); i++) {
+		auto& stop = dump.report.unknown_opcodes[i];
+		out << (i ? "," : "") << "{\"state\":" << json_string(stop.state) << ",\"offset\":" << stop.offset << ",\"cmd\":" << stop.cmd << "}";
+	}
+	out << "],\"moves\":[";
+	for (size_t i = 0; i < arena->states.size(); i++) {
+		out << (i ? ",\n" : "\n");
+		write_state(out, *arena->states[i]);
+	}
+	out << "]}";
+	dump.json = out.str();
+	dump.ok = true;
+}
+
+template <size_t N>
+static bool is_in_cmd_list(const unsigned int (&cmds)[N], unsigned int cmd) {
+	return std::find(cmds, cmds + N, cmd) != cmds + N;
+}
+
+//how the parser found a command's size before the table in CmdList.h, searching every list in order
+static int get_cmd_size_linear(unsigned int cmd) {
+	if (is_in_cmd_list(size_4, cmd)) return 4;
+	if (is_in_cmd_list(size_8, cmd)) return 8;
+	if (is_in_cmd_list(size_12, cmd)) return 12;
+	if (is_in_cmd_list(size_16, cmd)) return 16;
+	if (is_in_cmd_list(size_20, cmd)) return 20;
+	if (is_in_cmd_list(size_24, cmd)) return 24;
+	if (is_in_cmd_list(size_28, cmd)) return 28;
+	if (is_in_cmd_list(size_32, cmd)) return 32;
+	if (is_in_cmd_list(size_36, cmd)) return 36;
+	if (is_in_cmd_list(size_40, cmd)) return 40;
+	if (is_in_cmd_list(size_44, cmd)) return 44;
+	if (is_in_cmd_list(size_48, cmd)) return 48;
+	if (is_in_cmd_list(size_52, cmd)) return 52;
+	if (is_in_cmd_list(size_68, cmd)) return 68;
+	if (is_in_cmd_list(size_72, cmd)) return 72;
+	if (is_in_cmd_list(size_84, cmd)) return 84;
+	if (is_in_cmd_list(size_88, cmd)) return 88;
+	if (is_in_cmd_list(size_132, cmd)) return 132;
+	if (is_in_cmd_list(size_148, cmd)) return 148;
+	return 0;
+}
+
+struct LookupComparison {
+	int mismatches = 0; // opcodes the table and the list search disagree on
+	long long lookups = 0;
+	double linear_per_second = 0;
+	double table_per_second = 0;
+};
+
+template <typename F>
+static double time_lookups(const std::vector<CharacterDump>& dumps, int iterations, F lookup, long long& sum) {
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < iterations; i++) {
+		for (auto& dump : dumps) {
+			for (uint32_t word : dump.sample_words) {
+				sum += lookup(word);
+			}
+		}
+	}
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static LookupComparison compare_cmd_lookups(const std::vector<CharacterDump>& dumps, int iterations) {
+	LookupComparison result;
+	for (unsigned int cmd = 0; cmd < SCR_CMD_TABLE_SIZE + 64; cmd++) {
+		if (get_cmd_size(cmd) != get_cmd_size_linear(cmd)) {
+			fprintf(stderr, "opcode %u: size table says %d, the lists say %d\n", cmd, get_cmd_size(cmd), get_cmd_size_linear(cmd));
+			result.mismatches++;
+		}
+	}
+	for (auto& dump : dumps) {
+		result.lookups += (long long)dump.sample_words.size() * iterations;
+	}
+	long long linear_sum = 0;
+	long long table_sum = 0;
+	double linear_seconds = time_lookups(dumps, iterations, get_cmd_size_linear, linear_sum);
+	double table_seconds = time_lookups(dumps, iterations, [](unsigned int cmd) { return get_cmd_size(cmd); }, table_sum);
+	if (linear_sum != table_sum) {
+		result.mismatches++;
+	}
+	result.linear_per_second = linear_seconds > 0 ? result.lookups / linear_seconds : 0;
+	result.table_per_second = table_seconds > 0 ? result.lookups / table_seconds : 0;
+	return result;
+}
+
+static std::vector<CharacterDump> find_characters(const std::string& folder) {
+	std::vector<CharacterDump> dumps;
+	for (auto& entry : fs::directory_iterator(folder)) {
+		std::string filename = entry.path().filename().string();
+		if (filename.size() <= 8 || filename.compare(0, 4, "scr_") != 0 || filename.compare(filename.size() - 4, 4, ".bin") != 0) {
+			continue;
+		}
+		std::string prefix = filename.substr(4, filename.size() - 8);
+		//scr_XXea.bin is the effect script of scr_XX.bin, it isn't a character on its own
+		if (prefix.size() > 2 && prefix.compare(prefix.size() - 2, 2, "ea") == 0 && fs::exists(folder + "/scr_" + prefix.substr(0, prefix.size() - 2) + ".bin")) {
+			continue;
+		}
+		CharacterDump dump;
+		dump.prefix = prefix;
+		dump.folder = folder;
+		dumps.push_back(dump);
+	}
+	std::sort(dumps.begin(), dumps.end(), [](const CharacterDump& a, const CharacterDump& b) { return a.prefix < b.prefix; });
+	return dumps;
+}
+
+int main(int argc, char** argv) {
+	if (argc < 2) {
+		fprintf(stderr, "usage: %s <dump folder> [-o frame_data.json] [-j threads] [-i iterations]\n", argv[0]);
+		return 1;
+	}
+	std::string folder = argv[1];
+	std::string out_path = "frame_data.json";
+	int threads = (int)std::thread::hardware_concurrency();
+	int iterations = 1;
+	for (int i = 2; i + 1 < argc; i += 2) {
+		if (strcmp(argv[i], "-o") == 0) out_path = argv[i + 1];
+		else if (strcmp(argv[i], "-j") == 0) threads = atoi(argv[i + 1]);
+		else if (strcmp(argv[i], "-i") == 0) iterations = atoi(argv[i + 1]);
+	}
+	threads = threads < 1 ? 1 : threads;
+	iterations = iterations < 1 ? 1 : iterations;
+
+	std::vector<CharacterDump> dumps;
+	try {
+		dumps = find_characters(folder);
+	}
+	catch (const fs::filesystem_error& e) {
+		fprintf(stderr, "%s\n", e.what());
+		return 1;
+	}
+	if (dumps.empty()) {
+		fprintf(stderr, "no scr_XX.bin files in %s\n", folder.c_str());
+		return 1;
+	}
+
+	//same work split as ReplayArchiveStats::build, workers pull the next character off a shared cursor
+	auto start = std::chrono::steady_clock::now();
+	std::atomic<size_t> cursor(0);
+	std::vector<std::thread> pool;
+	for (int t = 0; t < threads && t < (int)dumps.size(); t++) {
+		pool.emplace_back([&]() {
+			for (size_t i = cursor++; i < dumps.size(); i = cursor++) {
+				analyze_character(dumps[i], iterations);
+			}
+		});
+	}
+	for (auto& thread : pool) {
+		thread.join();
+	}
+	double wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	int characters = 0;
+	long long states = 0;
+	double parse_seconds = 0;
+	int unknown_opcode_stops = 0;
+	int truncated_states = 0;
+	std::ofstream out(out_path, std::ios::trunc);
+	out << "{\"characters\":[";
+	for (auto& dump : dumps) {
+		if (!dump.ok) {
+			fprintf(stderr, "%s: couldn't read scr_%s.bin/scr_%sea.bin\n", dump.prefix.c_str(), dump.prefix.c_str(), dump.prefix.c_str());
+			continue;
+		}
+		out << (characters ? ",\n" : "\n") << dump.json;
+		characters++;
+		states += dump.states;
+		parse_seconds += dump.parse_seconds;
+		unknown_opcode_stops += (int)dump.report.unknown_opcodes.size();
+		truncated_states += dump.report.truncated_states;
+		for (auto& stop : dump.report.unknown_opcodes) {
+			fprintf(stderr, "%s: unknown opcode %u (0x%x) in %s at +%u\n", dump.prefix.c_str(), stop.cmd, stop.cmd, stop.state.c_str(), stop.offset);
+		}
+	}
+	double states_per_second = parse_seconds > 0 ? states * iterations / parse_seconds : 0;
+	LookupComparison lookups = compare_cmd_lookups(dumps, iterations);
+	out << "\n],\"summary\":{\"characters\":" << characters
+		<< ",\"states\":" << states
+		<< ",\"threads\":" << threads
+		<< ",\"iterations\":" << iterations
+		<< ",\"wall_seconds\":" << wall_seconds
+		<< ",\"states_per_second_per_thread\":" << (long long)states_per_second
+		<< ",\"unknown_opcode_stops\":" << unknown_opcode_stops
+		<< ",\"truncated_states\":" << truncated_states
+		<< ",\"cmd_lookups\":" << lookups.lookups
+		<< ",\"linear_lookups_per_second\":" << (long long)lookups.linear_per_second
+		<< ",\"table_lookups_per_second\":" << (long long)lookups.table_per_second
+		<< ",\"lookup_mismatches\":" << lookups.mismatches << "}}\n";
+	if (!out.good()) {
+		fprintf(stderr, "couldn't write %s\n", out_path.c_str());
+		return 1;
+	}
+	fprintf(stderr, "%d characters, %lld states in %.3fs on %d threads (%.0f states/s per thread), %d unknown opcode stops, %d truncated states -> %s\n",
+		characters, states, wall_seconds, threads, states_per_second, unknown_opcode_stops, truncated_states, out_path.c_str());
+	fprintf(stderr, "command sizes: %lld lookups, %.0f/s searching the lists, %.0f/s with the table (x%.1f), %d mismatches\n",
+		lookups.lookups, lookups.linear_per_second, lookups.table_per_second,
+		lookups.linear_per_second > 0 ? lookups.table_per_second / lookups.linear_per_second : 0, lookups.mismatches);
+	return lookups.mismatches == 0 ? 0 : 1;
+}
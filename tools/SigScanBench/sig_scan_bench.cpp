@@ -0,0 +1,254 @@
+/*
+	Offline benchmark for the hook signature scan (src/Hooks/PatternScanner.cpp). The signatures are read from the
+	HookManager::SetHook/RegisterHook calls in the .cpp files of src/Hooks, so the numbers follow the hooks the mod places.
+	They get planted into a synthetic image (random bytes weighted towards common x86 opcode bytes) and resolved
+	once per pattern the way HookManager used to, and once in a single pass. See docs/sig_scan_bench.md.
+
+	Build (Linux, from the repo root):
+	g++ -std=c++14 -O2 -Isrc tools/SigScanBench/sig_scan_bench.cpp src/Hooks/PatternScanner.cpp -lstdc++fs -o sig_scan_bench
+
+	Usage: sig_scan_bench [hooks folder] [-s image size in MB] [-i iterations] [--full-compare]
+	--full-compare also times the old loop that compared the whole mask at every offset, it is slow.
+*/
+#include "Hooks/PatternScanner.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <experimental/filesystem>
+
+namespace fs = std::experimental::filesystem;
+
+struct HookSignature {
+	std::string label;
+	std::string pattern;
+	std::string mask;
+	std::string file;
+};
+
+static uint32_t rng_state = 0x2545F491;
+
+static uint32_t next_random() {
+	rng_state ^= rng_state << 13;
+	rng_state ^= rng_state >> 17;
+	rng_state ^= rng_state << 5;
+	return rng_state;
+}
+
+static void skip_space(const std::string& text, size_t& pos) {
+	while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\r' || text[pos] == '\n')) {
+		pos++;
+	}
+}
+
+//reads a C string literal starting at pos (on the opening quote), only the escapes the hook files use
+static bool read_literal(const std::string& text, size_t& pos, std::string& out) {
+	skip_space(text, pos);
+	if (pos >= text.size() || text[pos] != '"') {
+		return false;
+	}
+	out.clear();
+	for (pos++; pos < text.size() && text[pos] != '"'; pos++) {
+		if (text[pos] != '\\') {
+			out += text[pos];
+			continue;
+		}
+		pos++;
+		if (pos >= text.size()) {
+			return false;
+		}
+		if (text[pos] == 'x') {
+			int value = 0;
+			int digits = 0;
+			while (digits < 2 && pos + 1 < text.size() && isxdigit((unsigned char)text[pos + 1])) {
+				char c = (char)tolower(text[++pos]);
+				value = value * 16 + (c <= '9' ? c - '0' : c - 'a' + 10);
+				digits++;
+			}
+			out += (char)value;
+		}
+		else if (text[pos] == '0') {
+			out += '\0';
+		}
+		else if (text[pos] == 'n') {
+			out += '\n';
+		}
+		else {
+			out += text[pos];
+		}
+	}
+	if (pos >= text.size()) {
+		return false;
+	}
+	pos++;
+	skip_space(text, pos);
+	return pos < text.size() && text[pos] == ',' && ++pos;
+}
+
+static void collect_signatures(const fs::path& file, std::vector<HookSignature>& signatures) {
+	std::ifstream in(file.string(), std::ios::binary);
+	std::stringstream ss;
+	ss << in.rdbuf();
+	const std::string text = ss.str();
+
+	const char* calls[] = { "HookManager::SetHook(", "HookManager::RegisterHook(" };
+	for (const char* call : calls) {
+		for (size_t found = text.find(call); found != std::string::npos; found = text.find(call, found + 1)) {
+			//commented out hooks don't count
+			size_t line_start = text.rfind('\n', found);
+			line_start = line_start == std::string::npos ? 0 : line_start + 1;
+			if (text.find("//", line_start) < found) {
+				continue;
+			}
+			HookSignature signature;
+			size_t pos = found + strlen(call);
+			//the direct address overloads have no pattern literal and get skipped here
+			if (!read_literal(text, pos, signature.label) || !read_literal(text, pos, signature.pattern)
+				|| !read_literal(text, pos, signature.mask) || signature.mask.size() > signature.pattern.size() + 1) {
+				continue;
+			}
+			signature.pattern.resize(signature.mask.size(), '\0');
+			signature.file = file.filename().string();
+			signatures.push_back(signature);
+		}
+	}
+}
+
+//the loop HookManager::FindPattern had, it compares the whole mask at every offset
+static const unsigned char* find_full_compare(const unsigned char* base, size_t size, const char* pattern, const char* mask) {
+	size_t length = strlen(mask);
+	for (size_t i = 0; i < size - length; i++) {
+		bool found = true;
+		for (size_t j = 0; j < length; j++) {
+			found &= mask[j] == '?' || pattern[j] == (char)base[i + j];
+		}
+		if (found) {
+			return base + i;
+		}
+	}
+	return NULL;
+}
+
+static double ms_since(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+	std::string hooks_folder = "src/Hooks";
+	size_t image_mb = 20;
+	int iterations = 3;
+	bool full_compare = false;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+			image_mb = (size_t)atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc) {
+			iterations = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--full-compare") == 0) {
+			full_compare = true;
+		}
+		else {
+			hooks_folder = argv[i];
+		}
+	}
+	if (image_mb == 0 || iterations <= 0) {
+		fprintf(stderr, "image size and iterations have to be positive\n");
+		return 1;
+	}
+
+	std::vector<HookSignature> signatures;
+	std::error_code ec;
+	for (fs::directory_iterator it(hooks_folder, ec), end; !ec && it != end; it.increment(ec)) {
+		if (it->path().extension() == ".cpp") {
+			collect_signatures(it->path(), signatures);
+		}
+	}
+	if (signatures.empty()) {
+		fprintf(stderr, "no signatures found in %s\n", hooks_folder.c_str());
+		return 1;
+	}
+
+	//weighted towards bytes that are common in x86 code so the anchors don't get it too easy
+	const unsigned char common[] = { 0x00, 0x00, 0x00, 0xff, 0x8b, 0x89, 0x8d, 0x83, 0xe8, 0xcc, 0x45, 0x4d, 0xc7, 0x50, 0x74, 0x75 };
+	std::vector<unsigned char> image(image_mb * 1024 * 1024);
+	for (size_t i = 0; i < image.size(); i++) {
+		uint32_t r = next_random();
+		image[i] = (r & 0x300) ? common[r & 15] : (unsigned char)(r >> 16);
+	}
+
+	//plant every signature in the last quarter, the worst case for scans that stop at the first match
+	size_t plant_at = image.size() - image.size() / 4;
+	for (const HookSignature& signature : signatures) {
+		if (plant_at + signature.mask.size() >= image.size()) {
+			break;
+		}
+		for (size_t j = 0; j < signature.mask.size(); j++) {
+			image[plant_at + j] = signature.mask[j] == '?' ? (unsigned char)next_random() : (unsigned char)signature.pattern[j];
+		}
+		plant_at += signature.mask.size() + 64 + next_random() % 4096;
+	}
+
+	const unsigned char* base = image.data();
+	const size_t size = image.size();
+	printf("%zu signatures from %s, %zu MB image, %d iterations\n", signatures.size(), hooks_folder.c_str(), image_mb, iterations);
+
+	std::vector<const unsigned char*> expected(signatures.size());
+	double per_pattern_ms = 0;
+	for (int iteration = 0; iteration < iterations; iteration++) {
+		auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < signatures.size(); i++) {
+			expected[i] = PatternScanner::FindFirst(base, size, signatures[i].pattern.c_str(), signatures[i].mask.c_str());
+		}
+		per_pattern_ms += ms_since(start);
+	}
+	per_pattern_ms /= iterations;
+
+	double full_compare_ms = 0;
+	if (full_compare) {
+		auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < signatures.size(); i++) {
+			if (find_full_compare(base, size, signatures[i].pattern.c_str(), signatures[i].mask.c_str()) != expected[i]) {
+				fprintf(stderr, "full compare disagrees on %s\n", signatures[i].label.c_str());
+			}
+		}
+		full_compare_ms = ms_since(start);
+	}
+
+	double single_pass_ms = 0;
+	int mismatches = 0;
+	int found = 0;
+	for (int iteration = 0; iteration < iterations; iteration++) {
+		PatternScanner scanner;
+		std::vector<int> ids(signatures.size());
+		auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < signatures.size(); i++) {
+			ids[i] = scanner.AddPattern(signatures[i].pattern.c_str(), signatures[i].mask.c_str());
+		}
+		scanner.Scan(base, size);
+		single_pass_ms += ms_since(start);
+
+		if (iteration == 0) {
+			for (size_t i = 0; i < signatures.size(); i++) {
+				if (scanner.GetMatch(ids[i]) != expected[i]) {
+					fprintf(stderr, "mismatch on %s (%s)\n", signatures[i].label.c_str(), signatures[i].file.c_str());
+					mismatches++;
+				}
+				found += expected[i] != NULL;
+			}
+		}
+	}
+	single_pass_ms /= iterations;
+
+	printf("found: %d/%zu, mismatches: %d\n", found, signatures.size(), mismatches);
+	if (full_compare) {
+		printf("per pattern, full compare: %10.2f ms\n", full_compare_ms);
+	}
+	printf("per pattern, early exit:   %10.2f ms\n", per_pattern_ms);
+	printf("single pass:               %10.2f ms\n", single_pass_ms);
+	return mismatches == 0 ? 0 : 1;
+}
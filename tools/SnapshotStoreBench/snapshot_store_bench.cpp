@@ -0,0 +1,222 @@
+/*
+	Offline checks and timings for the replay rewind snapshot store (src/Game/SnapshotApparatus/SnapshotStore.cpp).
+	A synthetic state the size of the game's (SNAPSHOT_STATE_SIZE, a bit over 10 MB) is mutated a little every checkpoint,
+	the way entity data moves between frames, and pushed through the store. Every checkpoint is restored and compared
+	against the hash of the state that was pushed. See docs/snapshot_store_bench.md.
+
+	Build (Linux, from the repo root):
+	g++ -std=c++14 -O2 -Isrc tools/SnapshotStoreBench/snapshot_store_bench.cpp src/Game/SnapshotApparatus/SnapshotStore.cpp -lpthread -o snapshot_store_bench
+
+	Usage: snapshot_store_bench [-n checkpoints] [-k keyframe interval] [-c changed bytes per checkpoint]
+*/
+#include "Core/hash.h"
+#include "Game/SnapshotApparatus/SnapshotStore.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+static uint32_t rng_state = 0x1234567;
+
+static uint32_t next_random() {
+	rng_state ^= rng_state << 13;
+	rng_state ^= rng_state >> 17;
+	rng_state ^= rng_state << 5;
+	return rng_state;
+}
+
+static double ms_since(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static int failures = 0;
+
+static void check(bool condition, const char* what) {
+	if (!condition) {
+		fprintf(stderr, "FAIL: %s\n", what);
+		failures++;
+	}
+}
+
+//a state that is mostly zeroes with a few dense blocks, roughly what the game's heap looks like
+static void fill_initial_state(std::vector<uint8_t>& state) {
+	memset(state.data(), 0, state.size());
+	for (size_t block = 0; block < state.size(); block += 0x10000) {
+		if (next_random() % 4 != 0) {
+			continue;
+		}
+		size_t length = 0x800 + next_random() % 0x8000;
+		for (size_t i = block; i < block + length && i < state.size(); i++) {
+			state[i] = (uint8_t)(next_random() >> 8);
+		}
+	}
+}
+
+//short runs of changed bytes spread over the state, like entity positions, timers and the frame counter
+static void mutate_state(std::vector<uint8_t>& state, size_t changed_bytes) {
+	size_t changed = 0;
+	while (changed < changed_bytes) {
+		size_t run = 4 + next_random() % 60;
+		size_t at = next_random() % (state.size() - run);
+		for (size_t i = 0; i < run; i++) {
+			state[at + i] = (uint8_t)(next_random() >> 8);
+		}
+		changed += run;
+	}
+}
+
+int main(int argc, char** argv) {
+	int checkpoints = 64;
+	int keyframe_interval = 16;
+	size_t changed_bytes = 16 * 1024;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+			checkpoints = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-k") == 0 && i + 1 < argc) {
+			keyframe_interval = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+			changed_bytes = (size_t)atoi(argv[++i]);
+		}
+	}
+	if (checkpoints < 4 || keyframe_interval <= 0) {
+		fprintf(stderr, "need at least 4 checkpoints and a positive keyframe interval\n");
+		return 1;
+	}
+
+	const size_t size = SNAPSHOT_STATE_SIZE;
+	std::vector<uint8_t> state(size);
+	std::vector<uint8_t> previous(size);
+	std::vector<uint8_t> restored(size);
+	fill_initial_state(state);
+	printf("%d checkpoints of %zu bytes, keyframe every %d, %zu bytes changed per checkpoint\n",
+		checkpoints, size, keyframe_interval, changed_bytes);
+
+	//the codec on its own: a keyframe, a delta, and both decoded back
+	{
+		std::vector<uint8_t> keyframe;
+		std::vector<uint8_t> delta;
+		auto start = std::chrono::steady_clock::now();
+		SnapshotStore::encode_delta(state.data(), nullptr, size, keyframe);
+		double keyframe_ms = ms_since(start);
+
+		previous = state;
+		mutate_state(state, changed_bytes);
+		start = std::chrono::steady_clock::now();
+		SnapshotStore::encode_delta(state.data(), previous.data(), size, delta);
+		double delta_ms = ms_since(start);
+
+		memset(restored.data(), 0, size);
+		start = std::chrono::steady_clock::now();
+		check(SnapshotStore::apply_delta(keyframe.data(), keyframe.size(), restored.data(), size), "keyframe didn't decode");
+		double keyframe_decode_ms = ms_since(start);
+		check(restored == previous, "keyframe round trip");
+		start = std::chrono::steady_clock::now();
+		check(SnapshotStore::apply_delta(delta.data(), delta.size(), restored.data(), size), "delta didn't decode");
+		double delta_decode_ms = ms_since(start);
+		check(restored == state, "delta round trip");
+
+		check(!SnapshotStore::apply_delta(delta.data(), delta.size() - 1, restored.data(), size), "truncated delta accepted");
+
+		printf("keyframe: %10zu bytes (%6.2fx)  encode %7.2f ms  decode %7.2f ms\n",
+			keyframe.size(), (double)size / keyframe.size(), keyframe_ms, keyframe_decode_ms);
+		printf("delta:    %10zu bytes (%6.0fx)  encode %7.2f ms  decode %7.2f ms\n",
+			delta.size(), (double)size / delta.size(), delta_ms, delta_decode_ms);
+	}
+
+	//the store, pushed from this thread and through the worker
+	for (int async = 0; async <= 1; async++) {
+		SnapshotStore store(size, keyframe_interval);
+		std::vector<uint64_t> hashes;
+		double push_ms = 0;
+		long long stage_us = 0;
+
+		auto start_all = std::chrono::steady_clock::now();
+		for (int i = 0; i < checkpoints; i++) {
+			mutate_state(state, changed_bytes);
+			hashes.push_back(fnv1a64_words(state.data(), size));
+			auto start = std::chrono::steady_clock::now();
+			int index = async ? store.push_async((unsigned int)i * 10, state.data()) : store.push((unsigned int)i * 10, state.data());
+			push_ms += ms_since(start);
+			stage_us += store.last_stage_us;
+			check(index == i, "push returned the wrong index");
+		}
+		store.flush();
+		double total_ms = ms_since(start_all);
+
+		double restore_ms = 0;
+		for (int i = 0; i < checkpoints; i++) {
+			auto start = std::chrono::steady_clock::now();
+			check(store.restore(i, restored.data()), "restore failed");
+			restore_ms += ms_since(start);
+			check(fnv1a64_words(restored.data(), size) == hashes[i], "restored checkpoint differs");
+		}
+		check(store.find_nearest_index(15) == 1, "find_nearest_index");
+
+		printf("%s: %d checkpoints, %.1f MB raw -> %.2f MB (%.0fx), push %.2f ms avg%s, restore %.2f ms avg, %.0f ms total\n",
+			async ? "push_async" : "push      ", checkpoints, store.get_raw_bytes() / 1048576.0, store.get_encoded_bytes() / 1048576.0,
+			(double)store.get_raw_bytes() / store.get_encoded_bytes(), push_ms / checkpoints,
+			async ? (std::string(" (staging ") + std::to_string(stage_us / checkpoints) + " us)").c_str() : "",
+			restore_ms / checkpoints, total_ms);
+
+		if (async) {
+			//remove_async from the middle, a keyframe and the newest, queued between pushes, the indices shift right away
+			double remove_ms = 0;
+			int removals[] = { 3, keyframe_interval < checkpoints - 2 ? keyframe_interval : 1, -1 };
+			for (int removal : removals) {
+				if (removal < 0) {
+					removal = (int)hashes.size() - 1;
+				}
+				auto start = std::chrono::steady_clock::now();
+				check(store.remove_async(removal), "remove_async refused");
+				remove_ms += ms_since(start);
+				hashes.erase(hashes.begin() + removal);
+				check(store.size() == (int)hashes.size(), "size after remove_async");
+				mutate_state(state, changed_bytes);
+				hashes.push_back(fnv1a64_words(state.data(), size));
+				check(store.push_async(200000 + removal, state.data()) == (int)hashes.size() - 1, "push_async index after remove_async");
+			}
+			check(!store.remove_async(store.size()), "remove_async past the end accepted");
+			for (int i = 0; i < (int)hashes.size(); i++) {
+				check(store.restore(i, restored.data()) && fnv1a64_words(restored.data(), size) == hashes[i],
+					"checkpoint differs after remove_async");
+			}
+			printf("remove_async: %.3f ms avg on the calling thread, last fold %.2f ms on the worker\n",
+				remove_ms / 3, store.last_remove_us.load() / 1000.0);
+			continue;
+		}
+
+		//remove folds the removed delta into the next one, from the middle of a chain, a keyframe, and the newest one
+		int removals[] = { 3, keyframe_interval < checkpoints - 2 ? keyframe_interval : 1, -1 };
+		for (int removal : removals) {
+			if (removal < 0) {
+				removal = (int)hashes.size() - 1;
+			}
+			size_t encoded_before = store.get_encoded_bytes();
+			check(store.remove(removal), "remove failed");
+			hashes.erase(hashes.begin() + removal);
+			check(store.size() == (int)hashes.size(), "size after remove");
+			check(store.get_encoded_bytes() != encoded_before, "encoded bytes not updated on remove");
+			for (int i = 0; i < (int)hashes.size(); i++) {
+				check(store.restore(i, restored.data()) && fnv1a64_words(restored.data(), size) == hashes[i],
+					"checkpoint differs after remove");
+			}
+		}
+
+		//the newest removal rebuilt the base for the next delta, a push after it has to come out right
+		mutate_state(state, changed_bytes);
+		hashes.push_back(fnv1a64_words(state.data(), size));
+		store.push(100000, state.data());
+		check(store.restore(store.size() - 1, restored.data()) && fnv1a64_words(restored.data(), size) == hashes.back(),
+			"push after removing the newest checkpoint");
+
+		check(!store.restore(store.size(), restored.data()), "restore past the end accepted");
+		store.clear();
+		check(store.size() == 0 && store.get_encoded_bytes() == 0, "clear");
+	}
+
+	printf("%s (%d failures)\n", failures == 0 ? "ok" : "FAILED", failures);
+	return failures == 0 ? 0 : 1;
+}